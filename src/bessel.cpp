@@ -0,0 +1,53 @@
+/*
+ * LCPT NLO DIS fitter
+ * Modified Bessel functions K_0, K_1 and K_n for the photon wavefunctions
+ */
+
+#include "bessel.hpp"
+
+void FastBesselK0(const double* x, double* out, int n)
+{
+    #pragma omp simd
+    for (int i=0; i<n; i++)
+        out[i] = FastBesselK0(x[i]);
+}
+
+void FastBesselK1(const double* x, double* out, int n)
+{
+    #pragma omp simd
+    for (int i=0; i<n; i++)
+        out[i] = FastBesselK1(x[i]);
+}
+
+void FastBesselKn(int order, const double* x, double* out, int n)
+{
+    #pragma omp simd
+    for (int i=0; i<n; i++)
+        out[i] = FastBesselKn(order, x[i]);
+}
+
+void BesselK0(const double* x, double* out, int n)
+{
+#ifndef FAST_BESSEL
+    if (nlodis_config::BESSEL_IMPL != nlodis_config::BESSEL_FAST)
+    {
+        for (int i=0; i<n; i++)
+            out[i] = gsl_sf_bessel_K0(x[i]);
+        return;
+    }
+#endif
+    FastBesselK0(x, out, n);
+}
+
+void BesselK1(const double* x, double* out, int n)
+{
+#ifndef FAST_BESSEL
+    if (nlodis_config::BESSEL_IMPL != nlodis_config::BESSEL_FAST)
+    {
+        for (int i=0; i<n; i++)
+            out[i] = gsl_sf_bessel_K1(x[i]);
+        return;
+    }
+#endif
+    FastBesselK1(x, out, n);
+}
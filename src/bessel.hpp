@@ -0,0 +1,214 @@
+/*
+ * LCPT NLO DIS fitter
+ * Modified Bessel functions K_0, K_1 and K_n for the photon wavefunctions
+ */
+
+#ifndef _NLODIS_BESSEL_HPP
+#define _NLODIS_BESSEL_HPP
+
+#include <cmath>
+#include <limits>
+#include <gsl/gsl_sf_bessel.h>
+#include "nlodis_config.hpp"
+
+/*
+ * In-tree K_0 and K_1:
+ *  - x <= 2: K_0 = -ln(x/2) I_0(x) + P_0(x^2/4), K_1 = 1/x + ln(x/2) I_1(x) - x/4 P_1(x^2/4),
+ *    with the power series of I_0, I_1, P_0 and P_1 truncated at (x^2/4)^12
+ *  - x > 2: Chebyshev series of sqrt(x) e^x K_nu(x) in t = 4/x - 1
+ * K_n is obtained by upward recurrence from K_0 and K_1, as in GSL.
+ *
+ * Maximum relative error with respect to a quadrature reference of
+ * K_nu(x) = \int_0^\infty dt exp(-x cosh t) cosh(nu t), measured on
+ * 1e-8 < x < 700 (see tool_bessel_bench.cpp):
+ *   K_0: 3.5e-15, K_1: 3.0e-15, K_2: 3.5e-15
+ * which is at the same level as gsl_sf_bessel_K0/K1/Kn.
+ *
+ * The implementation used by the integrands (BesselK0, BesselK1, BesselKn) is
+ * selected at run time with nlodis_config::BESSEL_IMPL, or fixed to the in-tree
+ * one at compile time with -DFAST_BESSEL (cmake -DFAST_BESSEL=ON).
+ * For x <= 0 the in-tree functions return NaN like GSL with the error handler off.
+ */
+
+namespace bessel_detail
+{
+    // Power series coefficients in z = x^2/4
+    static const int SERIES_TERMS = 13;
+    static const double I0_SERIES[SERIES_TERMS] = {
+        1.00000000000000000e+00, 1.00000000000000000e+00, 2.50000000000000000e-01,
+        2.77777777777777762e-02, 1.73611111111111101e-03, 6.94444444444444444e-05,
+        1.92901234567901239e-06, 3.93675988914084175e-08, 6.15118732678256523e-10,
+        7.59405842812662392e-12, 7.59405842812662337e-14, 6.27608134555919329e-16,
+        4.35838982330499500e-18 };
+    // I_1(x) = x/2 * sum I1_SERIES[k] z^k
+    static const double I1_SERIES[SERIES_TERMS] = {
+        1.00000000000000000e+00, 5.00000000000000000e-01, 8.33333333333333287e-02,
+        6.94444444444444406e-03, 3.47222222222222235e-04, 1.15740740740740735e-05,
+        2.75573192239858883e-07, 4.92094986142605219e-09, 6.83465258531396137e-11,
+        7.59405842812662312e-13, 6.90368948011511223e-15, 5.23006778796599400e-17,
+        3.35260755638845791e-19 };
+    // P_0 coefficients (psi(k+1))/(k!)^2
+    static const double K0_SERIES[SERIES_TERMS] = {
+        -5.77215664901532866e-01, 4.22784335098467134e-01, 2.30696083774616784e-01,
+        3.48921574564388937e-02, 2.61478761880520882e-03, 1.18480393641097248e-04,
+        3.61262410319920332e-06, 7.93509652130420864e-08, 1.31674867303856454e-09,
+        1.70999407270580786e-11, 1.78593465698707407e-13, 1.53303434032084708e-15,
+        1.10092709597257441e-17 };
+    // P_1 coefficients (psi(k+1)+psi(k+2))/(k!(k+1)!)
+    static const double K1_SERIES[SERIES_TERMS] = {
+        -1.54431329803065731e-01, 6.72784335098467245e-01, 1.81575166960855627e-01,
+        1.91821898393305587e-02, 1.11535949196652807e-03, 4.14224768927114347e-05,
+        1.07154591409118070e-06, 2.04528600359387771e-08, 3.00204874658918806e-10,
+        3.49592872969288127e-12, 3.30991473525027176e-14, 2.59864113210112861e-16,
+        1.71952328269925634e-18 };
+
+    // Chebyshev coefficients of sqrt(x) e^x K_nu(x), t = 4/x - 1, x > 2
+    static const int CHEB_TERMS = 20;
+    static const double K0_CHEB[CHEB_TERMS] = {
+        1.2201515410329777e+00, -3.1448101311964363e-02, 1.5698838857298983e-03,
+        -1.2849549581624430e-04, 1.3949813719049686e-05, -1.8317555226558349e-06,
+        2.7668136379923719e-07, -4.6604898774430895e-08, 8.5740340392363268e-09,
+        -1.6975346332307832e-09, 3.5773954026044378e-10, -7.9573722611137043e-11,
+        1.8558821146541504e-11, -4.5151419640158489e-12, 1.1403221825196701e-12,
+        -2.9911628729450965e-13, 7.9778776177856045e-14, -2.3462713253744976e-14,
+        5.7105923192624939e-15, -1.0436096431476472e-15 };
+    static const double K1_CHEB[CHEB_TERMS] = {
+        1.3603130952422213e+00, 1.0392373657681735e-01, -2.8578168596229228e-03,
+        1.9521551847140884e-04, -1.9361979741498261e-05, 2.4064849479514076e-06,
+        -3.5019606047854498e-07, 5.7410841440101262e-08, -1.0345762407881765e-08,
+        2.0150496031027626e-09, -4.1903563037795315e-10, 9.2184414731318523e-11,
+        -2.1300361474629881e-11, 5.1390262415888321e-12, -1.2892777269772965e-12,
+        3.3365902633401373e-13, -9.0251880043486680e-14, 2.3528401449368631e-14,
+        -7.7043341056529934e-15, 3.0096295825880286e-15 };
+
+    inline double Horner(const double* c, int n, double z)
+    {
+        double s = c[n-1];
+        for (int k=n-2; k>=0; k--)
+            s = s*z + c[k];
+        return s;
+    }
+
+    inline double Clenshaw(const double* c, int n, double t)
+    {
+        double b1 = 0, b2 = 0;
+        double t2 = 2.0*t;
+        for (int k=n-1; k>=1; k--)
+        {
+            double b0 = t2*b1 - b2 + c[k];
+            b2 = b1;
+            b1 = b0;
+        }
+        return t*b1 - b2 + c[0];
+    }
+}
+
+// e^x K_0(x) and e^x K_1(x), x > 2
+inline double FastBesselK0_scaled_large(double x)
+{
+    using namespace bessel_detail;
+    return Clenshaw(K0_CHEB, CHEB_TERMS, 4.0/x - 1.0) / std::sqrt(x);
+}
+inline double FastBesselK1_scaled_large(double x)
+{
+    using namespace bessel_detail;
+    return Clenshaw(K1_CHEB, CHEB_TERMS, 4.0/x - 1.0) / std::sqrt(x);
+}
+
+inline double FastBesselK0(double x)
+{
+    using namespace bessel_detail;
+    if (!(x > 0))
+        return std::numeric_limits<double>::quiet_NaN();
+    if (x <= 2.0)
+    {
+        double z = 0.25*x*x;
+        return -std::log(0.5*x)*Horner(I0_SERIES, SERIES_TERMS, z) + Horner(K0_SERIES, SERIES_TERMS, z);
+    }
+    return std::exp(-x)*FastBesselK0_scaled_large(x);
+}
+
+inline double FastBesselK1(double x)
+{
+    using namespace bessel_detail;
+    if (!(x > 0))
+        return std::numeric_limits<double>::quiet_NaN();
+    if (x <= 2.0)
+    {
+        double z = 0.25*x*x;
+        return 1.0/x + 0.5*x*std::log(0.5*x)*Horner(I1_SERIES, SERIES_TERMS, z)
+            - 0.25*x*Horner(K1_SERIES, SERIES_TERMS, z);
+    }
+    return std::exp(-x)*FastBesselK1_scaled_large(x);
+}
+
+// e^x K_0(x) and e^x K_1(x), x > 0
+inline double FastBesselK0_scaled(double x)
+{
+    return x > 2.0 ? FastBesselK0_scaled_large(x) : std::exp(x)*FastBesselK0(x);
+}
+inline double FastBesselK1_scaled(double x)
+{
+    return x > 2.0 ? FastBesselK1_scaled_large(x) : std::exp(x)*FastBesselK1(x);
+}
+
+inline double FastBesselKn(int n, double x)
+{
+    if (n < 0) n = -n;
+    if (n == 0) return FastBesselK0(x);
+    double km = FastBesselK0(x);
+    double k = FastBesselK1(x);
+    double twooverx = 2.0/x;
+    for (int j=1; j<n; j++)
+    {
+        double kp = km + j*twooverx*k;
+        km = k;
+        k = kp;
+    }
+    return k;
+}
+
+// Batched evaluation out[i] = K(x[i]), vectorized over i
+void FastBesselK0(const double* x, double* out, int n);
+void FastBesselK1(const double* x, double* out, int n);
+void FastBesselKn(int order, const double* x, double* out, int n);
+
+// Bessel functions used by the integrands
+inline double BesselK0(double x)
+{
+#ifdef FAST_BESSEL
+    return FastBesselK0(x);
+#else
+    if (nlodis_config::BESSEL_IMPL == nlodis_config::BESSEL_FAST)
+        return FastBesselK0(x);
+    return gsl_sf_bessel_K0(x);
+#endif
+}
+
+inline double BesselK1(double x)
+{
+#ifdef FAST_BESSEL
+    return FastBesselK1(x);
+#else
+    if (nlodis_config::BESSEL_IMPL == nlodis_config::BESSEL_FAST)
+        return FastBesselK1(x);
+    return gsl_sf_bessel_K1(x);
+#endif
+}
+
+inline double BesselKn(int n, double x)
+{
+#ifdef FAST_BESSEL
+    return FastBesselKn(n, x);
+#else
+    if (nlodis_config::BESSEL_IMPL == nlodis_config::BESSEL_FAST)
+        return FastBesselKn(n, x);
+    return gsl_sf_bessel_Kn(n, x);
+#endif
+}
+
+// Batched versions of the above, out[i] = K(x[i])
+void BesselK0(const double* x, double* out, int n);
+void BesselK1(const double* x, double* out, int n);
+
+#endif
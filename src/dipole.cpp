@@ -12,6 +12,7 @@
 #include <fstream>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
 #include <tools/tools.hpp>
 
 using std::cerr; using std::cout; using std::endl;
@@ -334,3 +335,64 @@ Dipole::Dipole(std::string filename)
     X0=data.X0();
     cout << "# Data read from file " << filename << " x0=" << data.X0() << "  maxy " << yvals[yvals.size()-1] << " rpoints/rapidity " << amplitude[0].size() << endl;
 }
+
+
+DipoleAmplitudeView::DipoleAmplitudeView(Dipole& dipole)
+    : amplitude(dipole.GetData()), yvals(dipole.GetYvals()), rvals(dipole.GetRvals())
+{
+    x0 = dipole.GetX0();
+    lnminr = std::log(rvals[0]);
+    inv_lnrstep = 1.0/std::log(rvals[1]/rvals[0]);
+}
+
+double DipoleAmplitudeView::N(double r, double xbj)
+{
+    return N_y(r, std::log(x0/xbj));
+}
+
+double DipoleAmplitudeView::N_y(double r, double y)
+{
+    if (r >= rvals[rvals.size()-1])
+        return 1.0;
+    if (r < rvals[0])
+        r = rvals[0];
+    
+    int rind = static_cast<int>( (std::log(r) - lnminr)*inv_lnrstep );
+    if (rind < 0) rind = 0;
+    if (rind > static_cast<int>(rvals.size())-2) rind = rvals.size()-2;
+    // Rounding in the logarithm can move the index by one
+    if (r < rvals[rind] and rind > 0) rind--;
+    else if (r >= rvals[rind+1] and rind < static_cast<int>(rvals.size())-2) rind++;
+    double rfrac = (r - rvals[rind]) / (rvals[rind+1] - rvals[rind]);
+    
+    unsigned int yind;
+    double yfrac;
+    if (y <= yvals[0] or yvals.size() == 1)
+    {
+        yind = 0; yfrac = 0;
+    }
+    else if (y >= yvals[yvals.size()-1])
+    {
+        yind = yvals.size()-2; yfrac = 1.0;
+    }
+    else
+    {
+        // Largest index s.t. yvals[yind] <= y
+        yind = std::upper_bound(yvals.begin(), yvals.end(), y) - yvals.begin() - 1;
+        if (yind > yvals.size()-2) yind = yvals.size()-2;
+        yfrac = (y - yvals[yind]) / (yvals[yind+1] - yvals[yind]);
+    }
+    
+    const std::vector<double>& lower = amplitude[yind];
+    double n = lower[rind] + rfrac*(lower[rind+1] - lower[rind]);
+    if (yfrac > 0)
+    {
+        const std::vector<double>& upper = amplitude[yind+1];
+        double n_upper = upper[rind] + rfrac*(upper[rind+1] - upper[rind]);
+        n += yfrac*(n_upper - n);
+    }
+    
+    if (n > 1.0) return 1.0;
+    if (n < 0 and config::FORCE_POSITIVE_N) return 0;
+    return n;
+}
@@ -66,5 +66,38 @@ class Dipole
         unsigned int interpolator_yind;     // Rapidity index at which the interpolator is initialized
 };
 
+/*
+ * Read-only view of a solved Dipole with the same interface as AmplitudeLib,
+ * such that the solution can be used in the cross section computation
+ * without copying the amplitude table. The viewed Dipole must outlive
+ * the view and must not be evolved further while the view is used.
+ *
+ * Interpolation is linear in r and in y = ln(x0/x) (cf. AmplitudeLib
+ * LINEAR_LINEAR), outside the rapidity range the amplitude is frozen.
+ */
+class DipoleAmplitudeView
+{
+    public:
+        DipoleAmplitudeView(Dipole& dipole);
+
+        double N(double r, double xbj);
+        double S(double r, double xbj) { return 1.0 - N(r, xbj); }
+        double N_y(double r, double y);     // Amplitude at rapidity y
+
+        void SetX0(double x0_) { x0 = x0_; }
+        double X0() { return x0; }
+        double MinR() { return rvals[0]; }
+        double MaxR() { return rvals[rvals.size()-1]; }
+        double MaxY() { return yvals[yvals.size()-1]; }
+
+    private:
+        const std::vector< std::vector<double> >& amplitude;
+        const std::vector<double>& yvals;
+        const std::vector<double>& rvals;
+        double x0;
+        double lnminr;
+        double inv_lnrstep;     // 1/ln(r_{i+1}/r_i), the r grid is logarithmic
+};
+
 const std::string VERSION = "0.0-dev";
 #endif
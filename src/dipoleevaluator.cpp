@@ -0,0 +1,20 @@
+/*
+ * LCPT NLO DIS fitter
+ * Tabulated dipole S-matrix for the cross section integrands
+ */
+
+#include "dipoleevaluator.hpp"
+
+DipoleEvaluator::DipoleEvaluator()
+{
+    rpoints=0; ypoints=0;
+    lnr0=0; inv_dlnr=0; inv_dy=0; ymaxindex=0;
+    lnminr=0; lnmaxr=0; lnx0=0;
+}
+
+void DipoleEvaluator::S(const double* r, const double* x, double* out, int n) const
+{
+    #pragma omp simd
+    for (int i=0; i<n; i++)
+        out[i] = S_lny(std::log(r[i]), lnx0 - std::log(x[i]));
+}
@@ -0,0 +1,102 @@
+/*
+ * LCPT NLO DIS fitter
+ * Tabulated dipole S-matrix for the cross section integrands
+ */
+
+#ifndef _DIPOLE_EVALUATOR_HPP
+#define _DIPOLE_EVALUATOR_HPP
+
+#include <vector>
+#include <cmath>
+#include "nlodis_config.hpp"
+
+/*
+ * S(r,x) tabulated on a uniform grid in (ln r, y), y = ln(x0_bk/x),
+ * evaluated with bilinear interpolation. The boundary logic of
+ * ComputeSigmaR::Sr is folded in:
+ *  - S=1 at r<nlodis_config::MINR and S=0 at r>nlodis_config::MAXR
+ *  - x > x0_bk is evaluated at the initial condition
+ *  - the initial condition shift icY0 is included in the table
+ */
+class DipoleEvaluator
+{
+    public:
+        DipoleEvaluator();
+
+        // Tabulate amp.S(r, x) of any amplitude with the AmplitudeLib interface
+        // (AmplitudeLib, DipoleAmplitudeView) that is solved up to rapidity maxy
+        template<class Amplitude>
+        void Build(Amplitude& amp, double x0_bk, double y0, double maxy);
+
+        inline double S(double r, double x) const
+        {
+            return S_lny(std::log(r), lnx0 - std::log(x));
+        }
+        // S at the evolution rapidity Y = ln(1/x), cf. ComputeSigmaR::SrY
+        inline double SY(double r, double Y) const
+        {
+            return S_lny(std::log(r), lnx0 + Y);
+        }
+
+        // Batched evaluation out[i] = S(r[i], x[i])
+        void S(const double* r, const double* x, double* out, int n) const;
+
+        bool Initialized() const { return !table.empty(); }
+
+    private:
+        inline double S_lny(double lnr, double y) const
+        {
+            if (lnr < lnminr) return 1.0;
+            if (lnr > lnmaxr) return 0;
+            if (y < 0) y = 0;
+            double fr = (lnr - lnr0)*inv_dlnr;
+            double fy = y*inv_dy;
+            if (fy > ymaxindex) fy = ymaxindex;
+            int ir = static_cast<int>(fr);
+            int iy = static_cast<int>(fy);
+            if (ir > rpoints-2) ir = rpoints-2;
+            if (iy > ypoints-2) iy = ypoints-2;
+            double tr = fr - ir;
+            double ty = fy - iy;
+            const double* low = &table[iy*rpoints + ir];
+            const double* up = low + rpoints;
+            return (1.0-ty)*((1.0-tr)*low[0] + tr*low[1]) + ty*((1.0-tr)*up[0] + tr*up[1]);
+        }
+
+        std::vector<double> table;      // table[iy*rpoints + ir]
+        int rpoints, ypoints;
+        double lnr0, inv_dlnr;          // Table grid in ln r
+        double inv_dy;                  // Table grid in y, starts at y=0
+        double ymaxindex;
+        double lnminr, lnmaxr;          // ln of nlodis_config::MINR and MAXR
+        double lnx0;
+};
+
+template<class Amplitude>
+void DipoleEvaluator::Build(Amplitude& amp, double x0_bk, double y0, double maxy)
+{
+    lnminr = std::log(nlodis_config::MINR);
+    lnmaxr = std::log(nlodis_config::MAXR-1e-7);
+    lnx0 = std::log(x0_bk);
+
+    rpoints = nlodis_config::DIPOLE_EVALUATOR_RPOINTS;
+    lnr0 = lnminr;
+    inv_dlnr = (rpoints-1)/(lnmaxr - lnminr);
+
+    // Evolution beyond the initial condition available for the cross section, y = Y - icY0
+    double ymax = maxy - y0;
+    if (ymax <= 0) ymax = nlodis_config::DIPOLE_EVALUATOR_YSTEP;
+    ypoints = static_cast<int>(std::ceil(ymax/nlodis_config::DIPOLE_EVALUATOR_YSTEP)) + 1;
+    inv_dy = (ypoints-1)/ymax;
+    ymaxindex = ypoints-1;
+
+    table.resize(rpoints*ypoints);
+    for (int iy=0; iy<ypoints; iy++)
+    {
+        double x = x0_bk*std::exp(-iy/inv_dy)*std::exp(-y0);
+        for (int ir=0; ir<rpoints; ir++)
+            table[iy*rpoints + ir] = amp.S(std::exp(lnr0 + ir/inv_dlnr), x);
+    }
+}
+
+#endif
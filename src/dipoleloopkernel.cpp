@@ -0,0 +1,206 @@
+/*
+ * LCPT NLO DIS fitter
+ * Tabulated wavefunction kernels of the NLO dipole-loop terms
+ */
+
+#include <cmath>
+#include <map>
+#include <deque>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include "dipoleloopkernel.hpp"
+#include "nlodis_config.hpp"
+#include "nlodissigmar_massiveq.hpp"
+#include "massivetables.hpp"
+#include "quadrature.hpp"
+#include "bessel.hpp"
+
+using std::cout; using std::endl;
+
+namespace
+{
+    inline double Sq(double x) { return x*x; }
+
+    // Gauss-Legendre rule in ln r
+    const int R_ORDER = 8;
+    const double R_PANELWIDTH = 2.0;
+    // Inner rules: ln z between ZMIN/(1 + (Q r)^2) and 1/2, and logit of xi, x, y_chi, y_u
+    const int INNER_ORDER = 6;
+    const double Z_PANELWIDTH = 2.0;
+    const double LOGIT_PANELWIDTH = 3.0;
+    const double LOGIT_MAX = 20;
+    const double ZMIN = 1e-10;
+
+    std::map< std::pair<double, double>, DipoleLoopKernel > kernels;
+    std::deque< std::pair<double, double> > kernel_order;     // Keys of kernels, oldest first
+
+    struct Rule
+    {
+        std::vector<double> x, w;   // \int_0^1 dv f(v) = sum_i w[i] f(x[i])
+    };
+
+    Rule LogitRule()
+    {
+        std::vector<double> t, w;
+        GaussLegendreNodes(INNER_ORDER, -LOGIT_MAX, LOGIT_MAX, t, w,
+            static_cast<int>(std::ceil(2.0*LOGIT_MAX/LOGIT_PANELWIDTH)));
+        Rule rule;
+        for (size_t i=0; i<t.size(); i++)
+        {
+            const double v = 1.0/(1.0 + std::exp(-t[i]));
+            rule.x.push_back(v);
+            rule.w.push_back(w[i]*v*(1.0-v));
+        }
+        return rule;
+    }
+
+    // z < 1/2, with the weights doubled for the integrands symmetric in z -> 1-z:
+    // - massless L and T: functions of z(1-z) and ln^2(z/(1-z)) only
+    // - LiLogConst: L_dip has the terms of z and 1-z, and the first two terms of OmegaL_V
+    //   map into each other, the third depends on z(1-z)
+    // - Iab, Icd: the terms of z and of 1-z (the two kappa_z shifts, CLm1 and CLm2) swap
+    // - T I1, I2, I3: the Omega_V and I_V, I_VMS terms are sums of an unsymmetric function
+    //   of z and 1-z, Omega_N and I_N are differences multiplied by the odd (2z-1)
+    Rule ZRule(double qr)
+    {
+        const double tmin = std::log(ZMIN/(1.0 + Sq(qr)));
+        const double tmax = std::log(0.5);
+        std::vector<double> t, w;
+        GaussLegendreNodes(INNER_ORDER, tmin, tmax, t, w, std::max(1, static_cast<int>(std::ceil((tmax-tmin)/Z_PANELWIDTH))));
+        Rule rule;
+        for (size_t i=0; i<t.size(); i++)
+        {
+            const double z = std::exp(t[i]);
+            rule.x.push_back(z);
+            rule.w.push_back(2.0*w[i]*z);
+        }
+        return rule;
+    }
+
+    // As in the integrands, non-finite values at the endpoints are dropped
+    inline void Add(double& sum, double w, double f)
+    {
+        if (std::isfinite(f))
+            sum += w*f;
+    }
+
+    // Massless kernels, cf. integrand_ILdip and integrand_ITdip
+    void MasslessKernels(double Q, double r, double K[DIPLOOP_TERMS])
+    {
+        const double regconst = 5.0/2.0 - Sq(M_PI)/6.0;
+        const Rule z = ZRule(Q*r);
+        double L = 0, T = 0;
+        for (size_t i=0; i<z.x.size(); i++)
+        {
+            const double z1 = z.x[i];
+            const double arg = Q*std::sqrt(z1*(1.0-z1))*r;
+            const double loop = 0.5*Sq(std::log(z1/(1.0-z1))) + regconst;
+            Add(L, z.w[i], 4.0*Sq(z1)*Sq(1.0-z1)*Sq(Q*BesselK0(arg))*loop);
+            Add(T, z.w[i], z1*(1.0-z1)*(Sq(z1)+Sq(1.0-z1))*Sq(Q*BesselK1(arg))*loop);
+        }
+        K[DIPLOOP_L] = L;
+        K[DIPLOOP_T] = T;
+    }
+
+    // Massive kernels, cf. integrand_ILdip_massive_* and integrand_ITdip_massive_I*
+    void MassiveKernels(double Q, double mf, double r, const Rule& v, double K[DIPLOOP_TERMS])
+    {
+        const double rsq = Sq(r);
+        const Rule z = ZRule(Q*r);
+        double lilogconst = 0, iab = 0, icd = 0, i1 = 0, i2 = 0, i3 = 0;
+        for (size_t i=0; i<z.x.size(); i++)
+        {
+            const double z1 = z.x[i];
+            Add(lilogconst, z.w[i], ILdip_massive_LiLogConst(Q, z1, rsq, mf));
+            Add(i1, z.w[i], ITdip_massive_0(Q, z1, rsq, mf));
+            for (size_t j=0; j<v.x.size(); j++)
+            {
+                const double wj = z.w[i]*v.w[j];
+                Add(iab, wj, ILdip_massive_Iab(Q, z1, rsq, mf, v.x[j]));
+                Add(i2, wj, ITdip_massive_1(Q, z1, rsq, mf, v.x[j]));
+                for (size_t k=0; k<v.x.size(); k++)
+                {
+                    Add(icd, wj*v.w[k], ILdip_massive_Icd(Q, z1, rsq, mf, v.x[j], v.x[k]));
+                    Add(i3, wj*v.w[k], ITdip_massive_2(Q, z1, rsq, mf, v.x[j], v.x[k]));
+                }
+            }
+        }
+        K[DIPLOOP_L_LILOGCONST] = lilogconst;
+        K[DIPLOOP_L_IAB] = iab;
+        K[DIPLOOP_L_ICD] = icd;
+        K[DIPLOOP_T_I1] = i1;
+        K[DIPLOOP_T_I2] = i2;
+        K[DIPLOOP_T_I3] = i3;
+    }
+
+    DipoleLoopKernel ComputeKernels(double Q, double mf)
+    {
+        if (mf > 0)
+            InitMassiveTables();
+
+        DipoleLoopKernel res;
+        const double lnminr = std::log(nlodis_config::MINR);
+        const double lnmaxr = std::log(nlodis_config::MAXR-1e-7);
+        GaussLegendreNodes(R_ORDER, lnminr, lnmaxr, res.r, res.weights,
+            std::max(1, static_cast<int>(std::ceil((lnmaxr-lnminr)/R_PANELWIDTH))));
+        const int n = res.r.size();
+        for (int i=0; i<n; i++)
+            res.r[i] = std::exp(res.r[i]);
+
+        const Rule v = LogitRule();
+        std::vector<double> K(DIPLOOP_TERMS*n, 0);
+        #pragma omp parallel for schedule(dynamic)
+        for (int i=0; i<n; i++)
+        {
+            if (mf > 0)
+                MassiveKernels(Q, mf, res.r[i], v, &K[DIPLOOP_TERMS*i]);
+            else
+                MasslessKernels(Q, res.r[i], &K[DIPLOOP_TERMS*i]);
+        }
+
+        for (int t=0; t<DIPLOOP_TERMS; t++)
+        {
+            if ((mf > 0) != (t >= DIPLOOP_L_LILOGCONST))
+                continue;
+            res.kernel[t].resize(n);
+            for (int i=0; i<n; i++)
+                res.kernel[t][i] = K[DIPLOOP_TERMS*i + t];
+        }
+        if (nlodis_config::VERBOSE)
+            cout << "# Computed dipole-loop kernels at Q=" << Q << " GeV, mf=" << mf << " GeV" << endl;
+        return res;
+    }
+}
+
+DipoleLoopKernel DipoleLoopKernels(double Q, double mf)
+{
+    const std::pair<double, double> key(Q, mf);
+    DipoleLoopKernel kernel;
+    bool found;
+    #pragma omp critical(dipole_loop_kernels)
+    {
+        std::map< std::pair<double, double>, DipoleLoopKernel >::const_iterator it = kernels.find(key);
+        found = it != kernels.end();
+        if (found)
+            kernel = it->second;
+    }
+    if (found)
+        return kernel;
+
+    // Computed outside the critical section, so that the kernels of different (Q, mf)
+    // can be computed in parallel. If another thread was faster, its kernels are kept.
+    kernel = ComputeKernels(Q, mf);
+    #pragma omp critical(dipole_loop_kernels)
+    {
+        if (kernels.insert(std::make_pair(key, kernel)).second)
+            kernel_order.push_back(key);
+        while ((int)kernels.size() > std::max(nlodis_config::DIPOLE_LOOP_KERNEL_CACHE, 1))
+        {
+            kernels.erase(kernel_order.front());
+            kernel_order.pop_front();
+        }
+    }
+    return kernel;
+}
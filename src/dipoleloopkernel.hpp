@@ -0,0 +1,61 @@
+/*
+ * LCPT NLO DIS fitter
+ * Tabulated wavefunction kernels of the NLO dipole-loop terms
+ */
+
+#ifndef _DIPOLE_LOOP_KERNEL_HPP
+#define _DIPOLE_LOOP_KERNEL_HPP
+
+#include <vector>
+
+/*
+ * The dipole-loop terms depend on the target only through N(r, X_DIP(r)) at the
+ * parent dipole size r = x01. Their z1 integrals, and the xi, x, y_chi, y_u
+ * integrals of the massive terms, are therefore done once per (Q, mf):
+ *   F_dip ~ \int dr r N(r, X_DIP(r)) alphabar(r) CF/Nc K(Q, mf; r),
+ * see ComputeSigmaR::NLOdip_kernel. The kernels K are the integrands of
+ * integrand_ILdip, integrand_ITdip and of the massive integrand_ILdip_massive_*
+ * and integrand_ITdip_massive_I* without the dipole, the coupling and the jacobian r.
+ *
+ * The kernels are evaluated at the nodes of a Gauss-Legendre rule in ln r between
+ * MINR and MAXR. The inner integrals use nested composite Gauss-Legendre rules in
+ * ln z for z < 1/2 (the integrands are symmetric in z -> 1-z, see ZRule) and in logit
+ * of the other variables. With twice as many nodes in every variable the dipole-loop
+ * structure functions change by less than 1e-5.
+ *
+ * The kernels of a (Q, mf) are computed at the first call and kept, so that they are
+ * reused at every step of a fit. At most nlodis_config::DIPOLE_LOOP_KERNEL_CACHE of them
+ * are kept, the oldest are dropped first. The massive ones take 1-2 minutes per (Q, mf)
+ * on one core and are parallelized over the r nodes, the massless ones a few
+ * milliseconds. The massive kernels are therefore only used with
+ * nlodis_config::DIPOLE_LOOP_KERNELS_MASSIVE, e.g. for fits at fixed quark masses.
+ * The z2 dependent terms (integrand_ILdip_z2, integrand_ITdip_z2) evaluate the
+ * dipole at a z2 dependent rapidity and are not tabulated.
+ */
+
+enum DipoleLoopTerm
+{
+    DIPLOOP_L,              // integrand_ILdip
+    DIPLOOP_T,              // integrand_ITdip
+    DIPLOOP_L_LILOGCONST,   // integrand_ILdip_massive_LiLogConst
+    DIPLOOP_L_IAB,          // integrand_ILdip_massive_Iab
+    DIPLOOP_L_ICD,          // integrand_ILdip_massive_Icd
+    DIPLOOP_T_I1,           // integrand_ITdip_massive_I1
+    DIPLOOP_T_I2,           // integrand_ITdip_massive_I2
+    DIPLOOP_T_I3,           // integrand_ITdip_massive_I3
+    DIPLOOP_TERMS
+};
+
+struct DipoleLoopKernel
+{
+    // \int d ln r f(r) = sum_i weights[i] f(r[i])
+    std::vector<double> r, weights;
+    // Kernels at the nodes, the massless (mf = 0) or the massive terms
+    std::vector<double> kernel[DIPLOOP_TERMS];
+};
+
+// Kernels of the quark mass mf (0: massless terms) at photon virtuality Q. A copy is
+// returned, since the cached kernels may be dropped by other threads.
+DipoleLoopKernel DipoleLoopKernels(double Q, double mf);
+
+#endif
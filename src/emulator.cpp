@@ -0,0 +1,430 @@
+/*
+ * Reduced order emulator of BK solutions over the initial condition parameters
+ */
+
+#include "emulator.hpp"
+#include "solver.hpp"
+#include "mv.hpp"
+#include "nlobk_config.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <gsl/gsl_matrix.h>
+#include <gsl/gsl_vector.h>
+#include <gsl/gsl_eigen.h>
+#include <gsl/gsl_linalg.h>
+#include <gsl/gsl_permutation.h>
+
+using namespace std;
+
+const unsigned int EMULATOR_PARAMETERS = 4;     // Q_s0^2, gamma, e_c, C^2
+const unsigned int EMULATOR_POLYTERMS = EMULATOR_PARAMETERS+1;
+const double EMULATOR_EXTRAPOLATION_MARGIN = 0.05;  // Allowed distance outside the training region in normalized units
+
+// Settings saved in the training set header agree to the written precision
+static bool SameSetting(double saved, double current)
+{
+    return std::abs(saved - current) <= 1e-8*std::max(std::abs(saved), std::abs(current));
+}
+
+BKEmulator::BKEmulator(double maxy_, double icx0_bk_, double icx0_nlo_impfac_, double icQ0sqr_)
+{
+    maxy = maxy_;
+    icx0_bk = icx0_bk_;
+    icx0_nlo_impfac = icx0_nlo_impfac_;
+    icQ0sqr = icQ0sqr_;
+    tolerance = 1e-3;
+    energy_fraction = 1.0 - 1e-8;
+    truncation_error = 0;
+}
+
+int BKEmulator::SolveBK(std::vector<double> par, Dipole& dipole)
+{
+    BKSolver solver(&dipole);
+    solver.SetAlphasScaling(par[3]);
+    solver.SetX0(icx0_bk);
+    solver.SetICX0_nlo_impfac(icx0_nlo_impfac);
+    solver.SetICTypicalPartonVirtualityQ0sqr(icQ0sqr);
+    return solver.Solve(maxy);
+}
+
+int BKEmulator::AddTrainingPoint(std::vector<double> par)
+{
+    if (par.size() != EMULATOR_PARAMETERS)
+    {
+        cerr << "Emulator expects parameters (qs0sqr, gamma, e_c, C^2), got " << par.size() << " values " << LINEINFO << endl;
+        return -1;
+    }
+    MV ic;
+    ic.SetQsqr(par[0]);
+    ic.SetAnomalousDimension(par[1]);
+    ic.SetE(par[2]);
+    Dipole dipole(&ic);
+    dipole.SetX0(icx0_bk);
+    SolveBK(par, dipole);
+
+    std::vector<double> snapshot;
+    for (unsigned int yind=1; yind<dipole.YPoints(); yind++)
+        snapshot.insert(snapshot.end(), dipole.GetData()[yind].begin(), dipole.GetData()[yind].end());
+
+    if (yvals.empty())
+        yvals.assign(dipole.GetYvals().begin()+1, dipole.GetYvals().end());
+    else if (dipole.YPoints()-1 != yvals.size())
+    {
+        cerr << "Training solution has " << dipole.YPoints()-1 << " rapidities, expected " << yvals.size() << " " << LINEINFO << endl;
+        return -1;
+    }
+
+    training_par.push_back(par);
+    snapshots.push_back(snapshot);
+    return training_par.size()-1;
+}
+
+/*
+ * Map parameters to the unit hypercube spanned by the training set,
+ * Q_s0^2 and C^2 are logarithmic
+ */
+std::vector<double> BKEmulator::NormalizedParameters(std::vector<double> par)
+{
+    std::vector<double> p(EMULATOR_PARAMETERS);
+    p[0] = std::log(par[0]);
+    p[1] = par[1];
+    p[2] = par[2];
+    p[3] = std::log(par[3]);
+    if (par_min.size() == EMULATOR_PARAMETERS)
+    {
+        for (unsigned int i=0; i<EMULATOR_PARAMETERS; i++)
+        {
+            double range = par_max[i]-par_min[i];
+            if (range <= 0) range = 1.0;
+            p[i] = (p[i]-par_min[i])/range;
+        }
+    }
+    return p;
+}
+
+// Polyharmonic radial basis function, cubic or linear
+double RBFKernel(const std::vector<double>& a, const std::vector<double>& b, bool cubic)
+{
+    double d=0;
+    for (unsigned int i=0; i<a.size(); i++)
+        d += SQR(a[i]-b[i]);
+    d = std::sqrt(d);
+    if (cubic) return d*d*d;
+    return d;
+}
+
+int BKEmulator::Build()
+{
+    unsigned int n = training_par.size();
+    if (n < EMULATOR_POLYTERMS+1)
+    {
+        cerr << "Emulator needs at least " << EMULATOR_POLYTERMS+1 << " training points, have " << n << " " << LINEINFO << endl;
+        return -1;
+    }
+    unsigned int dim = snapshots[0].size();
+
+    // Parameter range
+    par_min.clear(); par_max.clear();
+    std::vector< std::vector<double> > p;
+    for (unsigned int i=0; i<n; i++)
+        p.push_back(NormalizedParameters(training_par[i]));
+    par_min = p[0]; par_max = p[0];
+    for (unsigned int i=1; i<n; i++)
+    {
+        for (unsigned int j=0; j<EMULATOR_PARAMETERS; j++)
+        {
+            par_min[j] = std::min(par_min[j], p[i][j]);
+            par_max[j] = std::max(par_max[j], p[i][j]);
+        }
+    }
+    for (unsigned int i=0; i<n; i++)
+        p[i] = NormalizedParameters(training_par[i]);
+
+    // POD using the method of snapshots: eigenvectors of the Gram matrix of the centered snapshots
+    mean.assign(dim, 0);
+    for (unsigned int i=0; i<n; i++)
+        for (unsigned int k=0; k<dim; k++)
+            mean[k] += snapshots[i][k]/n;
+
+    gsl_matrix* gram = gsl_matrix_alloc(n, n);
+    for (unsigned int i=0; i<n; i++)
+    {
+        for (unsigned int j=i; j<n; j++)
+        {
+            double dot=0;
+            for (unsigned int k=0; k<dim; k++)
+                dot += (snapshots[i][k]-mean[k])*(snapshots[j][k]-mean[k]);
+            gsl_matrix_set(gram, i, j, dot);
+            gsl_matrix_set(gram, j, i, dot);
+        }
+    }
+    gsl_vector* eval = gsl_vector_alloc(n);
+    gsl_matrix* evec = gsl_matrix_alloc(n, n);
+    gsl_eigen_symmv_workspace* ws = gsl_eigen_symmv_alloc(n);
+    gsl_eigen_symmv(gram, eval, evec, ws);
+    gsl_eigen_symmv_free(ws);
+    gsl_eigen_symmv_sort(eval, evec, GSL_EIGEN_SORT_VAL_DESC);
+
+    double total=0;
+    for (unsigned int i=0; i<n; i++)
+        total += std::max(0.0, gsl_vector_get(eval, i));
+
+    modes.clear();
+    std::vector< std::vector<double> > coefs(n);   // coefs[i][mode]
+    double kept=0;
+    for (unsigned int m=0; m<n; m++)
+    {
+        double lambda = gsl_vector_get(eval, m);
+        if (lambda <= 1e-14*gsl_vector_get(eval, 0) or (total > 0 and kept >= energy_fraction*total))
+            break;
+        kept += lambda;
+        std::vector<double> mode(dim, 0);
+        for (unsigned int i=0; i<n; i++)
+        {
+            double v = gsl_matrix_get(evec, i, m);
+            for (unsigned int k=0; k<dim; k++)
+                mode[k] += v*(snapshots[i][k]-mean[k]);
+            coefs[i].push_back(std::sqrt(lambda)*v);
+        }
+        for (unsigned int k=0; k<dim; k++)
+            mode[k] /= std::sqrt(lambda);
+        modes.push_back(mode);
+    }
+    truncation_error = std::sqrt( std::max(0.0, total-kept)/(n*dim) );
+    gsl_matrix_free(gram);
+    gsl_matrix_free(evec);
+    gsl_vector_free(eval);
+
+    // RBF interpolants with a linear polynomial tail for the POD coefficients
+    for (int kernel=0; kernel<2; kernel++)
+    {
+        bool cubic = (kernel == 0);
+        unsigned int size = n + EMULATOR_POLYTERMS;
+        gsl_matrix* A = gsl_matrix_calloc(size, size);
+        for (unsigned int i=0; i<n; i++)
+        {
+            for (unsigned int j=0; j<n; j++)
+                gsl_matrix_set(A, i, j, RBFKernel(p[i], p[j], cubic));
+            gsl_matrix_set(A, i, n, 1.0);
+            gsl_matrix_set(A, n, i, 1.0);
+            for (unsigned int j=0; j<EMULATOR_PARAMETERS; j++)
+            {
+                gsl_matrix_set(A, i, n+1+j, p[i][j]);
+                gsl_matrix_set(A, n+1+j, i, p[i][j]);
+            }
+        }
+        gsl_permutation* perm = gsl_permutation_alloc(size);
+        int signum;
+        gsl_linalg_LU_decomp(A, perm, &signum);
+
+        std::vector< std::vector<double> >& weights = cubic ? rbf_weights_cubic : rbf_weights_linear;
+        weights.clear();
+        gsl_vector* b = gsl_vector_calloc(size);
+        gsl_vector* x = gsl_vector_alloc(size);
+        for (unsigned int m=0; m<modes.size(); m++)
+        {
+            for (unsigned int i=0; i<n; i++)
+                gsl_vector_set(b, i, coefs[i][m]);
+            gsl_linalg_LU_solve(A, perm, b, x);
+            std::vector<double> w(size);
+            for (unsigned int i=0; i<size; i++)
+                w[i] = gsl_vector_get(x, i);
+            weights.push_back(w);
+        }
+        gsl_vector_free(b);
+        gsl_vector_free(x);
+        gsl_permutation_free(perm);
+        gsl_matrix_free(A);
+    }
+
+    cout << "# BK emulator: " << n << " training solutions, " << modes.size() << " POD modes, truncation error " << truncation_error << endl;
+    return 0;
+}
+
+std::vector<double> BKEmulator::InterpolateCoefficients(std::vector<double> par, bool cubic)
+{
+    std::vector<double> p = NormalizedParameters(par);
+    unsigned int n = training_par.size();
+    std::vector<double> kernel(n);
+    for (unsigned int i=0; i<n; i++)
+        kernel[i] = RBFKernel(p, NormalizedParameters(training_par[i]), cubic);
+
+    std::vector< std::vector<double> >& weights = cubic ? rbf_weights_cubic : rbf_weights_linear;
+    std::vector<double> coefs;
+    for (unsigned int m=0; m<modes.size(); m++)
+    {
+        double a = weights[m][n];
+        for (unsigned int j=0; j<EMULATOR_PARAMETERS; j++)
+            a += weights[m][n+1+j]*p[j];
+        for (unsigned int i=0; i<n; i++)
+            a += weights[m][i]*kernel[i];
+        coefs.push_back(a);
+    }
+    return coefs;
+}
+
+/*
+ * The difference between the cubic and linear RBF interpolants estimates
+ * the interpolation error, as the modes are orthonormal this is also the
+ * L2 difference of the reconstructed amplitudes
+ */
+double BKEmulator::ErrorIndicator(std::vector<double> par)
+{
+    if (modes.empty())
+        return 1.0;
+    std::vector<double> p = NormalizedParameters(par);
+    for (unsigned int j=0; j<EMULATOR_PARAMETERS; j++)
+    {
+        if (p[j] < -EMULATOR_EXTRAPOLATION_MARGIN or p[j] > 1.0+EMULATOR_EXTRAPOLATION_MARGIN)
+            return 1.0;
+    }
+    std::vector<double> cubic = InterpolateCoefficients(par, true);
+    std::vector<double> linear = InterpolateCoefficients(par, false);
+    double diff=0;
+    for (unsigned int m=0; m<cubic.size(); m++)
+        diff += SQR(cubic[m]-linear[m]);
+    return std::sqrt(diff/mean.size()) + truncation_error;
+}
+
+double BKEmulator::FillDipole(std::vector<double> par, Dipole& dipole, bool& emulated)
+{
+    if (dipole.YPoints() != 1)
+    {
+        cerr << "Emulator expects a dipole that only contains the initial condition " << LINEINFO << endl;
+        exit(1);
+    }
+
+    double error = ErrorIndicator(par);
+    if (error > tolerance)
+    {
+        emulated = false;
+        SolveBK(par, dipole);
+        return error;
+    }
+
+    emulated = true;
+    std::vector<double> amplitude = mean;
+    std::vector<double> coefs = InterpolateCoefficients(par, true);
+    for (unsigned int m=0; m<modes.size(); m++)
+        for (unsigned int k=0; k<amplitude.size(); k++)
+            amplitude[k] += coefs[m]*modes[m][k];
+
+    unsigned int rpoints = dipole.RPoints();
+    int yind=0;
+    for (unsigned int i=0; i<yvals.size(); i++)
+    {
+        double* row = &amplitude[i*rpoints];
+        for (unsigned int rind=0; rind<rpoints; rind++)
+        {
+            if (row[rind] > 1.0) row[rind] = 1.0;
+            if (row[rind] < 0 and config::FORCE_POSITIVE_N) row[rind] = 0;
+        }
+        yind = dipole.AddRapidity(yvals[i], row);
+    }
+    dipole.InitializeInterpolation(yind);
+    return error;
+}
+
+/*
+ * Training set file format:
+ * # comments
+ * yvals y_1 y_2 ...
+ * qs0sqr gamma e_c C^2 N(r_0,y_1) N(r_1,y_1) ... N(r_0,y_2) ...
+ */
+int BKEmulator::SaveTrainingSet(std::string filename)
+{
+    std::ofstream out(filename.c_str());
+    if (!out.is_open())
+    {
+        cerr << "Could not open file " << filename << " " << LINEINFO << endl;
+        return -1;
+    }
+    out.precision(10);
+    out << "# BK emulator training set, maxy=" << maxy << ", x0=" << icx0_bk << ", rpoints=" << config::RPOINTS
+        << ", x0_nlo_impfac=" << icx0_nlo_impfac << ", Q0sqr=" << icQ0sqr << endl;
+    out << "yvals";
+    for (unsigned int i=0; i<yvals.size(); i++)
+        out << " " << yvals[i];
+    out << endl;
+    for (unsigned int i=0; i<training_par.size(); i++)
+    {
+        for (unsigned int j=0; j<EMULATOR_PARAMETERS; j++)
+            out << training_par[i][j] << " ";
+        for (unsigned int k=0; k<snapshots[i].size(); k++)
+            out << snapshots[i][k] << " ";
+        out << endl;
+    }
+    return 0;
+}
+
+int BKEmulator::LoadTrainingSet(std::string filename)
+{
+    std::ifstream in(filename.c_str());
+    if (!in.is_open())
+    {
+        cerr << "Could not open file " << filename << " " << LINEINFO << endl;
+        return -1;
+    }
+    training_par.clear(); snapshots.clear(); yvals.clear();
+    std::string line;
+    bool header = false;
+    while (std::getline(in, line))
+    {
+        // The solutions are only valid for the settings they were solved with. Files written
+        // before x0_nlo_impfac and Q0sqr were saved have only the first three
+        double saved_maxy, saved_x0, saved_impfac, saved_q0sqr;
+        unsigned int saved_rpoints;
+        int fields = std::sscanf(line.c_str(), "# BK emulator training set, maxy=%lf, x0=%lf, rpoints=%u, x0_nlo_impfac=%lf, Q0sqr=%lf",
+            &saved_maxy, &saved_x0, &saved_rpoints, &saved_impfac, &saved_q0sqr);
+        if (fields >= 3)
+        {
+            header = true;
+            if (!SameSetting(saved_maxy, maxy) or !SameSetting(saved_x0, icx0_bk) or saved_rpoints != config::RPOINTS
+                or (fields == 5 and (!SameSetting(saved_impfac, icx0_nlo_impfac) or !SameSetting(saved_q0sqr, icQ0sqr))))
+            {
+                cerr << "Training set " << filename << " was solved with " << line.substr(2) << ", not maxy=" << maxy
+                    << ", x0=" << icx0_bk << ", rpoints=" << config::RPOINTS << ", x0_nlo_impfac=" << icx0_nlo_impfac
+                    << ", Q0sqr=" << icQ0sqr << " " << LINEINFO << endl;
+                training_par.clear(); snapshots.clear(); yvals.clear();
+                return -1;
+            }
+            continue;
+        }
+        if (line.empty() or line[0] == '#')
+            continue;
+        if (!header)
+        {
+            cerr << "Training set " << filename << " has no header with its settings " << LINEINFO << endl;
+            training_par.clear(); snapshots.clear(); yvals.clear();
+            return -1;
+        }
+        std::stringstream ss(line);
+        if (line.substr(0,5) == "yvals")
+        {
+            std::string label; ss >> label;
+            double y;
+            while (ss >> y) yvals.push_back(y);
+            continue;
+        }
+        std::vector<double> par(EMULATOR_PARAMETERS);
+        for (unsigned int j=0; j<EMULATOR_PARAMETERS; j++)
+            ss >> par[j];
+        std::vector<double> snapshot;
+        double n;
+        while (ss >> n) snapshot.push_back(n);
+        if (snapshot.size() != yvals.size()*config::RPOINTS)
+        {
+            cerr << "Training solution in " << filename << " has " << snapshot.size() << " values, expected "
+                << yvals.size()*config::RPOINTS << " " << LINEINFO << endl;
+            return -1;
+        }
+        training_par.push_back(par);
+        snapshots.push_back(snapshot);
+    }
+    return training_par.size();
+}
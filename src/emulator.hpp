@@ -0,0 +1,69 @@
+/*
+ * Reduced order emulator of BK solutions over the initial condition parameters
+ *
+ * A proper orthogonal decomposition (POD) basis of N(r,y) is built from
+ * a training set of BKSolver runs, and the basis coefficients are
+ * interpolated in the parameter space (Q_s0^2, gamma, e_c, C^2) with
+ * a cubic radial basis function interpolant.
+ */
+
+#ifndef _NLOBK_EMULATOR_HPP
+#define _NLOBK_EMULATOR_HPP
+
+#include <vector>
+#include <string>
+#include "dipole.hpp"
+
+class BKEmulator
+{
+    public:
+        // All training and emulated solutions are evolved up to maxy, the
+        // other arguments are passed to the BKSolver as in NLODISFitter
+        BKEmulator(double maxy, double icx0_bk, double icx0_nlo_impfac=1, double icQ0sqr=1);
+
+        // Parameter vector is (Q_s0^2, gamma, e_c, C^2)
+        int AddTrainingPoint(std::vector<double> par);     // Solves BK and stores the solution
+        int Build();    // Compute the POD basis and the interpolant, call after adding the training points
+
+        // Fill dipole (initialized with the MV^e initial condition at par) up to maxy.
+        // The solution is emulated if the error indicator is below the tolerance,
+        // otherwise BK is solved. Returns the error indicator.
+        double FillDipole(std::vector<double> par, Dipole& dipole, bool& emulated);
+
+        // Estimated RMS error of the emulated N(r,y), large outside the training region
+        double ErrorIndicator(std::vector<double> par);
+
+        void SetTolerance(double tol) { tolerance = tol; }
+        void SetEnergyFraction(double f) { energy_fraction = f; }   // Fraction of the snapshot variance kept in the basis
+        unsigned int Modes() { return modes.size(); }
+        unsigned int TrainingPoints() { return training_par.size(); }
+
+        int SaveTrainingSet(std::string filename);
+        int LoadTrainingSet(std::string filename);
+
+    private:
+        std::vector<double> NormalizedParameters(std::vector<double> par);
+        std::vector<double> InterpolateCoefficients(std::vector<double> par, bool cubic);
+        int SolveBK(std::vector<double> par, Dipole& dipole);
+
+        double maxy;
+        double icx0_bk;
+        double icx0_nlo_impfac;
+        double icQ0sqr;
+        double tolerance;
+        double energy_fraction;
+
+        std::vector< std::vector<double> > training_par;
+        std::vector< std::vector<double> > snapshots;   // N(r,y) at y>0, flattened as [yind*rpoints + rind]
+        std::vector<double> yvals;                      // Rapidities of the snapshot rows
+
+        std::vector<double> par_min, par_max;           // Range of the normalized training parameters
+        std::vector<double> mean;
+        double truncation_error;                        // RMS error from the discarded POD modes
+        std::vector< std::vector<double> > modes;
+        // Weights of the RBF interpolants for each POD coefficient, last 5 are the linear polynomial tail
+        std::vector< std::vector<double> > rbf_weights_cubic;
+        std::vector< std::vector<double> > rbf_weights_linear;
+};
+
+#endif
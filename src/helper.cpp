@@ -33,9 +33,18 @@ struct sigma02helper
     std::vector<double> expdata;
     std::vector<double> experr;
     std::vector<double> thdata;
+    std::vector<double> therr;
     
 };
 
+// Error of data point i in chi^2 at sigma02
+double chisqr_error(double sigma02, const std::vector<double>& experr, const std::vector<double>& therr, unsigned int i)
+{
+    if (therr.empty())
+        return experr[i];
+    return std::hypot(experr[i], sigma02*therr[i]);
+}
+
 double minimiser_helper_chisqr(double sigma02, void* p)
 {
     sigma02helper *par = (sigma02helper*)p;
@@ -43,33 +52,35 @@ double minimiser_helper_chisqr(double sigma02, void* p)
     double sum=0;
     for (unsigned int i=0; i< par->expdata.size(); i++)
     {
-        sum += std::pow((sigma02*par->thdata[i]-par->expdata[i])/par->experr[i], 2.0)/par->expdata.size();
+        sum += std::pow((sigma02*par->thdata[i]-par->expdata[i])/chisqr_error(sigma02, par->experr, par->therr, i), 2.0)/par->expdata.size();
     }
     //cout << sigma02 << " " << sum << endl;
     return sum;
 }
 
 double minimiser_helper_chisqr_vec(double sigma02, std::vector<double> expdata, std::vector<double> experr,
-                          std::vector<double> thdata)
+                          std::vector<double> thdata, std::vector<double> therr)
 {
     double sum=0;
     for (unsigned int i=0; i< expdata.size(); i++)
     {
-        sum += std::pow((sigma02*thdata[i]-expdata[i])/experr[i], 2.0)/expdata.size();
+        sum += std::pow((sigma02*thdata[i]-expdata[i])/chisqr_error(sigma02, experr, therr, i), 2.0)/expdata.size();
     }
     //cout << sigma02 << " " << sum << endl;
     return sum;
 }
 
 std::vector<double> FindOptimalSigma02(std::vector<double> expdata, std::vector<double> experr,
-                          std::vector<double> thdata)
+                          std::vector<double> thdata, std::vector<double> therr)
 {
     sigma02helper par;
     par.expdata = expdata;
     par.experr = experr;
     par.thdata = thdata;
+    par.therr = therr;
     
-    if (expdata.size() != experr.size() or expdata.size() != thdata.size())
+    if (expdata.size() != experr.size() or expdata.size() != thdata.size()
+        or (!therr.empty() and therr.size() != thdata.size()))
     {
         cerr << "Optimizer did not get vectors with same size???" << endl;
         exit(1);
@@ -9,10 +9,12 @@
 #include <vector>
 // Optimize sigma02 (the coefficient which multiplies SigmaComputer.SigmarLOmass
 // Returns optimal sigma02 and total chi^2
+// therr: errors of thdata (e.g. integration error budgets), scaled with sigma02 as thdata and
+// added to experr in quadrature. Empty: only experr.
 std::vector<double> FindOptimalSigma02(std::vector<double> expdata, std::vector<double> experr,
-                         std::vector<double> thdata);
+                         std::vector<double> thdata, std::vector<double> therr=std::vector<double>());
 
 double minimiser_helper_chisqr_vec(double sigma02, std::vector<double> expdata, std::vector<double> experr,
-                          std::vector<double> thdata);
+                          std::vector<double> thdata, std::vector<double> therr=std::vector<double>());
 
 #endif
@@ -0,0 +1,97 @@
+/*
+ * LCPT NLO DIS fitter
+ * Uniform grid tables with Lagrange interpolation
+ */
+
+#ifndef _LAGRANGE_GRID_HPP
+#define _LAGRANGE_GRID_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+// Uniform grid in up to three dimensions with the same step in all of them,
+// interpolated with 4-point Lagrange polynomials in each dimension.
+// Coordinates outside the grid are clamped to its boundary.
+class LagrangeGrid
+{
+    public:
+        LagrangeGrid() { dims=0; step=0; }
+
+        void Init(int d, const double* minc, const double* maxc, double h)
+        {
+            dims = d;
+            step = h;
+            int size = 1;
+            for (int i=0; i<dims; i++)
+            {
+                minv[i] = minc[i];
+                n[i] = std::max(4, static_cast<int>(std::ceil((maxc[i]-minc[i])/h - 1e-9)) + 1);
+                maxv[i] = minv[i] + (n[i]-1)*h;
+                size *= n[i];
+            }
+            data.assign(size, 0);
+        }
+
+        int Size() const { return data.size(); }
+        double Min(int d) const { return minv[d]; }
+        double Max(int d) const { return maxv[d]; }
+        double Step() const { return step; }
+        double& operator[](int index) { return data[index]; }
+
+        // Coordinates of the node index, data[(i0*n1 + i1)*n2 + i2]
+        void Node(int index, double* c) const
+        {
+            for (int d=dims-1; d>=0; d--)
+            {
+                c[d] = minv[d] + (index % n[d])*step;
+                index /= n[d];
+            }
+        }
+
+        double Interpolate(const double* c) const
+        {
+            int first[3];
+            double w[3][4];
+            for (int d=0; d<dims; d++)
+            {
+                double t = (c[d] - minv[d])/step;
+                t = std::max(0.0, std::min(t, n[d]-1.0));
+                int f = static_cast<int>(std::floor(t)) - 1;
+                f = std::max(0, std::min(f, n[d]-4));
+                first[d] = f;
+                for (int i=0; i<4; i++)
+                {
+                    double wi = 1;
+                    for (int j=0; j<4; j++)
+                        if (j != i)
+                            wi *= (t - (f+j))/(double)(i-j);
+                    w[d][i] = wi;
+                }
+            }
+            double res = 0;
+            const int corners = 1 << (2*dims);
+            for (int k=0; k<corners; k++)
+            {
+                int index = 0;
+                double wk = 1;
+                for (int d=0; d<dims; d++)
+                {
+                    int i = (k >> (2*(dims-1-d))) & 3;
+                    index = index*n[d] + first[d] + i;
+                    wk *= w[d][i];
+                }
+                res += wk*data[index];
+            }
+            return res;
+        }
+
+    private:
+        int dims;
+        int n[3];
+        double minv[3], maxv[3];
+        double step;
+        std::vector<double> data;
+};
+
+#endif
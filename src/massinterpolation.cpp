@@ -0,0 +1,71 @@
+/*
+ * LCPT NLO DIS fitter
+ * Quark mass interpolation table of the massive structure functions
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "massinterpolation.hpp"
+#include "nlodissigmar.hpp"
+
+MassInterpolationTable::MassInterpolationTable()
+{
+    mpoints=0;
+    minm=0; maxm=0; step=0;
+}
+
+void MassInterpolationTable::Build(ComputeSigmaR& sigma, const std::vector<double>& qsqr,
+    const std::vector<double>& xbj, double m0, double halfwidth, int points, bool nlo)
+{
+    mpoints = std::max(points, 1);
+    if (mpoints == 1)
+        halfwidth = 0;
+    minm = m0 - halfwidth;
+    maxm = m0 + halfwidth;
+    step = mpoints > 1 ? (maxm - minm)/(mpoints-1) : 0;
+
+    std::vector<double> masses(mpoints);
+    for (int i=0; i<mpoints; i++)
+        masses[i] = minm + i*step;
+
+    const int kpoints = qsqr.size();
+    table.resize(2*kpoints*mpoints);
+#ifdef PARALLEL_CHISQR
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int k=0; k<kpoints; k++)
+    {
+        std::vector<double> FL, FT;
+        sigma.Structf_massive_multimass(std::sqrt(qsqr[k]), xbj[k], masses, FL, FT, nlo);
+        for (int i=0; i<mpoints; i++)
+        {
+            table[2*(k*mpoints + i)] = FL[i];
+            table[2*(k*mpoints + i) + 1] = FT[i];
+        }
+    }
+}
+
+void MassInterpolationTable::Structf(int k, double m, double F[2]) const
+{
+    const double* tab = &table[2*k*mpoints];
+    if (mpoints == 1)
+    {
+        F[0] = tab[0]; F[1] = tab[1];
+        return;
+    }
+    // Lagrange interpolation on the (up to) 4 grid points around m
+    const int order = std::min(mpoints, 4);
+    double t = (m - minm)/step;
+    int first = static_cast<int>(std::floor(t)) - (order-1)/2;
+    first = std::max(0, std::min(first, mpoints - order));
+    F[0] = 0; F[1] = 0;
+    for (int i=first; i<first+order; i++)
+    {
+        double w = 1;
+        for (int j=first; j<first+order; j++)
+            if (j != i)
+                w *= (t - j)/(double)(i - j);
+        F[0] += w*tab[2*i];
+        F[1] += w*tab[2*i+1];
+    }
+}
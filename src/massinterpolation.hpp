@@ -0,0 +1,46 @@
+/*
+ * LCPT NLO DIS fitter
+ * Quark mass interpolation table of the massive structure functions
+ */
+
+#ifndef _MASS_INTERPOLATION_HPP
+#define _MASS_INTERPOLATION_HPP
+
+#include <vector>
+
+class ComputeSigmaR;
+
+/*
+ * F_L and F_T of one heavy flavour at a set of kinematic points (Q^2, xbj),
+ * tabulated on a uniform grid of quark masses around the current mass
+ * m0 - halfwidth ... m0 + halfwidth and interpolated in the mass with
+ * 4-point Lagrange polynomials. For an odd number of grid points m0 is a
+ * grid point, and the structure functions at m0 are the integrated ones.
+ *
+ * The table depends on the dipole of the ComputeSigmaR it is built with,
+ * and is valid as long as only the quark mass changes.
+ * All masses of one kinematic point are integrated together over shared
+ * samples with ComputeSigmaR::Structf_massive_multimass.
+ */
+class MassInterpolationTable
+{
+    public:
+        MassInterpolationTable();
+
+        void Build(ComputeSigmaR& sigma, const std::vector<double>& qsqr, const std::vector<double>& xbj,
+            double m0, double halfwidth, int points, bool nlo=true);
+
+        // F = {FL, FT} of the kinematic point k at mass m
+        void Structf(int k, double m, double F[2]) const;
+
+        bool InRange(double m) const { return !table.empty() && m >= minm && m <= maxm; }
+        bool Initialized() const { return !table.empty(); }
+        void Clear() { table.clear(); }
+
+    private:
+        std::vector<double> table;      // table[2*(k*mpoints + i) + pol], pol = 0: L, 1: T
+        int mpoints;
+        double minm, maxm, step;
+};
+
+#endif
@@ -75,6 +75,7 @@ int main( int argc, char* argv[] )
     bool useNLO = true;
     bool computeNLO = useNLO;
     string cubaMethod = "vegas";
+    // string cubaMethod = "auto";   // Cuhre up to 3 dimensions, Vegas above
     // string cubaMethod = "suave";
 
     config::NO_K2 = true;  // Do not include numerically demanding full NLO part
@@ -0,0 +1,438 @@
+/*
+ * LCPT NLO DIS fitter
+ * Tabulated auxiliary functions of the massive NLO impact factors
+ */
+
+#include <cmath>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include <gsl/gsl_integration.h>
+#include <gsl/gsl_sf_bessel.h>
+#include "nlodis_config.hpp"
+#include "massivetables.hpp"
+#include "nlodissigmar_massiveq.hpp"
+#include "quadrature.hpp"
+#include "bessel.hpp"
+#include "lagrangegrid.hpp"
+
+using std::cout; using std::endl;
+
+namespace
+{
+    inline double Sq(double x) { return x*x; }
+
+    // ------------------------ DIPOLE TERMS ------------------------
+
+    // Grid in u = logit(z) and s = ln(mf^2/Q^2)
+    const double DIP_TABLE_MAXU = 25;
+    const double DIP_TABLE_MINS = -14;
+    const double DIP_TABLE_MAXS = 6;
+    const double DIP_TABLE_STEP = 0.1;
+    // Maximum error relative to max(1, |f|), checked at |u| < DIP_TABLE_CHECKU where the
+    // direct evaluation is free of cancellations
+    const double DIP_TABLE_TOLERANCE = 1e-5;
+    const double DIP_TABLE_CHECKU = 12;
+
+    double LdipOmegaL_direct( double Q, double z, double mf )
+    {
+        return OmegaL_V(Q,z,mf) + L_dip(Q,z,mf);
+    }
+    double LdipOmegaT_V_direct( double Q, double z, double mf )
+    {
+        return OmegaT_V_unsymmetric(Q,z,mf) + OmegaT_V_unsymmetric(Q,1.0-z,mf) + L_dip(Q,z,mf);
+    }
+    double OmegaT_N_direct( double Q, double z, double mf )
+    {
+        return OmegaT_N_unsymmetric(Q,z,mf) - OmegaT_N_unsymmetric(Q,1.0-z,mf);
+    }
+
+    typedef double (*DipFunction)(double, double, double);
+    const int DIP_TABLES = 3;
+    const DipFunction dip_direct[DIP_TABLES] = { LdipOmegaL_direct, LdipOmegaT_V_direct, OmegaT_N_direct };
+    const char* const dip_names[DIP_TABLES] = { "OmegaL_V+L_dip", "OmegaT_V+L_dip", "OmegaT_N" };
+    LagrangeGrid dip_tables[DIP_TABLES];
+    bool dip_table_valid[DIP_TABLES] = { false, false, false };   // Within DIP_TABLE_TOLERANCE
+    bool dip_tables_built = false;
+
+    void FillDipTable(int f, double step)
+    {
+        const double minc[2] = { -DIP_TABLE_MAXU, DIP_TABLE_MINS };
+        const double maxc[2] = { DIP_TABLE_MAXU, DIP_TABLE_MAXS };
+        LagrangeGrid& grid = dip_tables[f];
+        grid.Init(2, minc, maxc, step);
+        #pragma omp parallel for schedule(dynamic, 256)
+        for (int i=0; i<grid.Size(); i++)
+        {
+            double c[2];
+            grid.Node(i, c);
+            grid[i] = dip_direct[f](1.0, 1.0/(1.0 + std::exp(-c[0])), std::exp(0.5*c[1]));
+        }
+    }
+
+    double DipTableError(int f)
+    {
+        std::mt19937 gen(f+1);
+        std::uniform_real_distribution<double> rnd(0, 1);
+        double maxerr = 0;
+        for (int i=0; i<2000; i++)
+        {
+            double c[2] = { DIP_TABLE_CHECKU*(2.0*rnd(gen) - 1.0),
+                DIP_TABLE_MINS + (DIP_TABLE_MAXS - DIP_TABLE_MINS)*rnd(gen) };
+            double ref = dip_direct[f](1.0, 1.0/(1.0 + std::exp(-c[0])), std::exp(0.5*c[1]));
+            maxerr = std::max(maxerr, std::abs(dip_tables[f].Interpolate(c) - ref)/std::max(1.0, std::abs(ref)));
+        }
+        return maxerr;
+    }
+
+    bool BuildDipTables()
+    {
+        for (int f=0; f<DIP_TABLES; f++)
+        {
+            FillDipTable(f, DIP_TABLE_STEP);
+            double err = DipTableError(f);
+            if (err > DIP_TABLE_TOLERANCE)
+            {
+                FillDipTable(f, 0.5*DIP_TABLE_STEP);
+                err = DipTableError(f);
+            }
+            dip_table_valid[f] = (err <= DIP_TABLE_TOLERANCE);
+            cout << "# Tabulated " << dip_names[f] << ": " << dip_tables[f].Size() << " points, step "
+                << dip_tables[f].Step() << ", max error " << err << endl;
+            if (!dip_table_valid[f])
+                std::cerr << "# Table of " << dip_names[f] << " exceeds the tolerance " << DIP_TABLE_TOLERANCE
+                    << ", it is evaluated directly" << endl;
+        }
+        dip_tables_built = true;
+        return true;
+    }
+
+    double DipFunctionValue(int f, double Q, double z, double mf)
+    {
+        if (!nlodis_config::MASSIVE_DIP_TABLES || !dip_tables_built || !dip_table_valid[f] || !(mf > 0) || !(z > 0 && z < 1))
+            return dip_direct[f](Q, z, mf);
+        const LagrangeGrid& grid = dip_tables[f];
+        double c[2] = { std::log(z/(1.0-z)), 2.0*std::log(mf/Q) };
+        if (c[0] < grid.Min(0) || c[0] > grid.Max(0) || c[1] < grid.Min(1) || c[1] > grid.Max(1))
+            return dip_direct[f](Q, z, mf);
+        return grid.Interpolate(c);
+    }
+
+    // ------------------------ G^(a;b) ------------------------
+
+    // Grid in ln(alpha), ln(beta) and ln(kappa)
+    const double G_TABLE_MINLOG = -28;      // alpha, beta
+    const double G_TABLE_MAXLOG = 9.5;
+    const double G_TABLE_MINLOGKAPPA = -14;
+    const double G_TABLE_MAXLOGKAPPA = 14;
+    const double G_TABLE_STEP = 0.5;
+    // Maximum relative error G_TABLE_EPSREL_FRACTION*CUBA_EPSREL, checked where H is not suppressed
+    // by more than exp(-G_CHECK_EXPONENT) against an adaptive GSL integration with relative accuracy
+    // G_REFERENCE_EPSREL. The error is largest where the falloff changes from the interior saddle
+    // point in y to y=1, and is O(1e-4) on average.
+    const double G_TABLE_EPSREL_FRACTION = 0.1;
+    const double G_CHECK_EXPONENT = 30;
+    const double G_REFERENCE_EPSREL = 1e-8;
+    // H is set to zero when its falloff is exp(-E) with E > G_MAX_EXPONENT, and the
+    // y integral is cut where the Bessel function is exp(-G_QUADRATURE_RANGE) smaller
+    const double G_MAX_EXPONENT = 100;
+    const double G_QUADRATURE_RANGE = 60;
+
+    // Tables 0: (1;1), 1: (2;1), 2: (1;2) bar, 3: (2;2) bar
+    const int G_TABLES = 4;
+    const int g_a[G_TABLES] = { 1, 2, 1, 2 };
+    const int g_b[G_TABLES] = { 1, 1, 2, 2 };
+    LagrangeGrid g_tables[G_TABLES];
+    bool g_table_valid[G_TABLES] = { false, false, false, false };  // Within GTableTolerance()
+    bool g_tables_built = false;
+
+    double GTableTolerance()
+    {
+        return G_TABLE_EPSREL_FRACTION*nlodis_config::CUBA_EPSREL;
+    }
+
+    int GTableIndex(int a, int b, bool bar)
+    {
+        for (int t=0; t<G_TABLES; t++)
+            if (g_a[t] == a && g_b[t] == b && (t >= 2) == bar)
+                return t;
+        std::cerr << "No tabulated G^(" << a << ";" << b << ")" << (bar ? " bar" : "") << endl;
+        exit(1);
+    }
+
+    // e^x K_n(x)
+    double BesselKnScaled(int n, double x)
+    {
+        if (x <= 2.0)
+            return std::exp(x)*FastBesselKn(n, x);
+        double km = FastBesselK0_scaled_large(x);
+        if (n == 0)
+            return km;
+        double k = FastBesselK1_scaled_large(x);
+        for (int j=1; j<n; j++)
+        {
+            double kp = km + 2.0*j/x*k;
+            km = k;
+            k = kp;
+        }
+        return k;
+    }
+
+    // g_n(x0 + d) - g_n(x0) for g_n(x) = x^n K_n(x), n >= 1, using g_n' = -x^n K_(n-1)
+    // for small d where the difference would cancel
+    double BesselGDifference(int n, double x0, double d)
+    {
+        if (std::abs(d) < 1e-2*x0)
+        {
+            static const double nodes[3] = { -0.7745966692414834, 0, 0.7745966692414834 };
+            static const double weights[3] = { 5.0/9.0, 8.0/9.0, 5.0/9.0 };
+            double sum = 0;
+            for (int i=0; i<3; i++)
+            {
+                double x = x0 + 0.5*d*(1.0 + nodes[i]);
+                sum += weights[i]*std::pow(x, n)*FastBesselKn(n-1, x);
+            }
+            return -0.5*d*sum;
+        }
+        double x1 = x0 + d;
+        return std::pow(x1, n)*FastBesselKn(n, x1) - std::pow(x0, n)*FastBesselKn(n, x0);
+    }
+
+    // Exponent E of the leading falloff exp(-E) of H_ab(alpha, beta, kappa), or of the
+    // bar difference
+    double GExponent(double alpha, double beta, double kappa, bool bar)
+    {
+        if (bar)
+            return std::sqrt(alpha + beta);
+        if (beta*kappa > alpha)
+            return std::sqrt(beta) + std::sqrt(alpha*kappa);
+        return std::sqrt((1.0 + kappa)*(alpha + beta));
+    }
+
+    // e^E H_ab(alpha, beta, kappa), or e^E (H_ab(kappa) - H_ab(0)) for bar, integrated in t = -ln y
+    // with a composite Gauss-Legendre rule of panels of the given width
+    double HScaled(int a, int b, double alpha, double beta, double kappa, bool bar,
+        int order=8, double width=1.0)
+    {
+        const double p = 0.5*(2.0 - a + b);
+        const int n = a + b - 2;
+        const double E = GExponent(alpha, beta, kappa, bar);
+        double tmax = std::log(Sq(E + G_QUADRATURE_RANGE)/alpha);
+        if (tmax < 1.0)
+            tmax = 1.0;
+        std::vector<double> nodes, weights;
+        GaussLegendreNodes(order, 0, tmax, nodes, weights, std::max(1, static_cast<int>(std::ceil(tmax/width))));
+
+        double sum = 0;
+        for (size_t i=0; i<nodes.size(); i++)
+        {
+            const double y = std::exp(-nodes[i]);
+            const double phi0 = alpha/y + beta;
+            if (!bar)
+            {
+                const double x = std::sqrt((1.0 + y*kappa)*phi0);
+                sum += weights[i]*std::pow(y, 1.0-p)*std::pow((1.0 + y*kappa)/(alpha + y*beta), 0.5*n)
+                    *BesselKnScaled(n, x)*std::exp(E - x);
+            }
+            else
+            {
+                const double x0 = std::sqrt(phi0);
+                const double d = x0*y*kappa/(std::sqrt(1.0 + y*kappa) + 1.0);
+                sum += weights[i]*std::pow(y, 1.0-p)*std::pow(alpha + y*beta, -0.5*n)*std::pow(phi0, -0.5*n)
+                    *BesselGDifference(n, x0, d)*std::exp(E);
+            }
+        }
+        return sum;
+    }
+
+    // Tabulated value: ln(e^E H) or ln(-e^E (H(kappa) - H(0)) (1+kappa)/kappa)
+    double GTableValue(int t, double alpha, double beta, double kappa)
+    {
+        const bool bar = t >= 2;
+        double v = HScaled(g_a[t], g_b[t], alpha, beta, kappa, bar);
+        if (bar)
+            v = -v*(1.0 + kappa)/kappa;
+        return std::log(std::max(v, 1e-300));
+    }
+
+    void FillGTable(int t, double step)
+    {
+        const double minc[3] = { G_TABLE_MINLOG, G_TABLE_MINLOG, G_TABLE_MINLOGKAPPA };
+        const double maxc[3] = { G_TABLE_MAXLOG, G_TABLE_MAXLOG, G_TABLE_MAXLOGKAPPA };
+        LagrangeGrid& grid = g_tables[t];
+        grid.Init(3, minc, maxc, step);
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int i=0; i<grid.Size(); i++)
+        {
+            double c[3];
+            grid.Node(i, c);
+            grid[i] = GTableValue(t, std::exp(c[0]), std::exp(c[1]), std::exp(c[2]));
+        }
+    }
+
+    struct GReferenceParams
+    {
+        int a, b;
+        double alpha, beta, kappa;
+        double E;
+        bool bar;
+    };
+
+    // e^E times the integrand of H_ab in t = -ln y, or of the bar difference, as in HScaled but
+    // with the GSL Bessel functions and without the cut in t
+    double GReferenceIntegrand(double t, void* p)
+    {
+        const GReferenceParams* g = static_cast<const GReferenceParams*>(p);
+        const double pw = 0.5*(2.0 - g->a + g->b);
+        const int n = g->a + g->b - 2;
+        const double y = std::exp(-t);
+        const double phi0 = g->alpha/y + g->beta;
+        const double x = std::sqrt((1.0 + y*g->kappa)*phi0);
+        double v = std::pow((1.0 + y*g->kappa)/(g->alpha + y*g->beta), 0.5*n)
+            *gsl_sf_bessel_Kn_scaled(n, x)*std::exp(g->E - x);
+        if (g->bar)
+        {
+            const double x0 = std::sqrt(phi0);
+            v -= std::pow(g->alpha + y*g->beta, -0.5*n)*gsl_sf_bessel_Kn_scaled(n, x0)*std::exp(g->E - x0);
+        }
+        return std::pow(y, 1.0-pw)*v;
+    }
+
+    // Independent value of e^E H (or of the bar difference) by adaptive integration over t in [0,inf),
+    // sets ok to false if the integration does not converge
+    double GReferenceValue(int t, double alpha, double beta, double kappa, bool& ok)
+    {
+        const bool bar = t >= 2;
+        GReferenceParams params = { g_a[t], g_b[t], alpha, beta, kappa, GExponent(alpha, beta, kappa, bar), bar };
+        gsl_function fun;
+        fun.function = GReferenceIntegrand;
+        fun.params = &params;
+        const size_t limit = 1000;
+        gsl_integration_workspace* workspace = gsl_integration_workspace_alloc(limit);
+        double result, abserr;
+        int status = gsl_integration_qagiu(&fun, 0, 0, G_REFERENCE_EPSREL, limit, workspace, &result, &abserr);
+        gsl_integration_workspace_free(workspace);
+        ok = (status == 0);
+        return result;
+    }
+
+    // Maximum relative error at random points inside the grid with E < G_CHECK_EXPONENT,
+    // compared to GReferenceValue. Points where the reference does not converge are skipped
+    double GTableError(int t)
+    {
+        const bool bar = t >= 2;
+        const LagrangeGrid& grid = g_tables[t];
+        std::mt19937 gen(t+1);
+        std::uniform_real_distribution<double> rnd(0, 1);
+        double maxerr = 0;
+        for (int i=0; i<500; i++)
+        {
+            double c[3];
+            for (int d=0; d<3; d++)
+                c[d] = grid.Min(d) + grid.Step() + (grid.Max(d) - grid.Min(d) - 2.0*grid.Step())*rnd(gen);
+            const double alpha = std::exp(c[0]), beta = std::exp(c[1]), kappa = std::exp(c[2]);
+            if (GExponent(alpha, beta, kappa, bar) > G_CHECK_EXPONENT)
+                continue;
+            bool ok;
+            double ref = GReferenceValue(t, alpha, beta, kappa, ok);
+            if (!ok)
+                continue;
+            if (bar)
+                ref = -ref*(1.0 + kappa)/kappa;
+            maxerr = std::max(maxerr, std::abs(std::exp(grid.Interpolate(c))/ref - 1.0));
+        }
+        return maxerr;
+    }
+
+    bool BuildGTables()
+    {
+        for (int t=0; t<G_TABLES; t++)
+        {
+            FillGTable(t, G_TABLE_STEP);
+            double err = GTableError(t);
+            if (err > GTableTolerance())
+            {
+                FillGTable(t, 0.5*G_TABLE_STEP);
+                err = GTableError(t);
+            }
+            g_table_valid[t] = (err <= GTableTolerance());
+            cout << "# Tabulated G^(" << g_a[t] << ";" << g_b[t] << ")" << (t >= 2 ? " bar" : "")
+                << ": " << g_tables[t].Size() << " points, step " << g_tables[t].Step()
+                << ", max relative error " << err << endl;
+            if (!g_table_valid[t])
+                std::cerr << "# Table of G^(" << g_a[t] << ";" << g_b[t] << ")" << (t >= 2 ? " bar" : "")
+                    << " exceeds the tolerance " << GTableTolerance() << ", it is integrated directly" << endl;
+        }
+        g_tables_built = true;
+        return true;
+    }
+
+    // H_ab(alpha, beta, kappa), or H_ab(kappa) - H_ab(0) for bar
+    double H(int a, int b, double alpha, double beta, double kappa, bool bar)
+    {
+        const int t = GTableIndex(a, b, bar);
+        if (bar && !(kappa > 0))
+            return 0;
+        alpha = std::max(alpha, 1e-300);
+        const double E = GExponent(alpha, beta, kappa, bar);
+        if (E > G_MAX_EXPONENT)
+            return 0;
+        const LagrangeGrid& grid = g_tables[t];
+        if (!g_tables_built || !g_table_valid[t] || std::log(alpha) < grid.Min(0) || (!bar && std::log(kappa) > grid.Max(2)))
+            return HScaled(a, b, alpha, beta, kappa, bar)*std::exp(-E);
+        // Below the grid in beta and kappa the normalized H is constant
+        double c[3] = { std::log(alpha), std::log(beta), kappa > 0 ? std::log(kappa) : grid.Min(2) };
+        double v = std::exp(grid.Interpolate(c) - E);
+        if (bar)
+            v *= -kappa/(1.0 + kappa);
+        return v;
+    }
+
+    double GPrefactor(int a, int b, double c, double omega)
+    {
+        return std::pow(2.0, a+b-1)*std::pow(omega, b-1)*std::pow(c, a+b-2);
+    }
+}
+
+void InitMassiveTables()
+{
+    // Function-local statics are built once, also when called from several threads
+    if (nlodis_config::MASSIVE_DIP_TABLES)
+    {
+        static const bool dip_built = BuildDipTables();
+        (void)dip_built;
+    }
+    if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_TABULATED_G)
+    {
+        static const bool g_built = BuildGTables();
+        (void)g_built;
+    }
+}
+
+double LdipOmegaL( double Q, double z, double mf )
+{
+    return DipFunctionValue(0, Q, z, mf);
+}
+
+double LdipOmegaT_V( double Q, double z, double mf )
+{
+    return DipFunctionValue(1, Q, z, mf);
+}
+
+double OmegaT_N( double Q, double z, double mf )
+{
+    return DipFunctionValue(2, Q, z, mf);
+}
+
+double G_integrated(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda)
+{
+    const double c = Sq(Qbar) + Sq(mf);
+    return GPrefactor(a, b, c, omega)*H(a, b, c*omega*Sq(x2), c*Sq(x3), lambda*Sq(mf)/c, false);
+}
+
+double G_bar_integrated(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda)
+{
+    const double c = Sq(Qbar) + Sq(mf);
+    return GPrefactor(a, b, c, omega)*H(a, b, c*omega*Sq(x2), c*Sq(x3), lambda*Sq(mf)/c, true);
+}
@@ -0,0 +1,52 @@
+/*
+ * LCPT NLO DIS fitter
+ * Tabulated auxiliary functions of the massive NLO impact factors
+ */
+
+#ifndef _MASSIVE_TABLES_HPP
+#define _MASSIVE_TABLES_HPP
+
+/*
+ * 1) The dilogarithm and logarithm terms of the massive dipole terms, which depend on
+ *    z and mf^2/Q^2 only (see L_dip, OmegaL_V, OmegaT_V_unsymmetric and
+ *    OmegaT_N_unsymmetric in nlodissigmar_massiveq.cpp):
+ *      LdipOmegaL(Q,z,mf)    = OmegaL_V + L_dip
+ *      LdipOmegaT_V(Q,z,mf)  = OmegaT_V_unsymmetric(z) + OmegaT_V_unsymmetric(1-z) + L_dip
+ *      OmegaT_N(Q,z,mf)      = OmegaT_N_unsymmetric(z) - OmegaT_N_unsymmetric(1-z)
+ *    They are tabulated on a uniform grid in logit(z) and ln(mf^2/Q^2) and interpolated
+ *    with 4x4 point Lagrange polynomials, outside the grid they are evaluated directly.
+ *
+ * 2) The integrals over 0<y<1 of G_integrand_simplified, i.e. the functions G^(a;b) of
+ *    the qqg terms, which are integrated as the y_t dimensions in the _fast integrands.
+ *    With c = Qbar^2 + mf^2, alpha = c omega x2^2, beta = c x3^2, kappa = lambda mf^2/c
+ *    and n = a+b-2 they reduce to
+ *      \int_0^1 dy G_integrand_simplified = 2^(a+b-1) omega^(b-1) c^n H_ab(alpha, beta, kappa)
+ *      H_ab = \int_0^1 dy y^(-(2-a+b)/2) ((1 + y kappa)/(alpha + y beta))^(n/2)
+ *                   K_n( sqrt( (1 + y kappa)(alpha/y + beta) ) ),
+ *    which are tabulated in ln(alpha), ln(beta), ln(kappa) for the (1;1) and (2;1)
+ *    functions, and for the differences lambda - (lambda=0) of the (1;2) and (2;2) ones
+ *    that appear in the integrands ("bar"). The logarithm of H divided by its leading
+ *    exponential falloff is interpolated with 4x4x4 point Lagrange polynomials.
+ *    Points below the grid in alpha are integrated directly, and H is set to zero
+ *    where the exponent of the falloff is larger than 100.
+ *
+ * Both sets of tables are built once per process by InitMassiveTables, with a maximum
+ * error measured against direct evaluation at random points of the grid. If the error is
+ * larger than the tolerance, the table is rebuilt once with half the step. If it still fails,
+ * the function is evaluated directly instead of from that table. With the default
+ * steps the maximum errors are 2e-6 (dipole terms) and 1e-2 (G, mean 1e-4).
+ */
+
+// Build the tables enabled in nlodis_config (MASSIVE_DIP_TABLES, PERF_MODE == MASSIVE_TABULATED_G)
+void InitMassiveTables();
+
+double LdipOmegaL( double Q, double z, double mf );
+double LdipOmegaT_V( double Q, double z, double mf );
+double OmegaT_N( double Q, double z, double mf );
+
+// \int_0^1 dy G_integrand_simplified(a, b, Qbar, mf, x2, x3, omega, lambda, y), (a;b) = (1;1) or (2;1)
+double G_integrated(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda);
+// The same integral of G(lambda) - G(lambda=0), (a;b) = (1;2) or (2;2)
+double G_bar_integrated(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda);
+
+#endif
@@ -46,6 +46,13 @@ namespace config
 
      INTEGRATION_METHOD INTMETHOD_NLO = MISER;
 
+     NLO_KERNEL_CACHE_MODE NLO_KERNEL_CACHE = KERNEL_CACHE_DISABLED;
+     int NLO_KERNEL_CACHE_LNRPOINTS = 24;
+     int NLO_KERNEL_CACHE_THETAPOINTS = 8;
+     double NLO_KERNEL_CACHE_ACCURACY = 0.01;
+     int NLO_KERNEL_CACHE_CHECKPOINTS = 3;
+     double NLO_KERNEL_CACHE_MAXMEMORY = 4000;
+
      bool FORCE_POSITIVE_N = true;
 
      bool DNDY=false;
@@ -66,6 +73,8 @@ namespace config
     bool TARGET_KINEMATICAL_CONSTRAINT=false;
     
     bool EULER_METHOD = false;
+    
+    int RICHARDSON_LEVELS = 0;
 }
 
 
@@ -109,6 +118,8 @@ std::string NLOBK_CONFIG_STRING()
         ss <<"# Using Euler method in K1" << endl;
     else
         ss << "# Using RungeKutta method in K1" << endl;
+    if (config::RICHARDSON_LEVELS > 1)
+        ss << "# Richardson extrapolation from " << config::RICHARDSON_LEVELS << " solutions with rapidity steps h=" << DE_SOLVER_STEP << ", h/2" << (config::RICHARDSON_LEVELS > 2 ? ", h/4" : "") << endl;
     
     
     //if (FORCE_POSITIVE_N)
@@ -148,6 +159,12 @@ std::string NLOBK_CONFIG_STRING()
             ss << "Multiple integrals (no montecarlo)";
         else
             ss <<"UNKNOWN!";
+        if (NLO_KERNEL_CACHE != KERNEL_CACHE_DISABLED)
+        {
+            ss << "; overridden by precomputed kernels on a fixed mesh, initial ln r points=" << NLO_KERNEL_CACHE_LNRPOINTS
+               << ", theta points=" << NLO_KERNEL_CACHE_THETAPOINTS << ", accuracy " << NLO_KERNEL_CACHE_ACCURACY
+               << (NLO_KERNEL_CACHE == KERNEL_CACHE_FLOAT ? " (float)" : " (double)");
+        }
         ss << endl;
     }
     
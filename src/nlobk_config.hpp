@@ -73,6 +73,25 @@ namespace config
     };
     extern INTEGRATION_METHOD INTMETHOD_NLO;
 
+    // Tabulate the NLO kernels K2 and Kf once per solve on a fixed mesh
+    // in (ln z, theta_z, ln z', theta_z') for each parent dipole, s.t.
+    // only the dipole products and the coupling are evaluated at each step
+    enum NLO_KERNEL_CACHE_MODE
+    {
+        KERNEL_CACHE_DISABLED,
+        KERNEL_CACHE_DOUBLE,
+        KERNEL_CACHE_FLOAT      // Halves the memory footprint of the cache
+    };
+    extern NLO_KERNEL_CACHE_MODE NLO_KERNEL_CACHE;
+    extern int NLO_KERNEL_CACHE_LNRPOINTS;      // Gauss-Legendre nodes in ln z and ln z' of the initial mesh
+    extern int NLO_KERNEL_CACHE_THETAPOINTS;    // Nodes in theta_z in [0,pi], theta_z' has twice as many in [0,2pi]
+    // The mesh is refined until the tabulated NLO term deviates from the direct integration by less than
+    // NLO_KERNEL_CACHE_ACCURACY (relative to the largest term) at NLO_KERNEL_CACHE_CHECKPOINTS parent dipoles,
+    // see BKSolver::BuildNLOKernelCache(). Stop if the cache would need more than NLO_KERNEL_CACHE_MAXMEMORY MB
+    extern double NLO_KERNEL_CACHE_ACCURACY;
+    extern int NLO_KERNEL_CACHE_CHECKPOINTS;
+    extern double NLO_KERNEL_CACHE_MAXMEMORY;
+
     extern bool ONLY_NLO;   // do not keep as^1 terms
 
     extern bool FORCE_POSITIVE_N;   // Force N(r)>=0
@@ -112,6 +131,10 @@ namespace config
     
     extern bool EULER_METHOD;    // Use Euler method instead of Runge Kutta, must be true if KINEMATICA_CONSTRAINT is used
 
+    // Number of concurrent solves with rapidity steps h, h/2 (, h/4) that are
+    // Richardson extrapolated to one solution, 0 or 1 disables. Requires EULER_METHOD.
+    extern int RICHARDSON_LEVELS;
+
     const bool LOG_INTERPOLATOR = true; // Flag to determine if interpolate the dipole in log(r), log(N) 
     
 }
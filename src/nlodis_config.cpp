@@ -11,14 +11,56 @@ namespace nlodis_config
 {
     int CUBA_MAXEVAL=1e6;
     double CUBA_EPSREL=0.01;
+    int CUBA_NVEC=1;
+    int CUBA_CUBATURE_MAXDIM=3;
+    std::string CUBA_CUBATURE_METHOD="cuhre";
+    double CUBA_CUBATURE_EPSREL=1e-4;
+    std::string CUBA_MC_METHOD="vegas";
+    int QMC_RANDOMIZATIONS=8;
+    bool VEGAS_WARM_GRIDS=false;
+    int VEGAS_GRID_EVALS=2000;
+    double VEGAS_GRID_QSQ_BIN=0.5;
+    double VEGAS_GRID_X_BIN=1.0;
+    int VEGAS_WARM_GRID_BINS=20000;
+    bool PERSISTENT_INTEGRATION_STATE=false;
+    int PERSISTENT_INTEGRATION_STATES=20000;
+    double INTEGRATION_ERROR_FRACTION=0;
+    double INTEGRATION_EPSREL_MIN=2e-3;
+    double INTEGRATION_EPSREL_MAX=5e-2;
+    bool INTEGRATION_ERRORS_IN_CHISQR=false;
     bool VERBOSE = false;
     bool PRINTDATA = false;
 
     double MAXR=50;
     double MINR=1e-6;
 
+    bool FAST_DIPOLE_EVALUATOR = false;
+    int DIPOLE_EVALUATOR_RPOINTS = 1000;
+    double DIPOLE_EVALUATOR_YSTEP = 0.05;
+
     bool USE_MASSES = false;
 
+    bool SPECIALIZED_INTEGRANDS = true;
+    bool FUSED_INTEGRANDS = true;
+    bool MULTIMASS_INTEGRANDS = true;
+    bool PHOTON_OVERLAP_TABLES = true;
+    bool DIPOLE_LOOP_KERNELS = true;
+    bool DIPOLE_LOOP_KERNELS_MASSIVE = false;
+    int DIPOLE_LOOP_KERNEL_CACHE = 1000;
+    bool QG_VARIABLE_MAPS = true;
+    int QG_PILOT_EVALS = 2000;
+    double QG_TAIL_FRACTION = 0.1;
+    bool QG_CONTROL_VARIATE = false;
+    int QG_CONTROL_VARIATE_Z1_POINTS = 16;
+    double QG_CONTROL_VARIATE_MAX_VARIANCE_RATIO = 0.25;
+    int QG_NESTED_PHI_POINTS = 0;
+    int QG_NESTED_Z1_POINTS = 0;
+
+    bool MASS_TABLE = false;
+    int MASS_TABLE_POINTS = 5;
+    double MASS_TABLE_HALFWIDTH = 0.1;
+    bool MASSIVE_DIP_TABLES = true;
+    BesselImplementation BESSEL_IMPL = nlodis_config::BESSEL_GSL;
     PerfScheme PERF_MODE = nlodis_config::DISABLED;
     RunningCouplingDIS RC_DIS;
     SubtractionScheme SUB_SCHEME;
@@ -8,11 +8,43 @@
 #ifndef _NLODIS_CONFIG_HPP
 #define _NLODIS_CONFIG_HPP
 
+#include <string>
 
 namespace nlodis_config
 {
     extern int      CUBA_MAXEVAL;
     extern double   CUBA_EPSREL;
+    extern int      CUBA_NVEC;      // Points per integrand call, >1 evaluates the integrands in batches
+    // Integrators of the Cuba method "auto": deterministic cubature with CUBA_CUBATURE_EPSREL
+    // up to CUBA_CUBATURE_MAXDIM dimensions, CUBA_MC_METHOD with CUBA_EPSREL above
+    extern int          CUBA_CUBATURE_MAXDIM;
+    extern std::string  CUBA_CUBATURE_METHOD;
+    extern double       CUBA_CUBATURE_EPSREL;
+    extern std::string  CUBA_MC_METHOD;
+    extern int      QMC_RANDOMIZATIONS; // Independent randomizations of the "qmc" method, see qmc.hpp
+    // Integrate with Vegas or Suave in the variables of an importance grid trained with VEGAS_GRID_EVALS
+    // points per iteration and started from the grid of the nearest (ln Q^2, ln x) bin of an earlier
+    // generation, see vegasgrid.hpp. The results then depend on the earlier chi^2 evaluations.
+    extern bool     VEGAS_WARM_GRIDS;
+    extern int      VEGAS_GRID_EVALS;
+    extern double   VEGAS_GRID_QSQ_BIN;     // Bin widths in ln Q^2 and ln x
+    extern double   VEGAS_GRID_X_BIN;
+    extern int      VEGAS_WARM_GRID_BINS;   // Bins kept, the oldest generations are dropped
+    // Reuse the grid of exactly the same term, scheme and kinematics without training within a
+    // chi^2 evaluation; the fit resets them at every evaluation. At most
+    // PERSISTENT_INTEGRATION_STATES grids are kept, the least recently used are dropped.
+    extern bool     PERSISTENT_INTEGRATION_STATE;
+    extern int      PERSISTENT_INTEGRATION_STATES;
+    // Integration tolerance of each kinematic point in a fit: INTEGRATION_ERROR_FRACTION times the
+    // smallest relative data error of its data points, limited to [INTEGRATION_EPSREL_MIN,
+    // INTEGRATION_EPSREL_MAX]. 0: CUBA_EPSREL and the term policies at every point.
+    extern double   INTEGRATION_ERROR_FRACTION;
+    extern double   INTEGRATION_EPSREL_MIN;
+    extern double   INTEGRATION_EPSREL_MAX;
+    // Add the integration error budget of each point, its tolerance times the theory, to the data
+    // errors of chi^2 in quadrature. The measured integration errors are not used: they are random,
+    // and a noisier integration would lower chi^2.
+    extern bool     INTEGRATION_ERRORS_IN_CHISQR;
     extern bool     VERBOSE;
     extern bool     PRINTDATA;
     extern bool     USE_MASSES;
@@ -20,10 +52,69 @@ namespace nlodis_config
     extern double MAXR;
     extern double MINR;
 
+    // Evaluate the dipole from a uniform (ln r, ln 1/x) table instead of the solver grid
+    extern bool FAST_DIPOLE_EVALUATOR;
+    extern int DIPOLE_EVALUATOR_RPOINTS;    // Table points in ln r between MINR and MAXR
+    extern double DIPOLE_EVALUATOR_YSTEP;   // Table step in ln 1/x
+
+    // Use the qg integrands compiled for the scheme choices below instead of the method pointer dispatch
+    extern bool SPECIALIZED_INTEGRANDS;
+    // Integrate the L and T structure functions of SigmarNLOunsub together as components of one Cuba call
+    extern bool FUSED_INTEGRANDS;
+    // Integrate the massive terms of several quark masses (flavours) together over shared samples
+    extern bool MULTIMASS_INTEGRANDS;
+    // Integrate the LO and IC structure functions as 1D dipole size integrals over the tabulated
+    // z1-integrated photon wavefunction overlaps, see photonoverlap.hpp
+    extern bool PHOTON_OVERLAP_TABLES;
+    // Integrate the dipole-loop terms as 1D dipole size integrals over wavefunction kernels
+    // computed once per (Q, mf), see dipoleloopkernel.hpp. The massive kernels take 1-2 minutes
+    // per (Q, mf) to build and are used only with DIPOLE_LOOP_KERNELS_MASSIVE. At most
+    // DIPOLE_LOOP_KERNEL_CACHE kernels are kept, the oldest ones are dropped.
+    extern bool DIPOLE_LOOP_KERNELS;
+    extern bool DIPOLE_LOOP_KERNELS_MASSIVE;
+    extern int DIPOLE_LOOP_KERNEL_CACHE;
+    // Choose the z2 and dipole size variables of the massless qg integrands per (term, Q, z2min)
+    // from QG_PILOT_EVALS uniform samples, again at every chi^2 evaluation. The dipole sizes are cut where the pilot estimates
+    // the tail to be less than QG_TAIL_FRACTION*CUBA_EPSREL of the integral.
+    extern bool QG_VARIABLE_MAPS;
+    extern int QG_PILOT_EVALS;
+    extern double QG_TAIL_FRACTION;
+    // Integrate the unsub qg terms with the z2->0 subtraction term of SUB_TERM_KERNEL as a
+    // control variate on the same samples, its integral is added back from a separate 4D
+    // integration with z1 integrated by a QG_CONTROL_VARIATE_Z1_POINTS point rule. Used where the
+    // pilot variance ratio Var(f - c g)/Var(f) is below QG_CONTROL_VARIATE_MAX_VARIANCE_RATIO in
+    // every component, the direct integration otherwise. Each remainder sample costs both f and g.
+    extern bool QG_CONTROL_VARIATE;
+    extern int QG_CONTROL_VARIATE_Z1_POINTS;
+    extern double QG_CONTROL_VARIATE_MAX_VARIANCE_RATIO;
+    // Integrate the azimuthal angle of the massless qg integrands with a QG_NESTED_PHI_POINTS point
+    // Gauss-Legendre rule inside each Monte Carlo sample, and z1 of the unsub terms with a
+    // QG_NESTED_Z1_POINTS point rule, so that Cuba samples 4 or 3 dimensions. 0: the variable is sampled.
+    extern int QG_NESTED_PHI_POINTS;
+    extern int QG_NESTED_Z1_POINTS;
+
+    // Interpolate the charm contribution in the fit from a quark mass table, which is reused
+    // while only mass_charm changes between the chi^2 evaluations
+    extern bool MASS_TABLE;
+    extern int MASS_TABLE_POINTS;           // Masses in the table, an odd number includes the current mass
+    extern double MASS_TABLE_HALFWIDTH;     // Table range around the current mass (GeV)
+
+    // Evaluate the dilogarithm and logarithm terms of the massive dipole terms from
+    // (z, mf^2/Q^2) tables, see massivetables.hpp
+    extern bool MASSIVE_DIP_TABLES;
+
+    enum BesselImplementation
+    {
+        BESSEL_GSL,     // gsl_sf_bessel_K0/K1/Kn
+        BESSEL_FAST     // In-tree approximations, see bessel.hpp
+    };
+    extern BesselImplementation BESSEL_IMPL;
+
     enum PerfScheme
     {
         DISABLED,
-        MASSIVE_EXPLICIT_BESSEL_DIM_REDUCTION
+        MASSIVE_EXPLICIT_BESSEL_DIM_REDUCTION,
+        MASSIVE_TABULATED_G     // As above, with the y_t integrals of G^(a;b) from tables, see massivetables.hpp
     };
     extern PerfScheme PERF_MODE;
 
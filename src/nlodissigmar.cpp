@@ -4,6 +4,9 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <map>
+#include <utility>
+#include <random>
 //#include <chrono>
 #include <gsl/gsl_sys.h>
 #include <gsl/gsl_math.h>
@@ -16,6 +19,12 @@
 #include "nlodis_config.hpp"
 #include "nlodissigmar.hpp"
 #include "nlodissigmar_massiveq.hpp"
+#include "bessel.hpp"
+#include "massivetables.hpp"
+#include "photonoverlap.hpp"
+#include "dipoleloopkernel.hpp"
+#include "quadrature.hpp"
+#include "qmc.hpp"
 #include "helper.hpp"
 
 
@@ -36,14 +45,20 @@ using namespace sigmar_config;
 
 // at low Q² Z exchange negligible ( we are only modeling gamma exchange) and the reduced cross section simplifies into
 // sigma_r = F_2 - f(y) F_L = F_2 - y^2 / Y_+ * F_L = F_2 - y^2/(1+(1-y)^2) * F_L
-double ComputeSigmaR::SigmarLO (double Q , double xbj, double y) {
-    double FL = Structf_LLO(Q,xbj);
-    double FT = Structf_TLO(Q,xbj);
+double ComputeSigmaR::SigmarFromStructf (const double F[2], double y) {
+    double FL = F[0];
+    double FT = F[1];
     double F2 = FL+FT;
     double fy = Sq(y)/(1+Sq(1-y));
     double sigmar = F2 - fy*FL;
     return sigmar;
 }
+
+double ComputeSigmaR::SigmarLO (double Q , double xbj, double y) {
+    double F[2];
+    Structf_LO(Q, xbj, F);
+    return SigmarFromStructf(F, y);
+}
 double ComputeSigmaR::SigmarLOmass (double Q , double xbj, double y, bool charm) {
     double fac = structurefunfac*Sq(Q);
     double FL = fac*LLOpMass(Q,xbj,charm);
@@ -56,107 +71,139 @@ double ComputeSigmaR::SigmarLOmass (double Q , double xbj, double y, bool charm)
 
 // UNSUB ---------------------
 double ComputeSigmaR::SigmarNLOunsub ( double Q , double xbj, double y) {
-    double FLic  = Structf_LLO(Q,icX0);
-    double FTic  = Structf_TLO(Q,icX0);
-    double FLdip = Structf_LNLOdip(Q,xbj);
-    double FTdip = Structf_TNLOdip(Q,xbj);
-    double FLqg  = Structf_LNLOqg_unsub(Q,xbj);
-    double FTqg  = Structf_TNLOqg_unsub(Q,xbj);
-    double FL = FLic + FLdip + FLqg;
-    double FT = FTic + FTdip + FTqg;
-    double F2 = FL+FT;
-    double fy = Sq(y)/(1+Sq(1-y));
-    double sigma = F2 - fy*FL;
+    double F[2];
+    Structf_NLOunsub(Q, xbj, F);
     // Printing intermediate F2 FL FT
     // cout << "SigmarNLOunsub(Q xbj y) sigmar F2 FL FT "  << Q << " "
     //                                                     << xbj << " "
     //                                                     << y << " "
-    //                                                     << sigma << " "
-    //                                                     << F2 << " "
-    //                                                     << FL << " "
-    //                                                     << FT << endl;
-    return sigma;
+    //                                                     << SigmarFromStructf(F, y) << " "
+    //                                                     << F[0]+F[1] << " "
+    //                                                     << F[0] << " "
+    //                                                     << F[1] << endl;
+    return SigmarFromStructf(F, y);
 }
 
 double ComputeSigmaR::SigmarNLOunsub_massive ( double Q , double xbj, double y, double q_mass) {
-    double FLic  = Structf_LLO_massive(Q, icX0, q_mass);
-    double FTic  = Structf_TLO_massive(Q, icX0, q_mass);
+    double F[2];
+    Structf_NLOunsub_massive(Q, xbj, q_mass, F);
+    return SigmarFromStructf(F, y);
+}
+
+double ComputeSigmaR::SigmarNLOunsub_UniformZ2Bound ( double Q , double xbj, double y) {
+    double F[2];
+    Structf_NLOunsub_UniformZ2Bound(Q, xbj, F);
+    return SigmarFromStructf(F, y);
+}
+
+double ComputeSigmaR::SigmarNLOunsub_sigma3 ( double Q , double xbj, double y) {
+    double F[2];
+    Structf_NLOunsub_sigma3(Q, xbj, F);
+    return SigmarFromStructf(F, y);
+}
+
+
+// SUB ---------------------
+double ComputeSigmaR::SigmarNLOsub ( double Q , double xbj, double y) {
+    double F[2];
+    Structf_NLOsub(Q, xbj, F);
+    return SigmarFromStructf(F, y);
+}
+
+double ComputeSigmaR::SigmarNLOsub_UniformZ2Bound ( double Q , double xbj, double y) {
+    double F[2];
+    Structf_NLOsub_UniformZ2Bound(Q, xbj, F);
+    return SigmarFromStructf(F, y);
+}
+
+// Structure functions F = {FL, FT} of the above -------------------------
+void ComputeSigmaR::Structf_LO ( double Q , double xbj, double F[2] ) {
+    F[0] = Structf_LLO(Q,xbj);
+    F[1] = Structf_TLO(Q,xbj);
+}
+
+void ComputeSigmaR::Structf_IC ( double Q , double F[2], double q_mass ) {
+    if (q_mass > 0){
+        F[0] = Structf_LLO_massive(Q, icX0, q_mass);
+        F[1] = Structf_TLO_massive(Q, icX0, q_mass);
+    } else {
+        F[0] = Structf_LLO(Q,icX0);
+        F[1] = Structf_TLO(Q,icX0);
+    }
+}
+
+void ComputeSigmaR::Structf_NLOunsub ( double Q , double xbj, double F[2], const double* Fic ) {
+    double FLic, FTic, FLdip, FTdip, FLqg, FTqg;
+    if (nlodis_config::FUSED_INTEGRANDS){
+        // The IC term is a component of the dipole term integration
+        double Ficdip[4], Fqg[2];
+        Structf_LTICdip(Q, xbj, Ficdip);
+        Structf_LTNLOqg_unsub(Q, xbj, Fqg);
+        FLic  = Ficdip[0];
+        FTic  = Ficdip[1];
+        FLdip = Ficdip[2];
+        FTdip = Ficdip[3];
+        FLqg  = Fqg[0];
+        FTqg  = Fqg[1];
+    } else {
+        FLic  = Fic ? Fic[0] : Structf_LLO(Q,icX0);
+        FTic  = Fic ? Fic[1] : Structf_TLO(Q,icX0);
+        FLdip = Structf_LNLOdip(Q,xbj);
+        FTdip = Structf_TNLOdip(Q,xbj);
+        FLqg  = Structf_LNLOqg_unsub(Q,xbj);
+        FTqg  = Structf_TNLOqg_unsub(Q,xbj);
+    }
+    F[0] = FLic + FLdip + FLqg;
+    F[1] = FTic + FTdip + FTqg;
+}
+
+void ComputeSigmaR::Structf_NLOunsub_massive ( double Q , double xbj, double q_mass, double F[2], const double* Fic ) {
+    double FLic  = Fic ? Fic[0] : Structf_LLO_massive(Q, icX0, q_mass);
+    double FTic  = Fic ? Fic[1] : Structf_TLO_massive(Q, icX0, q_mass);
     double FLdip = Structf_LNLOdip_massive(Q, xbj, q_mass);
     double FTdip = Structf_TNLOdip_massive(Q, xbj, q_mass);
     double FLqg  = Structf_LNLOqg_unsub_massive(Q, xbj, q_mass);
     double FTqg  = Structf_TNLOqg_unsub_massive(Q, xbj, q_mass);
-    double FL = FLic + FLdip + FLqg;
-    double FT = FTic + FTdip + FTqg;
-    double F2 = FL+FT;
-    double fy = Sq(y)/(1+Sq(1-y));
-    double sigma = F2 - fy*FL;
-
-    // Printing intermediate F2 FL FT
-    // cout << "SigmarNLOunsub_massive(Q xbj y mf) sigmar F2 FL FT "  << Q << " "
-    //                                                                 << xbj << " "
-    //                                                                 << y << " "
-    //                                                                 << q_mass << " "
-    //                                                                 << sigma << " "
-    //                                                                 << F2 << " "
-    //                                                                 << FL << " "
-    //                                                                 << FT << endl;
-    return sigma;
+    F[0] = FLic + FLdip + FLqg;
+    F[1] = FTic + FTdip + FTqg;
 }
 
-double ComputeSigmaR::SigmarNLOunsub_UniformZ2Bound ( double Q , double xbj, double y) {
-    double FLic  = Structf_LLO(Q,icX0);
-    double FTic  = Structf_TLO(Q,icX0);
+void ComputeSigmaR::Structf_NLOunsub_UniformZ2Bound ( double Q , double xbj, double F[2], const double* Fic ) {
+    double FLic  = Fic ? Fic[0] : Structf_LLO(Q,icX0);
+    double FTic  = Fic ? Fic[1] : Structf_TLO(Q,icX0);
     double FLdip = Structf_LNLOdip_z2(Q,xbj);
     double FTdip = Structf_TNLOdip_z2(Q,xbj);
     double FLqg  = Structf_LNLOqg_unsub(Q,xbj);
     double FTqg  = Structf_TNLOqg_unsub(Q,xbj);
-    double FL = FLic + FLdip + FLqg;
-    double FT = FTic + FTdip + FTqg;
-    double F2 = FL+FT;
-    double fy = Sq(y)/(1+Sq(1-y));
-    double sigma = F2 - fy*FL;
-    return sigma;
+    F[0] = FLic + FLdip + FLqg;
+    F[1] = FTic + FTdip + FTqg;
 }
 
-double ComputeSigmaR::SigmarNLOunsub_sigma3 ( double Q , double xbj, double y) {
-    double FL3  = Structf_LNLOsigma3(Q,xbj);
-    double FT3  = Structf_TNLOsigma3(Q,xbj);
-    double F2 = FL3+FT3;
-    double fy = Sq(y)/(1+Sq(1-y));
-    double sigma = F2 - fy*FL3;
-    return sigma;
+void ComputeSigmaR::Structf_NLOunsub_sigma3 ( double Q , double xbj, double F[2] ) {
+    F[0] = Structf_LNLOsigma3(Q,xbj);
+    F[1] = Structf_TNLOsigma3(Q,xbj);
 }
 
-
-// SUB ---------------------
-double ComputeSigmaR::SigmarNLOsub ( double Q , double xbj, double y) {
+void ComputeSigmaR::Structf_NLOsub ( double Q , double xbj, double F[2] ) {
     double FLlo  = Structf_LLO(Q,xbj);
     double FTlo  = Structf_TLO(Q,xbj);
     double FLdip = Structf_LNLOdip(Q,xbj);
     double FTdip = Structf_TNLOdip(Q,xbj);
     double FLqg  = Structf_LNLOqg_sub(Q,xbj);
     double FTqg  = Structf_TNLOqg_sub(Q,xbj);
-    double FL = FLlo + FLdip + FLqg;
-    double FT = FTlo + FTdip + FTqg;
-    double F2 = FL+FT;
-    double fy = Sq(y)/(1+Sq(1-y));
-    double sigma = F2 - fy*FL;
-    return sigma;
+    F[0] = FLlo + FLdip + FLqg;
+    F[1] = FTlo + FTdip + FTqg;
 }
 
-double ComputeSigmaR::SigmarNLOsub_UniformZ2Bound ( double Q , double xbj, double y) {
+void ComputeSigmaR::Structf_NLOsub_UniformZ2Bound ( double Q , double xbj, double F[2] ) {
     double FLlo  = Structf_LLO(Q,xbj);
     double FTlo  = Structf_TLO(Q,xbj);
     double FLdip = Structf_LNLOdip_z2(Q,xbj);
     double FTdip = Structf_TNLOdip_z2(Q,xbj);
     double FLqg  = Structf_LNLOqg_sub(Q,xbj);
     double FTqg  = Structf_TNLOqg_sub(Q,xbj);
-    double FL = FLlo + FLdip + FLqg;
-    double FT = FTlo + FTdip + FTqg;
-    double F2 = FL+FT;
-    double fy = Sq(y)/(1+Sq(1-y));
-    double sigma = F2 - fy*FL;
-    return sigma;
+    F[0] = FLlo + FLdip + FLqg;
+    F[1] = FTlo + FTdip + FTqg;
 }
 
 // RISTO formulations ---------------------
@@ -297,6 +344,20 @@ double ComputeSigmaR::Structf_TNLOqg_unsub ( double Q , double xbj ) {
     return FT;
 }
 
+void ComputeSigmaR::Structf_LTNLOqg_unsub ( double Q , double xbj, double F[2] ) {
+    double fac = structurefunfac*Sq(Q);
+    LTNLOqgunsub( Q , xbj , F );
+    F[0] *= fac;
+    F[1] *= fac;
+}
+
+void ComputeSigmaR::Structf_LTICdip ( double Q , double xbj, double F[4] ) {
+    double fac = structurefunfac*Sq(Q);
+    LTICdip( Q , xbj , F );
+    for (int i=0; i<4; i++)
+        F[i] *= fac;
+}
+
 double ComputeSigmaR::Structf_TNLOqg_unsub_massive ( double Q , double xbj, double m_f ) {
     double fac = structurefunfac*Sq(Q);
     double sig_I1 = TNLOqgunsub_massive_I1(Q, xbj, m_f);
@@ -385,6 +446,15 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
     bool useMasses = nlodis_config::USE_MASSES;
     bool useCharm = false;
 
+    // Quark flavours of the mass scheme
+    bool withLight = !useMasses || nlodis_config::MASS_SCHEME == nlodis_config::LIGHT_PLUS_CHARM
+        || nlodis_config::MASS_SCHEME == nlodis_config::LIGHT_PLUS_CHARM_AND_BEAUTY;
+    bool withCharm = useMasses && (nlodis_config::MASS_SCHEME == nlodis_config::CHARM_ONLY
+        || nlodis_config::MASS_SCHEME == nlodis_config::LIGHT_PLUS_CHARM
+        || nlodis_config::MASS_SCHEME == nlodis_config::LIGHT_PLUS_CHARM_AND_BEAUTY);
+    bool withBottom = useMasses && (nlodis_config::MASS_SCHEME == nlodis_config::BEAUTY_ONLY
+        || nlodis_config::MASS_SCHEME == nlodis_config::LIGHT_PLUS_CHARM_AND_BEAUTY);
+
 
     if (std::abs(initialconditionY0) > 1e-4)
     {
@@ -396,6 +466,17 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
     return 9999999;
 
     cout << "=== Initializing Chi^2 regression === "<< " parameters (" << PrintVector(par) << ")" << endl;
+
+    /*
+     * Charm mass table: while only mass_charm changes between the evaluations (Minuit
+     * derivatives in mass_charm, mass scans), the dipole and the light and bottom
+     * structure functions are unchanged. They are kept from the evaluation that built
+     * the table, and the charm contribution is interpolated in the mass.
+     */
+    bool massTable = nlodis_config::MASS_TABLE && computeNLO && !UseSub && useMasses && withCharm;
+    std::vector<double> tablepar(par);
+    tablepar[ parameters.Index("mass_charm")] = 0;
+    bool tableHit = massTable && tablepar == masstable_par && masstable.InRange(mass_charm);
     // Manual limiting for parameter range as a fail safe for Minuit2 craziness:
     /*
     if (  (qs0sqr < 0)    || (alphas_scaling < 0)     || (anomalous_dimension < 0) || (e_c < 0.4) || (initialconditionX0 < 0.01) ||
@@ -436,7 +517,8 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
     tmpoutput += std::to_string(qs0sqr);
     tmpoutput += ".dat";
     /// solver.SetTmpOutput(tmpoutput);
-    solver.Solve(maxy);
+    if (!tableHit)
+        solver.Solve(maxy);
 
     // solver.GetDipole()->Save("output_dipole_uksi_balsd_heraII.dat");
     // solver.GetDipole()->Save("output_dipole_urpbsi_hera_resumpd_ic_nlobk.dat");
@@ -447,17 +529,20 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
     // AmplitudeLib DipoleAmplitude(*DipoleAmplitude_ptr);
 
     
-    // Give solution to the AmplitudeLib object
-    AmplitudeLib DipoleAmplitude(solver.GetDipole()->GetData(), solver.GetDipole()->GetYvals(), solver.GetDipole()->GetRvals());
-    DipoleAmplitude.SetInterpolationMethod(LINEAR_LINEAR);
+    // Evaluate the solution directly from the solver's Dipole, linear interpolation in r and y as with AmplitudeLib LINEAR_LINEAR
+    DipoleAmplitudeView DipoleAmplitude(*solver.GetDipole());
     DipoleAmplitude.SetX0(icx0_bk);
-    DipoleAmplitude.SetOutOfRangeErrors(false);
-    AmplitudeLib *DipolePointer = &DipoleAmplitude;
 
-    ComputeSigmaR SigmaComputer(DipolePointer);
+    ComputeSigmaR SigmaComputer(&DipoleAmplitude);
     SigmaComputer.SetX0(icx0_nlo_impfac);
     SigmaComputer.SetX0_BK(icx0_bk);
     SigmaComputer.SetY0(initialconditionY0);
+    DipoleEvaluator FastDipole;
+    if (nlodis_config::FAST_DIPOLE_EVALUATOR && !tableHit)
+    {
+        FastDipole.Build(DipoleAmplitude, icx0_bk, initialconditionY0, maxy);
+        SigmaComputer.SetDipoleEvaluator(&FastDipole);
+    }
     SigmaComputer.SetQ0Sqr(icTypicalPartonVirtualityQ0sqr);
     SigmaComputer.SetQuarkMassLight(qMass_light);
     SigmaComputer.SetQuarkMassCharm(qMass_charm);
@@ -468,9 +553,18 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
 
     // CUBA Monte Carlo integration library algorithm setter
     SigmaComputer.SetCubaMethod(cubaMethod);
+    for (std::map<string, IntegratorPolicy>::const_iterator it = termPolicies.begin(); it != termPolicies.end(); ++it)
+        SigmaComputer.SetTermPolicy(it->first, it->second);
 
     cout << "=== Computing Reduced Cross sections ===" << endl;
 
+    // The Vegas grids of the earlier evaluations seed this one, but their persistent states
+    // do not carry over, see vegasgrid.hpp
+    NextVegasGridGeneration();
+    ResetPersistentVegasGrids();
+    // The qg variable maps were chosen with the dipole of the previous parameters
+    ComputeSigmaR::ResetQGVariableMaps();
+
     /*
      * Loop over datapoints and compute theoretical predictions
      */
@@ -482,10 +576,231 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
     std::vector<double> datavals(totalpoints);
     std::vector<double> dataerrs(totalpoints);
     std::vector<double> thdata(totalpoints);  
+    std::vector<double> therrs(totalpoints, 0);     // Integration errors of thdata
     std::vector<double> var_xbj(totalpoints);
     std::vector<double> var_y(totalpoints);
     std::vector<double> var_qsqr(totalpoints);
-    
+
+    if (computeNLO && useMasses && (UseSub || useBoundLoop))
+    {
+        if (UseSub)
+            cout << "SUB SCHEME NOT IMPLEMENTED WITH QUARK MASSES. EXIT." << endl;
+        else
+            cout << "Z_2 bound dipole term not implemented yet with quark masses. EXIT." << endl;
+        exit(1);
+    }
+
+    /*
+     * Kinematic index: the same (Q^2, x) appears at several sqrt(s) (y) and the
+     * data has many points per Q^2 bin. The structure functions F_L, F_T are
+     * computed once per unique (Q^2, x) and sigma_r is assembled per data point.
+     * The IC term of the unsub scheme depends only on Q^2 and is computed once
+     * per unique Q^2, unless it comes from the fused dipole term integration
+     * (the light quarks of Structf_NLOunsub with FUSED_INTEGRANDS).
+     * The massive LO cross section depends on the data point (charm only data)
+     * and is computed per point.
+     */
+    bool perpoint = !computeNLO && useMasses;
+    bool icPerQsqr = computeNLO && !UseSub
+        && (useMasses || useBoundLoop || !nlodis_config::FUSED_INTEGRANDS);
+    bool lightIcPerQsqr = icPerQsqr && !(useMasses && nlodis_config::FUSED_INTEGRANDS);
+    std::vector<int> kinematics(totalpoints);   // Index of the data point in kin_qsqr, kin_xbj
+    std::vector<int> kin_icindex;               // Index of the kinematics in ic_qsqr
+    std::vector<double> kin_qsqr, kin_xbj, ic_qsqr;
+    {
+        std::map< std::pair<double, double>, int> kinindex;
+        std::map<double, int> icindex;
+        int dataind=0;
+        for (unsigned int dataset=0; dataset<datasets.size(); dataset++)
+        {
+            for (int i=0; i<datasets[dataset]->NumOfPoints(); i++, dataind++)
+            {
+                double Q2 = datasets[dataset]->Qsqr(i);
+                double xbj = datasets[dataset]->xbj(i);
+                std::pair<double, double> key(Q2, xbj);
+                if (kinindex.count(key) == 0)
+                {
+                    if (icindex.count(Q2) == 0)
+                    {
+                        icindex[Q2] = ic_qsqr.size();
+                        ic_qsqr.push_back(Q2);
+                    }
+                    kinindex[key] = kin_qsqr.size();
+                    kin_qsqr.push_back(Q2);
+                    kin_xbj.push_back(xbj);
+                    kin_icindex.push_back(icindex[Q2]);
+                }
+                kinematics[dataind] = kinindex[key];
+            }
+        }
+    }
+
+    /*
+     * Integration error budget: the terms of a kinematic point are integrated to the
+     * relative tolerance INTEGRATION_ERROR_FRACTION times the smallest relative error of
+     * its data points (the IC term to the smallest at its Q^2), so that the precise points
+     * are not integrated as loosely as the imprecise ones. The integration errors of F
+     * are kept to be propagated to sigma_r and chi^2.
+     */
+    std::vector<double> kin_epsrel(kin_qsqr.size(), 0), ic_epsrel(ic_qsqr.size(), 0);
+    if (nlodis_config::INTEGRATION_ERROR_FRACTION > 0)
+    {
+        int dataind=0;
+        for (unsigned int dataset=0; dataset<datasets.size(); dataset++)
+        {
+            for (int i=0; i<datasets[dataset]->NumOfPoints(); i++, dataind++)
+            {
+                double relerr = datasets[dataset]->ReducedCrossSectionError(i)
+                    / std::abs(datasets[dataset]->ReducedCrossSection(i));
+                double epsrel = std::min(std::max(nlodis_config::INTEGRATION_ERROR_FRACTION*relerr,
+                    nlodis_config::INTEGRATION_EPSREL_MIN), nlodis_config::INTEGRATION_EPSREL_MAX);
+                int k = kinematics[dataind];
+                if (kin_epsrel[k] == 0 || epsrel < kin_epsrel[k])
+                    kin_epsrel[k] = epsrel;
+                if (ic_epsrel[kin_icindex[k]] == 0 || epsrel < ic_epsrel[kin_icindex[k]])
+                    ic_epsrel[kin_icindex[k]] = epsrel;
+            }
+        }
+    }
+
+    // IC term F = {FL, FT} of the quark flavours per Q^2
+    enum { IC_LIGHT=0, IC_CHARM=1, IC_BOTTOM=2, IC_FLAVOURS=3 };
+    std::vector<double> icstructf(2*IC_FLAVOURS*ic_qsqr.size(), 0);
+    std::vector<double> icstructf_err(2*ic_qsqr.size(), 0);    // {dFL, dFT} of all flavours
+    if (icPerQsqr && !tableHit)
+    {
+#ifdef PARALLEL_CHISQR
+    #pragma omp parallel for schedule(dynamic)
+#endif
+        for (int k=0; k<(int)ic_qsqr.size(); k++)
+        {
+            double Q = sqrt(ic_qsqr[k]);
+            double* ic = &icstructf[2*IC_FLAVOURS*k];
+            ComputeSigmaR::SetPointEpsrel(ic_epsrel[k]);
+            ComputeSigmaR::ResetIntegrationErrors();
+            if (withLight && lightIcPerQsqr)
+                SigmaComputer.Structf_IC(Q, ic + 2*IC_LIGHT);
+            if (withCharm && !massTable)
+                SigmaComputer.Structf_IC(Q, ic + 2*IC_CHARM, qMass_charm);
+            if (withBottom)
+                SigmaComputer.Structf_IC(Q, ic + 2*IC_BOTTOM, qMass_b_var);
+            ComputeSigmaR::IntegrationErrors(&icstructf_err[2*k]);
+            ComputeSigmaR::SetPointEpsrel(0);
+        }
+    }
+
+    // F = {FL, FT} per unique (Q^2, x) and their integration errors
+    std::vector<double> structf(2*kin_qsqr.size(), 0);
+    std::vector<double> structf_err(2*kin_qsqr.size(), 0);
+    int kinpoints = (perpoint || tableHit) ? 0 : kin_qsqr.size();
+    int kindone = 0;
+#ifdef PARALLEL_CHISQR
+    #pragma omp parallel for schedule(dynamic)
+#endif
+    for (int k=0; k<kinpoints; k++)
+    {
+        // Progress indication during fitting.
+        #pragma omp critical
+        cout << "\r" << ++kindone << "/" << kinpoints << flush;
+
+        double Q = sqrt(kin_qsqr[k]);
+        double xbj = kin_xbj[k];
+        double* F = &structf[2*k];
+        const double* ic = icPerQsqr ? &icstructf[2*IC_FLAVOURS*kin_icindex[k]] : NULL;
+        double Fterm[2];
+        ComputeSigmaR::SetPointEpsrel(kin_epsrel[k]);
+        ComputeSigmaR::ResetIntegrationErrors();
+
+        if (!computeNLO) // Compute reduced cross section using leading order impact factors
+        {
+            SigmaComputer.Structf_LO(Q, xbj, F);
+        }
+        else if (!UseSub) // UNSUB SCHEME Full NLO impact factors for reduced cross section
+        {
+            if (useMasses){ // no z2 lower bound in dipole loop term.
+                if (withLight){
+                    SigmaComputer.Structf_NLOunsub(Q, xbj, Fterm, lightIcPerQsqr ? ic + 2*IC_LIGHT : NULL);
+                    F[0] += Fterm[0]; F[1] += Fterm[1];
+                }
+                // Heavy flavours, charm comes from the mass table if it is used
+                std::vector<double> heavy;
+                std::vector<int> heavyic;
+                if (withCharm && !massTable){
+                    heavy.push_back(qMass_charm);
+                    heavyic.push_back(IC_CHARM);
+                }
+                if (withBottom){
+                    heavy.push_back(qMass_b_var);
+                    heavyic.push_back(IC_BOTTOM);
+                }
+                if (nlodis_config::MULTIMASS_INTEGRANDS && !heavy.empty()){
+                    std::vector<double> FLq, FTq;
+                    SigmaComputer.Structf_massive_multimass(Q, xbj, heavy, FLq, FTq, true, false);
+                    for (size_t m=0; m<heavy.size(); m++){
+                        F[0] += FLq[m] + ic[2*heavyic[m]];
+                        F[1] += FTq[m] + ic[2*heavyic[m]+1];
+                    }
+                } else {
+                    for (size_t m=0; m<heavy.size(); m++){
+                        SigmaComputer.Structf_NLOunsub_massive(Q, xbj, heavy[m], Fterm, ic + 2*heavyic[m]);
+                        F[0] += Fterm[0]; F[1] += Fterm[1];
+                    }
+                }
+            } else {
+                if (useBoundLoop)
+                    SigmaComputer.Structf_NLOunsub_UniformZ2Bound(Q, xbj, F, ic + 2*IC_LIGHT);
+                else // the old way, no z2 lower bound in dipole loop term.
+                    SigmaComputer.Structf_NLOunsub(Q, xbj, F, ic ? ic + 2*IC_LIGHT : NULL);
+                if (UseSigma3){
+                    SigmaComputer.Structf_NLOunsub_sigma3(Q, xbj, Fterm);
+                    F[0] += Fterm[0]; F[1] += Fterm[1];
+                }
+            }
+        }
+        else // SUB SCHEME Full NLO impact factors for reduced cross section
+        {
+            if (useBoundLoop)
+                SigmaComputer.Structf_NLOsub_UniformZ2Bound(Q, xbj, F);
+            else // the old way, no z2 lower bound in dipole loop term.
+                SigmaComputer.Structf_NLOsub(Q, xbj, F);
+        }
+
+        double* Ferr = &structf_err[2*k];
+        ComputeSigmaR::IntegrationErrors(Ferr);
+        ComputeSigmaR::SetPointEpsrel(0);
+        if (icPerQsqr)
+        {
+            Ferr[0] = std::hypot(Ferr[0], icstructf_err[2*kin_icindex[k]]);
+            Ferr[1] = std::hypot(Ferr[1], icstructf_err[2*kin_icindex[k]+1]);
+        }
+    }
+
+    if (massTable)
+    {
+        if (tableHit)
+        {
+            structf = masstable_structf;
+            structf_err = masstable_structf_err;
+        }
+        else
+        {
+            masstable.Build(SigmaComputer, kin_qsqr, kin_xbj, qMass_charm,
+                nlodis_config::MASS_TABLE_HALFWIDTH, nlodis_config::MASS_TABLE_POINTS);
+            masstable_par = tablepar;
+            masstable_structf = structf;
+            masstable_structf_err = structf_err;
+        }
+        for (int k=0; k<(int)kin_qsqr.size(); k++)
+        {
+            double Fcharm[2];
+            masstable.Structf(k, qMass_charm, Fcharm);
+            structf[2*k] += Fcharm[0];
+            structf[2*k+1] += Fcharm[1];
+        }
+        cout << endl << "# Charm at m_c=" << qMass_charm << " from the mass table"
+            << (tableHit ? "" : " (rebuilt)") << endl;
+    }
+
     ///TODO: Does not yet fully support weight factors ,
     // after I have written a separate code that automatically finds optimal sigma02
 
@@ -500,10 +815,6 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
 #endif
         for (int i=0; i<datasets[dataset]->NumOfPoints(); i++)
         {
-            // Progress indication during fitting.
-            #pragma omp critical
-            cout << "\r" << i+1 << "/" << totalpoints << flush;
-
             // Index for this in the final data array
             int dataind=0;
             for (int dseti=0; dseti < dataset; dseti++)
@@ -526,14 +837,20 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
             var_qsqr[dataind] = Q2;
 
             double theory=0, theory_charm=0;
-            int calccount=0;
-            if (!computeNLO && !useMasses) // Compute reduced cross section using leading order impact factors
+            if (!perpoint)
             {
-                theory = (fitsigma0)*SigmaComputer.SigmarLO(Q , xbj , y );
-                ++calccount;
+                theory = (fitsigma0)*ComputeSigmaR::SigmarFromStructf(&structf[2*kinematics[dataind]], y);
+                // sigma_r = FT + (1-f(y)) FL
+                const double* Ferr = &structf_err[2*kinematics[dataind]];
+                double fy = Sq(y)/(1+Sq(1-y));
+                therrs[dataind] = (fitsigma0)*std::hypot((1-fy)*Ferr[0], Ferr[1]);
             }
-            if (!computeNLO && useMasses)
+            else
             {
+                // Progress indication during fitting.
+                #pragma omp critical
+                cout << "\r" << i+1 << "/" << totalpoints << flush;
+
                 theory=0;
                 if (datasets[dataset]->OnlyCharm(i)==false)
                 // if (true)
@@ -548,73 +865,10 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
                     else
                         theory = theory + theory_charm;
                 }
-                  ++calccount;
-            }
-            
-            if (computeNLO && !UseSub) // UNSUB SCHEME Full NLO impact factors for reduced cross section
-            {
-                if (useMasses){
-                    if (useBoundLoop){
-                        cout << "Z_2 bound dipole term not implemented yet with quark masses. EXIT." << endl;
-                        exit(1);
-                        // theory = (fitsigma0)*SigmaComputer.SigmarNLOunsub_UniformZ2Bound(Q , xbj , y );
-                        ++calccount;}
-                    if (!useBoundLoop){ // the old way, no z2 lower bound in dipole loop term.
-                        // cout << "This should be in use???" << "charm mass is: " << qMass_charm << endl;
-                        if (nlodis_config::MASS_SCHEME == nlodis_config::CHARM_ONLY){
-                            theory = (fitsigma0)*SigmaComputer.SigmarNLOunsub_massive(Q , xbj , y, qMass_charm );
-                        } else if (nlodis_config::MASS_SCHEME == nlodis_config::BEAUTY_ONLY){
-                            theory = (fitsigma0)*SigmaComputer.SigmarNLOunsub_massive(Q , xbj , y, qMass_b_var );
-                        } else if (nlodis_config::MASS_SCHEME == nlodis_config::LIGHT_PLUS_CHARM){
-                            theory = (fitsigma0)*SigmaComputer.SigmarNLOunsub(Q , xbj , y )
-                                     + (fitsigma0)*SigmaComputer.SigmarNLOunsub_massive(Q , xbj , y, qMass_charm );
-                        } else if (nlodis_config::MASS_SCHEME == nlodis_config::LIGHT_PLUS_CHARM_AND_BEAUTY){
-                            theory = (fitsigma0)*SigmaComputer.SigmarNLOunsub(Q , xbj , y )
-                                     + (fitsigma0)*SigmaComputer.SigmarNLOunsub_massive(Q , xbj , y, qMass_charm )
-                                     + (fitsigma0)*SigmaComputer.SigmarNLOunsub_massive(Q , xbj , y, qMass_b_var );
-                        }
-                        ++calccount;}
-                }
-                if (!useMasses){
-                    if (useBoundLoop){
-                        theory = (fitsigma0)*SigmaComputer.SigmarNLOunsub_UniformZ2Bound(Q , xbj , y );
-                        ++calccount;}
-                    if (!useBoundLoop){ // the old way, no z2 lower bound in dipole loop term.
-                        theory = (fitsigma0)*SigmaComputer.SigmarNLOunsub(Q , xbj , y );
-                        //theory = (fitsigma0)*SigmaComputer.SigmarNLOsubRisto(Q , xbj , y );
-                        ++calccount;}
-                    if (UseSigma3){
-                        theory += (fitsigma0)*SigmaComputer.SigmarNLOunsub_sigma3(Q , xbj , y );
-                        }
-                }
-            }
-            
-            if (computeNLO && UseSub) // SUB SCHEME Full NLO impact factors for reduced cross section
-            {
-                if (useMasses){
-                    cout << "SUB SCHEME NOT IMPLEMENTED WITH QUARK MASSES. EXIT." << endl;
-                    exit(1);
-                }
-                if (useBoundLoop){
-                    theory = (fitsigma0)*SigmaComputer.SigmarNLOsub_UniformZ2Bound(Q , xbj , y );
-                    ++calccount;}
-                if (!useBoundLoop){ // the old way, no z2 lower bound in dipole loop term.
-                    theory = (fitsigma0)*SigmaComputer.SigmarNLOsub(Q , xbj , y );
-                    //theory = (fitsigma0)*SigmaComputer.SigmarNLOsubRisto(Q , xbj , y );
-                    ++calccount;}
             }
             
             thdata[dataind] = theory;
 
-
-            if (calccount>1)
-            {
-              cerr << "ERROR: Multiple computations. abort." << "count="<< calccount << endl;
-              theory = 99999999;
-              thdata[dataind] = 99999999;
-              exit(1);
-            }
-
             if (std::isnan(theory) or std::isinf(theory))
             {
                 cerr << "Warning: theory result " << theory << " with parameters " << PrintVector(par) << endl;
@@ -626,12 +880,39 @@ double NLODISFitter::operator()(const std::vector<double>& par) const
         }
     }
     cout << endl;
+    if (!perpoint)
+        cout << "# Computed " << kin_qsqr.size() << " unique (Q^2, x) for " << totalpoints << " data points" << endl;
+
+    // Integration errors of the theory relative to the data errors. chi^2 gets the fixed error
+    // budget of each point instead, its tolerance times the theory, scaled with the sigma02 at
+    // which chi^2 is evaluated as the theory.
+    std::vector<double> chisqr_therrs;
+    if (nlodis_config::INTEGRATION_ERRORS_IN_CHISQR)
+    {
+        chisqr_therrs.resize(totalpoints);
+        for (int i=0; i<totalpoints; i++)
+        {
+            double epsrel = perpoint ? 0 : kin_epsrel[kinematics[i]];
+            chisqr_therrs[i] = (epsrel > 0 ? epsrel : nlodis_config::CUBA_EPSREL)*std::abs(thdata[i]);
+        }
+    }
+    double ratio_sum = 0, ratio_max = 0;
+    for (int i=0; i<totalpoints; i++)
+    {
+        double ratio = old_sigma02*therrs[i]/dataerrs[i];
+        ratio_sum += ratio;
+        ratio_max = std::max(ratio_max, ratio);
+    }
+    if (!perpoint)
+        cout << "# Integration error / data error at sigma02=" << old_sigma02 << ": mean " << ratio_sum/totalpoints << ", max " << ratio_max
+            << (nlodis_config::INTEGRATION_ERRORS_IN_CHISQR ? ", the error budgets are added to the data errors in chi^2" : "") << endl;
+
     // Minimize sigma02
-    std::vector<double> sigma02fit = FindOptimalSigma02(datavals,dataerrs, thdata);
+    std::vector<double> sigma02fit = FindOptimalSigma02(datavals, dataerrs, thdata, chisqr_therrs);
     double chisqr_over_n = sigma02fit[1];
     double sigma02 = sigma02fit[0];
     // comparing to old sigma02
-    double old_chisq_over_n = minimiser_helper_chisqr_vec(old_sigma02, datavals, dataerrs, thdata);
+    double old_chisq_over_n = minimiser_helper_chisqr_vec(old_sigma02, datavals, dataerrs, thdata, chisqr_therrs);
     // Output for plotting
     cout << " ## var_xbj, var_qsqr, var_y, sigmar, sigmar_err, sigma02xthdata " << endl;
     if(nlodis_config::PRINTDATA){
@@ -671,11 +952,19 @@ void NLODISFitter::AddDataset(Data& d)
     datasets.push_back(&d);
 }
 
+void NLODISFitter::SetTermPolicy(string term, IntegratorPolicy p) {
+    if (!ComputeSigmaR::IsPolicyTerm(term)) {
+        cerr << "Integrator policy for an unknown term " << term << ". Exit." << endl;
+        exit(1);
+    }
+    termPolicies[term] = p;
+}
+
 NLODISFitter::NLODISFitter(MnUserParameters parameters_)
 {
     parameters = parameters_;
     
-    cubaMethod = "suave";  // Default choise for Cuba
+    cubaMethod = "suave";  // Default choise for Cuba, "auto" chooses by dimension, see ComputeSigmaR::Policy
 }
 
 string PrintVector(vector<double> v)
@@ -699,28 +988,176 @@ namespace cuba_config{
     double epsabs=0;
 }
 
+// Evaluates a batch of points with a single point integrand
+struct BatchUserdata{
+    integrand_t integrand;
+    void* userdata;
+};
+
+int integrand_batch_adapter(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    BatchUserdata *dataptr = (BatchUserdata*)userdata;
+    for (int i=0; i<*nvec; i++)
+        dataptr->integrand(ndim, x + i*(*ndim), ncomp, f + i*(*ncomp), dataptr->userdata);
+    return 0;
+}
+
+// Evaluates the integrand in the variables of a VegasGrid
+struct VegasGridUserdata{
+    batch_integrand_t integrand;    // In the original variables
+    void* userdata;
+    VegasGrid grid;
+    bool train;                     // Accumulate the weights of the grid (serial training only)
+};
+
+static void VegasGridEvaluate(VegasGridUserdata* data, const int *ndim, const double u[], const int *ncomp,
+    double f[], int n, int core) {
+    static thread_local std::vector<double> x, jac;
+    static thread_local std::vector<int> bins;
+    x.resize(n*(*ndim));
+    bins.resize(n*(*ndim));
+    jac.resize(n);
+    for (int i=0; i<n; i++)
+        jac[i] = data->grid.Map(u + i*(*ndim), &x[i*(*ndim)], &bins[i*(*ndim)]);
+    data->integrand(ndim, &x[0], ncomp, f, data->userdata, &n, &core);
+    for (int i=0; i<n; i++){
+        double weight=0;
+        for (int c=0; c<*ncomp; c++){
+            f[i*(*ncomp)+c] *= jac[i];
+            weight += Sq(f[i*(*ncomp)+c]);
+        }
+        if (data->train && gsl_finite(weight)==1)
+            data->grid.Accumulate(&bins[i*(*ndim)], weight);
+    }
+}
+
+int integrand_vegas_grid(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    VegasGridEvaluate((VegasGridUserdata*)userdata, ndim, x, ncomp, f, 1, 0);
+    return 0;
+}
+
+int integrand_vegas_grid_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    VegasGridEvaluate((VegasGridUserdata*)userdata, ndim, x, ncomp, f, *nvec, *core);
+    return 0;
+}
+
+enum VegasGridStart { GRID_NEW, GRID_NEIGHBOUR, GRID_PERSISTENT };
+
+// Grid of the term at gridkey: the persistent grid of the same key, or the nearest stored grid
+// refined (or a flat grid trained) with VEGAS_GRID_EVALS uniform points per iteration.
+// Returns the number of evaluations.
+static int TrainVegasGrid(const CubaGridKey& gridkey, int ndim, int ncomp, int nvec,
+    VegasGridUserdata& data, VegasGridStart& start, CubaGridKey& from) {
+    const int COLD_ITERATIONS=5, WARM_ITERATIONS=1;
+    data.grid = VegasGrid(ndim);
+    data.train = false;
+    if (nlodis_config::PERSISTENT_INTEGRATION_STATE && PersistentVegasGrid(gridkey, ndim, data.grid)){
+        start = GRID_PERSISTENT;
+        return 0;
+    }
+    start = NearestVegasGrid(gridkey, ndim, data.grid, from) ? GRID_NEIGHBOUR : GRID_NEW;
+    const int iterations = (start == GRID_NEIGHBOUR) ? WARM_ITERATIONS : COLD_ITERATIONS;
+    const int n = nlodis_config::VEGAS_GRID_EVALS;
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> rnd(0, 1);
+    std::vector<double> u(nvec*ndim), f(nvec*ncomp);
+    data.train = true;
+    for (int it=0; it<iterations; it++){
+        for (int i=0; i<n; i+=nvec){
+            const int m = std::min(nvec, n-i);
+            for (int k=0; k<m*ndim; k++)
+                u[k] = rnd(gen);
+            VegasGridEvaluate(&data, &ndim, &u[0], &ncomp, &f[0], m, 0);
+        }
+        data.grid.Refine();
+    }
+    data.train = false;
+    StoreVegasGrid(gridkey, data.grid);
+    return iterations*n;
+}
+
+IntegratorPolicy DefaultPolicy(const string& method, int ndim) {
+    IntegratorPolicy policy = {method, nlodis_config::CUBA_EPSREL, nlodis_config::CUBA_MAXEVAL, cuba_config::epsabs};
+    if (method == "auto"){
+        if (ndim <= nlodis_config::CUBA_CUBATURE_MAXDIM){
+            policy.method = nlodis_config::CUBA_CUBATURE_METHOD;
+            policy.epsrel = nlodis_config::CUBA_CUBATURE_EPSREL;
+        } else {
+            policy.method = nlodis_config::CUBA_MC_METHOD;
+        }
+    }
+    return policy;
+}
+
 void Cuba(string method, int ndim, integrand_t integrand,
-    void *userdata, double *integral, double *error, double *prob) {
+    void *userdata, double *integral, double *error, double *prob,
+    batch_integrand_t batch_integrand, CubaGridKey gridkey) {
+    Cuba(DefaultPolicy(method, ndim), ndim, 1, integrand, userdata, integral, error, prob, batch_integrand, gridkey);
+}
+
+void Cuba(const IntegratorPolicy& policy, int ndim, integrand_t integrand,
+    void *userdata, double *integral, double *error, double *prob,
+    batch_integrand_t batch_integrand, CubaGridKey gridkey) {
+    Cuba(policy, ndim, 1, integrand, userdata, integral, error, prob, batch_integrand, gridkey);
+}
+
+void Cuba(const IntegratorPolicy& policy, int ndim, int ncomp, integrand_t integrand,
+    void *userdata, double integral[], double error[], double prob[],
+    batch_integrand_t batch_integrand, CubaGridKey gridkey) {
+    const string& method = policy.method;
     // common arguments
-    int ncomp=1, nvec=1, seed=0, mineval=0, last=4;
+    int nvec=1, seed=0, mineval=0, last=4;
     int nregions, neval, fail;
     void *spin=NULL;
     char *statefile=NULL;
+    BatchUserdata batchdata;
+    if (nlodis_config::CUBA_NVEC > 1){
+        nvec = nlodis_config::CUBA_NVEC;
+        if (batch_integrand == NULL){
+            batchdata.integrand = integrand;
+            batchdata.userdata = userdata;
+            batch_integrand = integrand_batch_adapter;
+            userdata = &batchdata;
+        }
+        integrand = (integrand_t)batch_integrand;
+    }
+    // Vegas and Suave integrate in the variables of the grid of the term and kinematics. The
+    // dimension is part of the key, several integrations of one term (e.g. the dimension groups
+    // of Structf_massive_multimass) keep their grids apart.
+    bool gridded = (method=="vegas" || method=="suave") && nlodis_config::VEGAS_WARM_GRIDS && gridkey.term != NULL;
+    gridkey.ndim = ndim;
+    VegasGridUserdata griddata;
+    VegasGridStart start = GRID_NEW;
+    CubaGridKey from;
+    int trainevals=0;
+    if (gridded){
+        if (nvec > 1){
+            griddata.integrand = (batch_integrand_t)integrand;
+            griddata.userdata = userdata;
+        } else {
+            batchdata.integrand = integrand;
+            batchdata.userdata = userdata;
+            griddata.integrand = integrand_batch_adapter;
+            griddata.userdata = &batchdata;
+        }
+        trainevals = TrainVegasGrid(gridkey, ndim, ncomp, nvec, griddata, start, from);
+        integrand = (nvec > 1) ? (integrand_t)integrand_vegas_grid_batch : integrand_vegas_grid;
+        userdata = &griddata;
+    }
     if(method=="vegas"){
     // Vegas-specific arguments
     int nstart=1000, nincrease=500, nbatch=1000, gridno=0;
-    Vegas(ndim,ncomp,integrand,userdata,nvec,nlodis_config::CUBA_EPSREL,
-        cuba_config::epsabs,cuba_config::verbose,seed,mineval,
-        nlodis_config::CUBA_MAXEVAL,nstart,nincrease,nbatch,gridno,statefile,
+    Vegas(ndim,ncomp,integrand,userdata,nvec,policy.epsrel,
+        policy.epsabs,cuba_config::verbose,seed,mineval,
+        policy.maxeval,nstart,nincrease,nbatch,gridno,statefile,
         spin,&neval,&fail,integral,error,prob);
     }
     else if(method=="suave"){
     // Suave-specific arguments
     int nnew=1e3, nmin=2; // nnew=10e3
     double flatness=25; //25;
-    Suave(ndim,ncomp,integrand,userdata,nvec,nlodis_config::CUBA_EPSREL,
-        cuba_config::epsabs,cuba_config::verbose | last,seed,mineval,
-        nlodis_config::CUBA_MAXEVAL,nnew,nmin,flatness,statefile,spin,
+    Suave(ndim,ncomp,integrand,userdata,nvec,policy.epsrel,
+        policy.epsabs,cuba_config::verbose | last,seed,mineval,
+        policy.maxeval,nnew,nmin,flatness,statefile,spin,
         &nregions,&neval,&fail,integral,error,prob);
     }
     else if(method=="divonne"){
@@ -728,9 +1165,9 @@ void Cuba(string method, int ndim, integrand_t integrand,
     // Divonne-specific arguments
     int key1=1*47, key2=1, key3=1, maxpass=5, ngiven=0, nextra=0;
     double border=1e-8, maxchisq=10, mindeviation=0.25;
-    Divonne(ndim,ncomp,integrand,userdata,nvec,nlodis_config::CUBA_EPSREL,
-        cuba_config::epsabs,cuba_config::verbose,seed,mineval,
-        nlodis_config::CUBA_MAXEVAL,key1,key2,key3,maxpass,border,maxchisq,
+    Divonne(ndim,ncomp,integrand,userdata,nvec,policy.epsrel,
+        policy.epsabs,cuba_config::verbose,seed,mineval,
+        policy.maxeval,key1,key2,key3,maxpass,border,maxchisq,
         mindeviation,ngiven,ndim,NULL,nextra,NULL,statefile,spin,
         &nregions,&neval,&fail,integral,error,prob);
     }
@@ -738,11 +1175,39 @@ void Cuba(string method, int ndim, integrand_t integrand,
     if(ndim==1) ndim=2;
     // Cuhre-specific arguments
     int key=0;
-    Cuhre(ndim,ncomp,integrand,userdata,nvec,nlodis_config::CUBA_EPSREL,
-        cuba_config::epsabs,cuba_config::verbose | last,mineval,
-        nlodis_config::CUBA_MAXEVAL,key,statefile,spin,
+    Cuhre(ndim,ncomp,integrand,userdata,nvec,policy.epsrel,
+        policy.epsabs,cuba_config::verbose | last,mineval,
+        policy.maxeval,key,statefile,spin,
         &nregions,&neval,&fail,integral,error,prob);
     }
+    else if(method=="qmc"){
+    // Randomized quasi-Monte Carlo, parallelized with OpenMP, see qmc.hpp
+    batch_integrand_t qmc_integrand = (batch_integrand_t)integrand;
+    if (nvec == 1){
+        batchdata.integrand = integrand;
+        batchdata.userdata = userdata;
+        qmc_integrand = integrand_batch_adapter;
+        userdata = &batchdata;
+    }
+    QMCIntegrate(ndim,ncomp,qmc_integrand,userdata,nvec,policy.epsrel,
+        policy.epsabs,policy.maxeval,&neval,&fail,integral,error,prob);
+    }
+    if (nlodis_config::VERBOSE && gridkey.term != NULL && (method=="vegas" || method=="suave")){
+        #pragma omp critical
+        {
+            cout << "# " << method << " at Q^2=" << gridkey.Qsq << ", x=" << gridkey.xbj << ": " << neval << " evaluations";
+            if (gridded){
+                cout << " + " << trainevals << " grid training, ";
+                if (start == GRID_PERSISTENT)
+                    cout << "persistent grid";
+                else if (start == GRID_NEIGHBOUR)
+                    cout << "grid from Q^2=" << from.Qsq << ", x=" << from.xbj;
+                else
+                    cout << "new grid";
+            }
+            cout << endl;
+        }
+    }
 }
 
 
@@ -752,6 +1217,8 @@ void Cuba(string method, int ndim, integrand_t integrand,
 ///===========================================================================================
 // HELPERS
 double ComputeSigmaR::Sr(double r, double x) {
+    if (FastDipolePointer != NULL)
+        return FastDipolePointer->S(r, x);
     double Srx;//, Nrx;
     // cout << "Sr r x: " << r << " " << x << endl;
     if(r<nlodis_config::MINR){
@@ -762,15 +1229,26 @@ double ComputeSigmaR::Sr(double r, double x) {
         // Srx = ClassScopeDipolePointer->S_y(r, log(1/x))
         // Note: icY0 controls how much evolution we have before we define that we have "initial condition"
         if (x > icX0_bk){
-            Srx = ClassScopeDipolePointer->S(r, (icX0_bk*std::exp(-icY0)) ) ; //1-Nrx;
+            Srx = DipoleS(r, icX0_bk*exp_icY0 ) ; //1-Nrx;
         } else {
-            Srx = ClassScopeDipolePointer->S(r, (x*std::exp(-icY0)) ) ; //1-Nrx;
+            Srx = DipoleS(r, x*exp_icY0 ) ; //1-Nrx;
         }
     }
     return Srx;
 }
 
+void ComputeSigmaR::Sr(const double* r, const double* x, double* out, int n) {
+    if (FastDipolePointer != NULL){
+        FastDipolePointer->S(r, x, out, n);
+        return;
+    }
+    for (int i=0; i<n; i++)
+        out[i] = Sr(r[i], x[i]);
+}
+
 double ComputeSigmaR::SrY(double r, double Y) {
+    if (FastDipolePointer != NULL)
+        return FastDipolePointer->SY(r, Y);
     double Sry;
     if(r<nlodis_config::MINR){
         Sry = 1.;
@@ -779,9 +1257,9 @@ double ComputeSigmaR::SrY(double r, double Y) {
     }else{
         // Note: icY0 controls how much evolution we have before we define that we have "initial condition"
         if (std::exp(-Y) > icX0_bk){
-            Sry = ClassScopeDipolePointer->S(r, (icX0_bk*std::exp(-icY0)) ) ; //1-Nrx;
+            Sry = DipoleS(r, icX0_bk*exp_icY0 ) ; //1-Nrx;
         } else {
-            Sry = ClassScopeDipolePointer->S(r, (std::exp(-Y)*std::exp(-icY0)) ) ; //1-Nrx;
+            Sry = DipoleS(r, std::exp(-Y)*exp_icY0 ) ; //1-Nrx;
         }
     }
     return Sry;
@@ -1210,47 +1688,509 @@ double ComputeSigmaR::ITNLOqg_subterm_trbk_edmond(double Q, double x, double z1,
 // Computation dipole & data passing helpers
 ComputeSigmaR::ComputeSigmaR(AmplitudeLib *ObjectPointer){
     ClassScopeDipolePointer = ObjectPointer;
-}
+    DipoleViewPointer = NULL;
+    FastDipolePointer = NULL;
+    SetY0(0);
+    z2limit_PTR = &ComputeSigmaR::z2bound_simple;
+    UseRuntimeIntegrands();
+}
+
+ComputeSigmaR::ComputeSigmaR(DipoleAmplitudeView *ViewPointer){
+    ClassScopeDipolePointer = NULL;
+    DipoleViewPointer = ViewPointer;
+    FastDipolePointer = NULL;
+    SetY0(0);
+    z2limit_PTR = &ComputeSigmaR::z2bound_simple;
+    UseRuntimeIntegrands();
+}
+
+// Change of variables of the five dimensional massless qg integrands. PointContext sets
+// the linear maps up to MAXR, QGPilotMap chooses the map per (term, Q).
+enum QGZ2Map { QG_Z2_LINEAR, QG_Z2_LOG };
+enum QGRMap { QG_R_LINEAR, QG_R_LOG, QG_R_TANH };
+struct QGMap{
+    QGZ2Map z2map;
+    QGRMap rmap;    // Map of x01 and x02
+    double rscale;  // Scale of the log and tanh maps
+    double rmax;    // Truncation radius of x01 and x02
+};
 
+// Integrand context of one kinematic point, built once per Cuba call by ComputeSigmaR::PointContext
 struct Userdata{
     ComputeSigmaR* ComputerPtr;
     double Q, xbj;
     double qMass;
     double icX0;
+    // Sample invariant quantities
+    double Qsq;
+    double z2min;   // z2lower_bound(xbj, Q^2) of the configured scheme
+    double sumef;   // \sum_f e_f^2 of the quark mass, light quarks if qMass=0
+    QGMap qgmap;    // Variables of the qg integrands
 };
 
+// Structure-of-arrays work space of the batch integrands
+struct BatchColumns{
+    std::vector<double> z1, z2, x01, x02, x01sq, x02sq, x21sq;
+    std::vector<double> arg, besselarg, bessel, rpdty, S, alphabar, jac, impact;
+    std::vector<double> bessel2, rpdty2, S2, impact2;  // Second component of the fused integrands
+    void Resize(int n){
+        if ((int)z1.size() >= n) return;
+        std::vector<double>* cols[] = {&z1, &z2, &x01, &x02, &x01sq, &x02sq, &x21sq,
+            &arg, &besselarg, &bessel, &rpdty, &S, &alphabar, &jac, &impact,
+            &bessel2, &rpdty2, &S2, &impact2};
+        for (unsigned int i=0; i<sizeof(cols)/sizeof(cols[0]); i++)
+            cols[i]->resize(n);
+    }
+};
 
-double sumef_from_mass(double mf){
-    double sumef; // \sum_f e_f^2
-    // return 1.0; // mass function plots
-    if (mf < 1e-8) {
-        sumef = 6.0/9.0; // light quarks uds only.
-    } else if (mf > 0.7*0.00216 && mf < 1.3*0.00216) {
-        // u
-        sumef = 4.0/9.0;
-    } else if (mf > 0.7*0.00467 && mf < 1.3*0.00467) {
-        // d
-        sumef = 1.0/9.0;
-    } else if (mf > 0.7*0.093 && mf < 1.3*0.093) {
-        // s
-        sumef = 1.0/9.0;
-    } else if (mf > 0.7*1.27 && mf < 2*1.27) {
-        // c
-        sumef = 4.0/9.0;
-    } else if (mf > 0.7*4.180 && mf < 3*4.180) {
-        // b
-        sumef = 1.0/9.0;
-    } else {
-        // failure to identify quark from mass: kill it all.
-        cout << "Failure to identify quark sumef from mass. Exit." << endl;
-        exit(1);
+// One work space per thread, Cuba may call the integrands from parallel workers
+static BatchColumns& BatchWorkspace(int n){
+    static thread_local BatchColumns columns;
+    columns.Resize(n);
+    return columns;
+}
+
+// Dipole size x01 and z1 of the two dimensional LO and dipole integrands, and the
+// Bessel function argument Q*sqrt(z1(1-z1)) x01. Arguments below minarg are
+// replaced by 1 in besselarg so that the batched Bessel functions are well defined,
+// the caller sets those points to zero.
+static void LOCoordinates(const double x[], int ndim, int n, double Q, double minarg, BatchColumns& c){
+    double *z1=&c.z1[0], *x01=&c.x01[0], *x01sq=&c.x01sq[0], *arg=&c.arg[0], *besselarg=&c.besselarg[0];
+    #pragma omp simd
+    for (int i=0; i<n; i++){
+        z1[i] = x[i*ndim];
+        x01[i] = nlodis_config::MAXR*x[i*ndim+1];
+        x01sq[i] = x01[i]*x01[i];
+        arg[i] = Q*sqrt(z1[i]*(1.0-z1[i])*x01sq[i]);
+        besselarg[i] = arg[i] < minarg ? 1.0 : arg[i];
     }
-    return sumef;
+}
+
+// z2 between z2min and z2max from u in [0,1], multiplies jac by dz2/du.
+// The log map (flat for the 1/z2 of the integrands) needs z2min > 0.
+static inline double QGMapZ2(const QGMap& map, double u, double z2min, double z2max, double& jac){
+    if (map.z2map == QG_Z2_LOG && z2min > 0){
+        double l = log(z2max/z2min);
+        double z2 = z2min*exp(l*u);
+        jac *= z2*l;
+        return z2;
+    }
+    jac *= z2max-z2min;
+    return (z2max-z2min)*u+z2min;
+}
+
+// Dipole size between 0 and map.rmax from u in [0,1], multiplies jac by dr/du
+static inline double QGMapR(const QGMap& map, double u, double& jac){
+    const double s = map.rscale;
+    if (map.rmap == QG_R_LOG){
+        // Linear below the scale s and logarithmic above it
+        double l = log1p(map.rmax/s);
+        double r = s*expm1(l*u);
+        jac *= (r+s)*l;
+        return r;
+    } else if (map.rmap == QG_R_TANH){
+        // Uniform in tanh(r/s)
+        double t = tanh(map.rmax/s);
+        double v = u*t;
+        jac *= s*t/(1.0-v*v);
+        return s*atanh(v);
+    }
+    jac *= map.rmax;
+    return map.rmax*u;
+}
+
+// Samples of a pilot run of a qg integrand, the sum of its components
+struct QGPilotSamples{
+    std::vector<double> u;      // 5 uniform variables per sample
+    std::vector<double> value;
+};
+
+static void QGPilotEvaluate(integrand_t integrand, void* userdata, int ncomp, QGPilotSamples& s){
+    const int ndim=5;
+    std::vector<double> f(ncomp);
+    s.value.resize(s.u.size()/ndim);
+    for (size_t i=0; i<s.value.size(); i++){
+        integrand(&ndim, &s.u[ndim*i], &ncomp, &f[0], userdata);
+        double sum=0;
+        for (int k=0; k<ncomp; k++) sum += f[k];
+        s.value[i] = gsl_finite(sum)==1 ? sum : 0;
+    }
+}
+
+static double QGPilotVariance(const QGPilotSamples& s){
+    double sum=0, sumsq=0;
+    for (size_t i=0; i<s.value.size(); i++){
+        sum += s.value[i];
+        sumsq += Sq(s.value[i]);
+    }
+    const double n = s.value.size();
+    return sumsq/n - Sq(sum/n);
+}
+
+// Integration tolerance of the point computed by this thread, and the squared integration
+// errors {dFL^2, dFT^2} of the terms computed since the last reset
+static thread_local double point_epsrel = 0;
+static thread_local double point_errsq[2] = {0, 0};
+
+// Relative tolerance of the integrations of the point computed by this thread
+static double PointEpsrel(){
+    return point_epsrel > 0 ? point_epsrel : nlodis_config::CUBA_EPSREL;
+}
+
+// Variable maps chosen by QGPilotMap, per (computer, integrand, Q, z2min, epsrel)
+typedef std::pair<std::pair<const ComputeSigmaR*, integrand_t>, std::pair<std::pair<double, double>, double> > QGMapKey;
+static std::map<QGMapKey, QGMap> qg_variable_maps;
+
+// Variable maps of the qg integrand, written to *map (in userdata), which give the smallest
+// variance of the pilot samples. The map is chosen once per (computer, integrand, Q, z2min, epsrel)
+// and kept until ResetQGVariableMaps, which the fitter calls when the dipole changes, so that the
+// maps follow the BK solution of the current parameters.
+// The truncation radius drops a tail below the tolerance of the point, so points with tighter
+// tolerances get their own maps.
+static QGMap QGPilotMap(const ComputeSigmaR* computer, integrand_t integrand, void* userdata, QGMap* map, int ncomp,
+    double Q, double z2min){
+    std::map<QGMapKey, QGMap>& maps = qg_variable_maps;
+    const double epsrel = PointEpsrel();
+    const QGMapKey key(std::make_pair(computer, integrand), std::make_pair(std::make_pair(Q, z2min), epsrel));
+    bool found;
+    #pragma omp critical(qg_variable_maps)
+    {
+        std::map<QGMapKey, QGMap>::iterator it = maps.find(key);
+        found = it != maps.end();
+        if (found)
+            *map = it->second;
+    }
+    if (found)
+        return *map;
+
+    const QGMap linear = {QG_Z2_LINEAR, QG_R_LINEAR, 0, nlodis_config::MAXR};
+    const QGZ2Map z2map = z2min > 0 ? QG_Z2_LOG : QG_Z2_LINEAR;
+    QGPilotSamples s;
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> rnd(0, 1);
+    s.u.resize(5*std::max(nlodis_config::QG_PILOT_EVALS, 1));
+    for (size_t i=0; i<s.u.size(); i++)
+        s.u[i] = rnd(gen);
+
+    // Truncation radius from the tail of the reference map, which samples all dipole sizes
+    const QGMap reference = {z2map, QG_R_LOG, 1.0/Q, nlodis_config::MAXR};
+    *map = reference;
+    QGPilotEvaluate(integrand, userdata, ncomp, s);
+    double total=0;
+    for (size_t i=0; i<s.value.size(); i++)
+        total += s.value[i];
+    QGMap best = linear;
+    if (total != 0){
+        best.rmax = nlodis_config::MAXR;
+        const double radii[] = {5, 10, 20, 40, 80, 160};
+        for (int j=0; j<6 && radii[j]/Q < nlodis_config::MAXR; j++){
+            double tail=0, jac=1;
+            for (size_t i=0; i<s.value.size(); i++){
+                double x01 = QGMapR(reference, s.u[5*i+2], jac);
+                double x02 = QGMapR(reference, s.u[5*i+3], jac);
+                if (std::max(x01, x02) > radii[j]/Q)
+                    tail += std::abs(s.value[i]);
+            }
+            if (tail <= nlodis_config::QG_TAIL_FRACTION*epsrel*std::abs(total)){
+                best.rmax = radii[j]/Q;
+                break;
+            }
+        }
+
+        const QGZ2Map z2maps[] = {QG_Z2_LINEAR, QG_Z2_LOG};
+        const QGRMap rmaps[] = {QG_R_LINEAR, QG_R_LOG, QG_R_LOG, QG_R_TANH, QG_R_TANH};
+        const double rscales[] = {0, 0.1/Q, 1.0/Q, 2.0/Q, 10.0/Q};
+        double bestvar = -1;
+        for (int a=0; a<2; a++){
+            for (int b=0; b<5; b++){
+                const QGMap candidate = {z2maps[a], rmaps[b], rscales[b], best.rmax};
+                *map = candidate;
+                QGPilotEvaluate(integrand, userdata, ncomp, s);
+                double var = QGPilotVariance(s);
+                if (bestvar < 0 || var < bestvar){
+                    bestvar = var;
+                    best = candidate;
+                }
+            }
+        }
+    }
+    if (nlodis_config::VERBOSE)
+        cout << "# qg variable maps at Q=" << Q << " GeV, z2min=" << z2min << ", epsrel=" << epsrel << ": z2 map " << best.z2map
+            << ", r map " << best.rmap << ", r scale " << best.rscale << ", rmax " << best.rmax << endl;
+
+    #pragma omp critical(qg_variable_maps)
+    maps.insert(std::make_pair(key, best));
+    *map = best;
+    return best;
+}
+
+void ComputeSigmaR::ResetQGVariableMaps() {
+    #pragma omp critical(qg_variable_maps)
+    qg_variable_maps.clear();
+}
+
+// Coordinates and Jacobian of the five dimensional unsubtracted qg integrands
+static void QGCoordinates(const double x[], int ndim, int n, double z2min, const QGMap& map, BatchColumns& c){
+    double *z1=&c.z1[0], *z2=&c.z2[0], *x01=&c.x01[0], *x02=&c.x02[0];
+    double *x01sq=&c.x01sq[0], *x02sq=&c.x02sq[0], *x21sq=&c.x21sq[0], *jac=&c.jac[0];
+    #pragma omp simd
+    for (int i=0; i<n; i++){
+        const double* xi = x + i*ndim;
+        double j = 1.0-z2min;
+        z1[i] = (1.0-z2min)*xi[0];
+        z2[i] = QGMapZ2(map, xi[1], z2min, 1.0-z1[i], j);
+        x01[i] = QGMapR(map, xi[2], j);
+        x02[i] = QGMapR(map, xi[3], j);
+        double phix0102 = 2.0*M_PI*xi[4];
+        x01sq[i] = x01[i]*x01[i];
+        x02sq[i] = x02[i]*x02[i];
+        x21sq[i] = x01sq[i]+x02sq[i]-2.0*x01[i]*x02[i]*cos(phix0102);
+        jac[i] = j;
+    }
+}
+
+// Target rapidity and coupling of the qg integrands, per point as they go through the scheme
+template<class Scheme>
+static void QGSchemeColumns(Userdata* dataptr, int n, BatchColumns& c){
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    for (int i=0; i<n; i++){
+        c.rpdty[i] = Scheme::Xrpdty_NLO(Optr, dataptr->Qsq, c.z2[i], dataptr->z2min, dataptr->icX0, c.x01sq[i], c.x02sq[i], c.x21sq[i]);
+        Alphasdata alphasdata;
+        alphasdata.x01sq=c.x01sq[i];
+        alphasdata.x02sq=c.x02sq[i];
+        alphasdata.x21sq=c.x21sq[i];
+        c.alphabar[i] = Scheme::Alphabar_QG(Optr, &alphasdata);
+    }
+}
+
+// f[i*stride] = jac*alphabar*CF/Nc*impact/z2*x01*x02, non-finite points set to zero
+static void QGCombine(int n, const BatchColumns& c, const std::vector<double>& impact, double f[], int stride){
+    for (int i=0; i<n; i++){
+        double res = c.jac[i]*c.alphabar[i]*CF/Nc*impact[i]/c.z2[i]*c.x01[i]*c.x02[i];
+        f[i*stride] = gsl_finite(res)==1 ? res : 0;
+    }
+}
+
+///===========================================================================================
+// Scheme choices for the qg integrands
+// RuntimeScheme calls through the method pointers set in MetaPrescriptionSetter,
+// StaticScheme resolves them at compile time so that they can be inlined.
+// The impact factors only depend on the TRBK rho prescription, so they are
+// instantiated per Rho policy and shared between the schemes.
+struct RuntimeRho{
+    static double rho_rapidity_shift(ComputeSigmaR* O, double Qsq, double rsq){ return O->rho_rapidity_shift(Qsq, rsq); }
+};
+
+template<nlodis_config::TargetRapidityBKRhoPresc RHO>
+struct StaticRho{
+    static double rho_rapidity_shift(ComputeSigmaR* O, double Qsq, double rsq){
+        switch (RHO){
+            case nlodis_config::TRBK_RHO_DISABLED: return O->rho_no_shift_projectileY(Qsq, rsq);
+            case nlodis_config::TRBK_RHO_QQ0: return O->rho_rapidity_shift_QQ0(Qsq, rsq);
+            case nlodis_config::TRBK_RHO_RQ0: return O->rho_rapidity_shift_RQ0(Qsq, rsq);
+            case nlodis_config::TRBK_RHO_X_R: return O->rho_rapidity_shift_XR(Qsq, rsq, 0, 0);
+            case nlodis_config::TRBK_RHO_MAX_X_Y_R: return O->rho_rapidity_shift_MAX_XYR(Qsq, rsq, 0, 0);
+        }
+        return 0;
+    }
+};
+
+struct RuntimeScheme{
+    typedef RuntimeRho Rho;
+    static double Alphabar_QG(ComputeSigmaR* O, Alphasdata* data){ return O->Alphabar_QG(data); }
+    static double Xrpdty_NLO(ComputeSigmaR* O, double Qsq, double z2, double z2min, double X0, double x01sq, double x02sq, double x21sq){
+        return O->Xrpdty_NLO(Qsq, z2, z2min, X0, x01sq, x02sq, x21sq);
+    }
+    static double rho_rapidity_shift(ComputeSigmaR* O, double Qsq, double rsq){ return O->rho_rapidity_shift(Qsq, rsq); }
+    static double ILNLOqg_subterm(ComputeSigmaR* O, double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq){
+        return O->ILNLOqg_subterm(Q, x, z1, z2, x01sq, x02sq, x21sq);
+    }
+    static double ITNLOqg_subterm(ComputeSigmaR* O, double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq){
+        return O->ITNLOqg_subterm(Q, x, z1, z2, x01sq, x02sq, x21sq);
+    }
+};
+
+template<nlodis_config::RunningCouplingDIS RC, nlodis_config::TargetRapidityBKRhoPresc RHO,
+    bool TARGET_ETA, nlodis_config::SubSchemeTermKernel SUBTERM>
+struct StaticScheme{
+    typedef StaticRho<RHO> Rho;
+    static double Alphabar_QG(ComputeSigmaR* O, Alphasdata* data){
+        switch (RC){
+            case nlodis_config::DIS_RC_FIXED: return O->alpha_bar_QG_fixed(data);
+            case nlodis_config::DIS_RC_PARENT: return O->alpha_bar_QG_running_pd(data);
+            case nlodis_config::DIS_RC_GUILLAUME: return O->alpha_bar_QG_running_guillaume(data);
+            case nlodis_config::DIS_RC_SMALLEST: return O->alpha_bar_QG_running_smallest(data);
+        }
+        return 0;
+    }
+    static double Xrpdty_NLO(ComputeSigmaR* O, double Qsq, double z2, double z2min, double X0, double x01sq, double x02sq, double x21sq){
+        if (TARGET_ETA) return O->Xrpdty_NLO_targetETA(Qsq, z2, z2min, X0, x01sq, x02sq, x21sq);
+        return O->Xrpdty_NLO_projectileY(Qsq, z2, z2min, X0, x01sq, x02sq, x21sq);
+    }
+    static double ILNLOqg_subterm(ComputeSigmaR* O, double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq){
+        switch (SUBTERM){
+            case nlodis_config::SUBTERM_LOBK_Z2TOZERO: return O->ILNLOqg_t<Rho>(Q, x, z1, 0, x01sq, x02sq, x21sq);
+            case nlodis_config::SUBTERM_LOBK_EXPLICIT: return O->ILNLOqg_subterm_lobk_explicit(Q, x, z1, z2, x01sq, x02sq, x21sq);
+            case nlodis_config::SUBTERM_RESUM: return O->ILNLOqg_subterm_resumbk(Q, x, z1, z2, x01sq, x02sq, x21sq);
+            case nlodis_config::SUBTERM_KCBK_BEUF: return O->ILNLOqg_subterm_kcbk_beuf(Q, x, z1, z2, x01sq, x02sq, x21sq);
+            case nlodis_config::SUBTERM_TRBK_EDMOND: return O->ILNLOqg_subterm_trbk_edmond(Q, x, z1, z2, x01sq, x02sq, x21sq);
+        }
+        return 0;
+    }
+    static double ITNLOqg_subterm(ComputeSigmaR* O, double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq){
+        switch (SUBTERM){
+            case nlodis_config::SUBTERM_LOBK_Z2TOZERO: return O->ITNLOqg_t<Rho>(Q, x, z1, 0, x01sq, x02sq, x21sq);
+            case nlodis_config::SUBTERM_LOBK_EXPLICIT: return O->ITNLOqg_subterm_lobk_explicit(Q, x, z1, z2, x01sq, x02sq, x21sq);
+            case nlodis_config::SUBTERM_RESUM: return O->ITNLOqg_subterm_resumbk(Q, x, z1, z2, x01sq, x02sq, x21sq);
+            case nlodis_config::SUBTERM_KCBK_BEUF: return O->ITNLOqg_subterm_kcbk_beuf(Q, x, z1, z2, x01sq, x02sq, x21sq);
+            case nlodis_config::SUBTERM_TRBK_EDMOND: return O->ITNLOqg_subterm_trbk_edmond(Q, x, z1, z2, x01sq, x02sq, x21sq);
+        }
+        return 0;
+    }
+};
+
+template<class Rho>
+double ComputeSigmaR::cov_to_eta_x_t(double r, double xbj, double Qsq){
+    // shift xbj_Y to xbj_eta
+    double rho = Rho::rho_rapidity_shift(this, Qsq, Sq(r));
+    return xbj * std::exp(rho);
+}
+
+
+
+double sumef_from_mass(double mf){
+    double sumef; // \sum_f e_f^2
+    // return 1.0; // mass function plots
+    if (mf < 1e-8) {
+        sumef = 6.0/9.0; // light quarks uds only.
+    } else if (mf > 0.7*0.00216 && mf < 1.3*0.00216) {
+        // u
+        sumef = 4.0/9.0;
+    } else if (mf > 0.7*0.00467 && mf < 1.3*0.00467) {
+        // d
+        sumef = 1.0/9.0;
+    } else if (mf > 0.7*0.093 && mf < 1.3*0.093) {
+        // s
+        sumef = 1.0/9.0;
+    } else if (mf > 0.7*1.27 && mf < 2*1.27) {
+        // c
+        sumef = 4.0/9.0;
+    } else if (mf > 0.7*4.180 && mf < 3*4.180) {
+        // b
+        sumef = 1.0/9.0;
+    } else {
+        // failure to identify quark from mass: kill it all.
+        cout << "Failure to identify quark sumef from mass. Exit." << endl;
+        exit(1);
+    }
+    return sumef;
+}
+
+Userdata ComputeSigmaR::PointContext(double Q, double xbj, double qMass){
+    Userdata userdata;
+    userdata.ComputerPtr=this;
+    userdata.Q=Q;
+    userdata.xbj=xbj;
+    userdata.qMass=qMass;
+    userdata.icX0=icX0;
+    userdata.Qsq=Sq(Q);
+    userdata.z2min=z2lower_bound(xbj, userdata.Qsq);
+    userdata.sumef = (qMass > 0) ? sumef_from_mass(qMass) : sumef;
+    QGMap linear = {QG_Z2_LINEAR, QG_R_LINEAR, 0, nlodis_config::MAXR};
+    userdata.qgmap = linear;
+    if (qMass > 0)
+        InitMassiveTables();
+    return userdata;
+}
+
+void ComputeSigmaR::SetPointEpsrel(double epsrel) {
+    point_epsrel = epsrel;
+}
+
+void ComputeSigmaR::ResetIntegrationErrors() {
+    point_errsq[0] = point_errsq[1] = 0;
+}
+
+void ComputeSigmaR::IntegrationErrors(double err[2]) {
+    err[0] = std::sqrt(point_errsq[0]);
+    err[1] = std::sqrt(point_errsq[1]);
+}
+
+// value = c*integral is a term of FL (pol=0) or FT (pol=1) at Q without the factor structurefunfac*Q^2
+// of the structure functions, adds its integration error c*error to those of the point
+static double Integrated(int pol, double Q, double value, double integral, double error) {
+    if (integral != 0)
+        point_errsq[pol] += Sq(structurefunfac*Sq(Q)*value/integral*error);
+    return value;
+}
+
+// Terms which take an integrator policy: the names passed to Policy by the methods calling
+// Cuba, the subterms of the qg control variates with the suffix "_subterm"
+static const char* const policy_terms[] = {
+    "LLOp", "LLOpMass", "LLOp_massive", "TLOp", "TLOpMass", "TLOp_massive",
+    "LNLOdip", "LNLOdip_z2", "LNLOsigma3", "LNLOqgunsub", "LNLOqgsub", "LNLOqgunsubRisto", "LNLOqgsubRisto",
+    "TNLOdip", "TNLOdip_z2", "TNLOsigma3", "TNLOqgunsub", "TNLOqgsub", "TNLOqgunsubRisto", "TNLOqgsubRisto",
+    "LNLOdip_massive_LiLogConst", "LNLOdip_massive_Iab", "LNLOdip_massive_Icd",
+    "LNLOqgunsub_massive", "LNLOqgunsub_massive_I1", "LNLOqgunsub_massive_I2", "LNLOqgunsub_massive_I3",
+    "TNLOdip_massive_I1", "TNLOdip_massive_I2", "TNLOdip_massive_I3",
+    "TNLOqgunsub_massive_I1", "TNLOqgunsub_massive_I2", "TNLOqgunsub_massive_I3",
+    "LTICdip", "LTNLOqgunsub", "Structf_LTLOdip_multix", "Structf_LTNLOqg_unsub_multix",
+    "Structf_massive_multimass", "Structf_qg_variants",
+    "LNLOqgunsub_subterm", "TNLOqgunsub_subterm", "LTNLOqgunsub_subterm"
+};
+
+bool ComputeSigmaR::IsPolicyTerm(const string& term) {
+    for (size_t i=0; i<sizeof(policy_terms)/sizeof(policy_terms[0]); i++)
+        if (term == policy_terms[i])
+            return true;
+    return false;
+}
+
+void ComputeSigmaR::SetTermPolicy(const string& term, const IntegratorPolicy& p) {
+    if (!IsPolicyTerm(term)) {
+        cerr << "Integrator policy for an unknown term " << term << ". Exit." << endl;
+        exit(1);
+    }
+    termpolicies[term] = p;
+}
+
+IntegratorPolicy ComputeSigmaR::Policy(const string& term, int ndim) const {
+    IntegratorPolicy policy = DefaultPolicy(cubamethod, ndim);
+    std::map<string, IntegratorPolicy>::const_iterator it = termpolicies.find(term);
+    if (it != termpolicies.end())
+        policy = it->second;
+    // The tolerance of the point replaces CUBA_EPSREL, tighter policies (the cubature terms) are kept
+    if (point_epsrel > 0)
+        policy.epsrel = (policy.epsrel >= nlodis_config::CUBA_EPSREL) ? point_epsrel : std::min(policy.epsrel, point_epsrel);
+    return policy;
+}
+
+// Key of the Vegas grids of a term at the kinematics of userdata. The scheme fingerprint
+// combines the scheme settings which change the integrands but not their function pointers,
+// and the variable maps of the qg terms: a grid adapted in one set of variables is no good
+// in another. The map scales are in units of 1/Q, so that neighbouring Q^2 bins with the same
+// map choice share the grids. The untruncated maps extend to MAXR at every Q. Integrands
+// derived from the term, such as f - coef g of the control variates, pass their variant so
+// that they keep grids of their own.
+enum GridVariant { GRID_TERM = 0, QG_CONTROL_VARIATE_REMAINDER = 1 };
+
+static CubaGridKey GridKey(integrand_t term, const Userdata& userdata, GridVariant variant=GRID_TERM) {
+    const double Q = sqrt(userdata.Qsq);
+    const long settings[] = {nlodis_config::RC_DIS, nlodis_config::SUB_SCHEME, nlodis_config::SUB_TERM_KERNEL,
+        nlodis_config::Z2MINIMUM, nlodis_config::TRBK_RHO_PRESC, nlodis_config::PERF_MODE, nlodis_config::BESSEL_IMPL,
+        nlodis_config::QG_NESTED_PHI_POINTS, nlodis_config::QG_NESTED_Z1_POINTS,
+        userdata.qgmap.z2map, userdata.qgmap.rmap, lround(1e3*userdata.qgmap.rscale*Q),
+        userdata.qgmap.rmax < nlodis_config::MAXR ? lround(1e3*userdata.qgmap.rmax*Q) : 0, variant};
+    long scheme = 0;
+    for (size_t i=0; i<sizeof(settings)/sizeof(settings[0]); i++)
+        scheme = 31*scheme + settings[i];
+    CubaGridKey key = {term, scheme, userdata.Qsq, userdata.xbj, userdata.qMass, userdata.z2min, 0};  // ndim is set by Cuba()
+    return key;
 }
 
 ///===========================================================================================
 ///===========================================================================================
-///===========================================================================================
+///===========================================================================================
 // INTEGRATORS for cross sections
 
 /*
@@ -1263,7 +2203,7 @@ double ComputeSigmaR::ILLO(double Q, double z1, double x01sq) {
         // cout << bessel_inner_fun << " " << Q << " " << z1 << " " << x01sq << endl;
         res = 0;
     }else{
-        res = 4.0*Sq(Q)*Sq(z1)*Sq(1.0-z1)*Sq(gsl_sf_bessel_K0( bessel_inner_fun ));
+        res = 4.0*Sq(Q)*Sq(z1)*Sq(1.0-z1)*Sq(BesselK0( bessel_inner_fun ));
     }   
     return res;
 }
@@ -1277,23 +2217,43 @@ int integrand_ILLOp(const int *ndim, const double x[], const int *ncomp,double *
     double z1=x[0];
     double x01=nlodis_config::MAXR*x[1];
     double x01sq=x01*x01;
-    double Xrpdty_lo = Optr->Xrpdty_LO(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_LO(xbj, dataptr->Qsq, x01sq);
 
     double res=(1.0-(Optr->Sr(x01,Xrpdty_lo)))*(Optr->ILLO(Q,z1,x01sq))*x01;
         *f=res;
     return 0;
 }
 
+int integrand_ILLOp_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    Userdata *dataptr = (Userdata*)userdata;
+    const double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    const int n=*nvec;
+    BatchColumns& c = BatchWorkspace(n);
+    LOCoordinates(x, *ndim, n, Q, 1e-7, c);
+    for (int i=0; i<n; i++)
+        c.rpdty[i] = Optr->Xrpdty_LO(dataptr->xbj, dataptr->Qsq, c.x01sq[i]);
+    Optr->Sr(&c.x01[0], &c.rpdty[0], &c.S[0], n);
+    BesselK0(&c.besselarg[0], &c.bessel[0], n);
+
+    const double *z1=&c.z1[0], *x01=&c.x01[0], *arg=&c.arg[0], *bessel=&c.bessel[0], *S=&c.S[0];
+    #pragma omp simd
+    for (int i=0; i<n; i++){
+        double illo = arg[i] < 1e-7 ? 0 : 4.0*Sq(Q)*Sq(z1[i])*Sq(1.0-z1[i])*Sq(bessel[i]);
+        f[i] = (1.0-S[i])*illo*x01[i];
+    }
+    return 0;
+}
+
 double ComputeSigmaR::LLOp(double Q, double x) {
     double integral, error, prob;
     const int ndim=2;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.ComputerPtr=this;
+    Userdata userdata = PointContext(Q, x);
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Cuba(cubamethod,ndim,integrand_ILLOp,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    if (nlodis_config::PHOTON_OVERLAP_TABLES)
+        return fac*2.0*M_PI*LOp_overlap(Q, x, 0, 0);
+    Cuba(Policy("LLOp",ndim),ndim,integrand_ILLOp,&userdata,&integral,&error,&prob,integrand_ILLOp_batch,GridKey(integrand_ILLOp,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 // MASS
@@ -1305,10 +2265,10 @@ int integrand_ILLOpMass(const int *ndim, const double x[], const int *ncomp,doub
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
     double z1=x[0];
     double x01=nlodis_config::MAXR*x[1];
-    double Xrpdty_lo = Optr->Xrpdty_LO(xbj, Sq(Q), x01*x01);
+    double Xrpdty_lo = Optr->Xrpdty_LO(xbj, dataptr->Qsq, x01*x01);
 
     double af = sqrt( Sq(Q)*z1*(1-z1) + Sq(qmass) );
-    double impactfac = 4.0*Sq(Q*(z1)*(1.0-z1)*gsl_sf_bessel_K0(af*x01));
+    double impactfac = 4.0*Sq(Q*(z1)*(1.0-z1)*BesselK0(af*x01));
     double res=(1.0-(Optr->Sr(x01,Xrpdty_lo)))*(impactfac)*x01;
     if(gsl_finite(res)==1){
         *f=res;
@@ -1321,9 +2281,7 @@ int integrand_ILLOpMass(const int *ndim, const double x[], const int *ncomp,doub
 double ComputeSigmaR::LLOpMass(double Q, double x, bool charm) {
     double integral, error, prob;
     const int ndim=2;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
+    Userdata userdata = PointContext(Q, x);
     if (charm==false)
         userdata.qMass=qMass_light;
     else
@@ -1332,24 +2290,48 @@ double ComputeSigmaR::LLOpMass(double Q, double x, bool charm) {
     double ef = sumef;
     if (charm) ef = 4.0/9.0;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*ef;
-    Cuba(cubamethod,ndim,integrand_ILLOpMass,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    if (nlodis_config::PHOTON_OVERLAP_TABLES)
+        return fac*2.0*M_PI*LOp_overlap(Q, x, userdata.qMass, 0);
+    Cuba(Policy("LLOpMass",ndim),ndim,integrand_ILLOpMass,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILLOpMass,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::LLOp_massive(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=2;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
+    Userdata userdata = PointContext(Q, x, mf);
 
-    double ef = sumef_from_mass(mf);
+    double ef = userdata.sumef;
 
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*ef;
-    Cuba(cubamethod,ndim,integrand_ILLOpMass,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    if (nlodis_config::PHOTON_OVERLAP_TABLES)
+        return fac*2.0*M_PI*LOp_overlap(Q, x, userdata.qMass, 0);
+    Cuba(Policy("LLOp_massive",ndim),ndim,integrand_ILLOpMass,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILLOpMass,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
+}
+
+// TABULATED PHOTON OVERLAP, L AND T
+double ComputeSigmaR::LOp_overlap(double Q, double x, double mf, int pol) {
+    // Gauss-Legendre in ln r between MINR and MAXR, where S is 1 and 0
+    const int order = 8;
+    const double panelwidth = 0.5;
+    InitPhotonOverlapTables();
+    const double lnminr = log(nlodis_config::MINR);
+    const double lnmaxr = log(nlodis_config::MAXR-1e-7);
+    std::vector<double> nodes, weights;
+    GaussLegendreNodes(order, lnminr, lnmaxr, nodes, weights, std::max(1, (int)ceil((lnmaxr-lnminr)/panelwidth)));
+
+    const int n = nodes.size();
+    std::vector<double> r(n), X(n), S(n);
+    for (int i=0; i<n; i++){
+        r[i] = exp(nodes[i]);
+        X[i] = Xrpdty_LO(x, Sq(Q), Sq(r[i]));
+    }
+    Sr(&r[0], &X[0], &S[0], n);
+    double res = 0;
+    for (int i=0; i<n; i++)
+        res += weights[i]*Sq(r[i])*(1.0-S[i])*PhotonOverlap(pol, Q, mf, r[i]);
+    return res;
 }
 
 ///===========================================================================================
@@ -1364,7 +2346,7 @@ double ComputeSigmaR::ITLO(double Q, double z1, double x01sq) {
         // cout << bessel_inner_fun << " " << Q << " " << z1 << " " << x01sq << endl;
         res = 0;
     }else{
-        res = Sq(Q)*z1*(1.0-z1)*(1.0-2.0*z1+2.0*Sq(z1))*Sq(gsl_sf_bessel_K1(bessel_inner_fun));
+        res = Sq(Q)*z1*(1.0-z1)*(1.0-2.0*z1+2.0*Sq(z1))*Sq(BesselK1(bessel_inner_fun));
     }
     return res;
 }
@@ -1378,7 +2360,7 @@ int integrand_ITLOp(const int *ndim, const double x[], const int *ncomp,double *
     double z1=x[0];
     double x01=nlodis_config::MAXR*x[1];
     double x01sq=x01*x01;
-    double Xrpdty_lo = Optr->Xrpdty_LO(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_LO(xbj, dataptr->Qsq, x01sq);
 
     double res=(1.0-(Optr->Sr(x01,Xrpdty_lo)))*(Optr->ITLO(Q,z1,x01sq))*x01;
     if(gsl_finite(res)==1){
@@ -1389,16 +2371,36 @@ int integrand_ITLOp(const int *ndim, const double x[], const int *ncomp,double *
     return 0;
 }
 
+int integrand_ITLOp_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    Userdata *dataptr = (Userdata*)userdata;
+    const double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    const int n=*nvec;
+    BatchColumns& c = BatchWorkspace(n);
+    LOCoordinates(x, *ndim, n, Q, 1e-7, c);
+    for (int i=0; i<n; i++)
+        c.rpdty[i] = Optr->Xrpdty_LO(dataptr->xbj, dataptr->Qsq, c.x01sq[i]);
+    Optr->Sr(&c.x01[0], &c.rpdty[0], &c.S[0], n);
+    BesselK1(&c.besselarg[0], &c.bessel[0], n);
+
+    const double *z1=&c.z1[0], *x01=&c.x01[0], *arg=&c.arg[0], *bessel=&c.bessel[0], *S=&c.S[0];
+    for (int i=0; i<n; i++){
+        double itlo = arg[i] < 1e-7 ? 0 : Sq(Q)*z1[i]*(1.0-z1[i])*(1.0-2.0*z1[i]+2.0*Sq(z1[i]))*Sq(bessel[i]);
+        double res = (1.0-S[i])*itlo*x01[i];
+        f[i] = gsl_finite(res)==1 ? res : 0;
+    }
+    return 0;
+}
+
 double ComputeSigmaR::TLOp(double Q, double x) {
     double integral, error, prob;
     const int ndim=2;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.ComputerPtr=this;
+    Userdata userdata = PointContext(Q, x);
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Cuba(cubamethod,ndim,integrand_ITLOp,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    if (nlodis_config::PHOTON_OVERLAP_TABLES)
+        return fac*2.0*M_PI*LOp_overlap(Q, x, 0, 1);
+    Cuba(Policy("TLOp",ndim),ndim,integrand_ITLOp,&userdata,&integral,&error,&prob,integrand_ITLOp_batch,GridKey(integrand_ITLOp,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 // MASS
@@ -1410,10 +2412,10 @@ int integrand_ITLOpMass(const int *ndim, const double x[], const int *ncomp,doub
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
     double z1=x[0];
     double x01=nlodis_config::MAXR*x[1];
-    double Xrpdty_lo = Optr->Xrpdty_LO(xbj, Sq(Q), x01*x01);
+    double Xrpdty_lo = Optr->Xrpdty_LO(xbj, dataptr->Qsq, x01*x01);
 
     double af = sqrt( Sq(Q)*z1*(1.0-z1) + Sq(qmass) );
-    double impactfac = (1.0-2.0*z1+2.0*Sq(z1))*Sq(af*gsl_sf_bessel_K1(af*x01)) + Sq( qmass*gsl_sf_bessel_K0( af*x01 ) );
+    double impactfac = (1.0-2.0*z1+2.0*Sq(z1))*Sq(af*BesselK1(af*x01)) + Sq( qmass*BesselK0( af*x01 ) );
     double res=(1.0-(Optr->Sr(x01,Xrpdty_lo)))*(impactfac)*x01;
     if(gsl_finite(res)==1){
         *f=res;
@@ -1426,9 +2428,7 @@ int integrand_ITLOpMass(const int *ndim, const double x[], const int *ncomp,doub
 double ComputeSigmaR::TLOpMass(double Q, double x, bool charm) {
     double integral, error, prob;
     const int ndim=2;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
+    Userdata userdata = PointContext(Q, x);
     if (charm==false)
         userdata.qMass=qMass_light;
     else
@@ -1439,24 +2439,24 @@ double ComputeSigmaR::TLOpMass(double Q, double x, bool charm) {
     if (charm) ef = 4.0/9.0;
 
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*ef;
-    Cuba(cubamethod,ndim,integrand_ITLOpMass,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    if (nlodis_config::PHOTON_OVERLAP_TABLES)
+        return fac*2.0*M_PI*LOp_overlap(Q, x, userdata.qMass, 1);
+    Cuba(Policy("TLOpMass",ndim),ndim,integrand_ITLOpMass,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITLOpMass,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::TLOp_massive(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=2;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.qMass = mf;
-    userdata.ComputerPtr=this;
+    Userdata userdata = PointContext(Q, x, mf);
 
-    double ef = sumef_from_mass(mf);
+    double ef = userdata.sumef;
 
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*ef;
-    Cuba(cubamethod,ndim,integrand_ITLOpMass,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    if (nlodis_config::PHOTON_OVERLAP_TABLES)
+        return fac*2.0*M_PI*LOp_overlap(Q, x, userdata.qMass, 1);
+    Cuba(Policy("TLOp_massive",ndim),ndim,integrand_ITLOpMass,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITLOpMass,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 ///===========================================================================================
@@ -1470,7 +2470,7 @@ double ComputeSigmaR::TLOp_massive(double Q, double x, double mf) {
 // NLO
 double ComputeSigmaR::ILdip(double Q, double z1, double x01sq) { //ILbeufDIP
     double fac1 = Sq(z1)*Sq(1.0 - z1);
-    double facNLO = 4.0*Sq(Q*gsl_sf_bessel_K0(Q*sqrt(z1*(1-z1)*x01sq)));
+    double facNLO = 4.0*Sq(Q*BesselK0(Q*sqrt(z1*(1-z1)*x01sq)));
     return fac1*facNLO;
 }
 
@@ -1485,7 +2485,7 @@ int integrand_ILdip(const int *ndim, const double x[], const int *ncomp, double
 
     double alphabar=Optr->Alphabar(x01sq); //2;
     double alphfac=alphabar*CF/Nc;
-    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, dataptr->Qsq, x01sq);
     double SKernel = 1.0 - Optr->Sr(x01,Xrpdty_lo);
     double regconst = 5.0/2.0 - Sq(M_PI)/6.0;
     double res;
@@ -1499,13 +2499,37 @@ int integrand_ILdip(const int *ndim, const double x[], const int *ncomp, double
     return 0;
 }
 
+// The dipole term vanishes at x01=0 or z1=0,1, where the scalar integrand gives a non-finite result
+int integrand_ILdip_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    Userdata *dataptr = (Userdata*)userdata;
+    const double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    const int n=*nvec;
+    BatchColumns& c = BatchWorkspace(n);
+    LOCoordinates(x, *ndim, n, Q, 1e-300, c);
+    for (int i=0; i<n; i++){
+        c.alphabar[i] = Optr->Alphabar(c.x01sq[i]);
+        c.rpdty[i] = Optr->Xrpdty_DIP(dataptr->xbj, dataptr->Qsq, c.x01sq[i]);
+    }
+    Optr->Sr(&c.x01[0], &c.rpdty[0], &c.S[0], n);
+    BesselK0(&c.besselarg[0], &c.bessel[0], n);
+
+    const double regconst = 5.0/2.0 - Sq(M_PI)/6.0;
+    const double *z1=&c.z1[0], *x01=&c.x01[0], *arg=&c.arg[0], *bessel=&c.bessel[0], *S=&c.S[0], *alphabar=&c.alphabar[0];
+    for (int i=0; i<n; i++){
+        double alphfac = alphabar[i]*CF/Nc;
+        double res = (1.0-S[i])*4.0*Sq(z1[i])*Sq(1.0-z1[i])*Sq(Q*bessel[i])*x01[i]*( alphfac*(0.5*Sq(log(z1[i]/(1-z1[i]))) + regconst ) );
+        f[i] = (arg[i] < 1e-300 || gsl_finite(res)!=1) ? 0 : res;
+    }
+    return 0;
+}
+
 int integrand_ILdip_z2(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     double res;
     if (z2min > 0.5){ // Check that z2min is not too large since z1 limits are [z2min , 1-z2min]. IF it is too large, return res=0.
         res = 0;
@@ -1535,7 +2559,8 @@ int integrand_ILdip_z2(const int *ndim, const double x[], const int *ncomp, doub
     return 0;
 }
 
-double ComputeSigmaR::Bessel0Tripole(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
+template<class Rho>
+double ComputeSigmaR::Bessel0Tripole_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
     double x01=sqrt(x01sq);
     double x02=sqrt(x02sq);
     double x21=sqrt(x21sq);
@@ -1543,9 +2568,9 @@ double ComputeSigmaR::Bessel0Tripole(double Q, double x, double z1, double z2, d
     double X3sq = z1*(1.0 - z1 - z2)*x01sq + z2*(1.0 - z1 - z2)*x02sq + z2*z1*x21sq;
 
     double Qsq = Sq(Q);
-    double x_x01 = cov_to_eta_x(x01, x, Qsq);
-    double x_x02 = cov_to_eta_x(x02, x, Qsq);
-    double x_x21 = cov_to_eta_x(x21, x, Qsq);
+    double x_x01 = cov_to_eta_x_t<Rho>(x01, x, Qsq);
+    double x_x02 = cov_to_eta_x_t<Rho>(x02, x, Qsq);
+    double x_x21 = cov_to_eta_x_t<Rho>(x21, x, Qsq);
 
     double bessel_innerfun = Q*sqrt(X3sq);
     double facNLO = 0;
@@ -1556,12 +2581,13 @@ double ComputeSigmaR::Bessel0Tripole(double Q, double x, double z1, double z2, d
     } else if (bessel_innerfun < 1e-30){
         return 1;
     }else{
-        facNLO = 4.0*Sq(Q*gsl_sf_bessel_K0( bessel_innerfun ));
+        facNLO = 4.0*Sq(Q*BesselK0( bessel_innerfun ));
     }
     return facNLO*(1-SrTripole(x01, x_x01, x02, x_x02, x21, x_x21));
 }
 
-double ComputeSigmaR::ILNLOqg(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) { // old ILNLObeufQG
+template<class Rho>
+double ComputeSigmaR::ILNLOqg_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) { // old ILNLObeufQG
     double x20x21 = -0.5*(x01sq - x21sq - x02sq);
 
     double fac1 = Sq(z1)*Sq(1.0 - z1);
@@ -1571,8 +2597,8 @@ double ComputeSigmaR::ILNLOqg(double Q, double x, double z1, double z2, double x
     double fac2 = 1/x02sq - fun2;
     double fac3 = Sq(xi)*fun2;
 
-    double facNLO1 = Bessel0Tripole(Q, x, z1, z2, x01sq, x02sq, x21sq);
-    double facNLO2 = Bessel0Tripole(Q, x, z1, z2, x01sq, 0    , x01sq);
+    double facNLO1 = Bessel0Tripole_t<Rho>(Q, x, z1, z2, x01sq, x02sq, x21sq);
+    double facNLO2 = Bessel0Tripole_t<Rho>(Q, x, z1, z2, x01sq, 0    , x01sq);
 
     double res = fac1*((fun1*fac2)*(facNLO1 - facNLO2) + fac3*facNLO1 );
     if(gsl_finite(res)==1){
@@ -1583,6 +2609,14 @@ double ComputeSigmaR::ILNLOqg(double Q, double x, double z1, double z2, double x
     return res;
 }
 
+double ComputeSigmaR::Bessel0Tripole(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
+    return Bessel0Tripole_t<RuntimeRho>(Q, x, z1, z2, x01sq, x02sq, x21sq);
+}
+
+double ComputeSigmaR::ILNLOqg(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
+    return ILNLOqg_t<RuntimeRho>(Q, x, z1, z2, x01sq, x02sq, x21sq);
+}
+
 double ComputeSigmaR::ILNLOsigma3(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
     double impactfac_lo = ILLO(Q,z1,x01sq);
     double BKkernel = (K_kernel(x01sq,x02sq,x21sq) - 1.0)*2*K_lobk(x01sq,x02sq,x21sq);
@@ -1635,15 +2669,15 @@ double ComputeSigmaR::ILNLOqgRisto(double Q, double x, double z0, double z2, dou
 
     double facBesExpn, facBesExpo;
     if(Qbarn*sqrt(x01sq)>1e-8 && Qbarn*sqrt(x01sq)<5e2){
-        facBesExpn = 4.0*Sq(Q*gsl_sf_bessel_K0(Qbarn*sqrt(x01sq)))*facExpn*SKernel;
+        facBesExpn = 4.0*Sq(Q*BesselK0(Qbarn*sqrt(x01sq)))*facExpn*SKernel;
     }else{ facBesExpn = 0; }
     if(Qbaro*sqrt(x01sq)>1e-8 && Qbaro*sqrt(x01sq)<5e2){
-        facBesExpo = 4.0*Sq(Q*gsl_sf_bessel_K0(Qbaro*sqrt(x01sq)))*facExpo*SKernel;
+        facBesExpo = 4.0*Sq(Q*BesselK0(Qbaro*sqrt(x01sq)))*facExpo*SKernel;
     }else{ facBesExpo = 0; }
     //*/
 
-    //double facBesExpn = 4.0*Sq(Q*gsl_sf_bessel_K0(Qbarn*sqrt(x01sq)))*std::exp(-x02sq/(std::exp(M_EULER)*x01sq))*SKernel;
-    //double facBesExpo = 4.0*Sq(Q*gsl_sf_bessel_K0(Qbaro*sqrt(x01sq)))*std::exp(-x21sq/(std::exp(M_EULER)*x01sq))*SKernel;
+    //double facBesExpn = 4.0*Sq(Q*BesselK0(Qbarn*sqrt(x01sq)))*std::exp(-x02sq/(std::exp(M_EULER)*x01sq))*SKernel;
+    //double facBesExpo = 4.0*Sq(Q*BesselK0(Qbaro*sqrt(x01sq)))*std::exp(-x21sq/(std::exp(M_EULER)*x01sq))*SKernel;
 
     // FIRST FORM
     double term1 = facterm1*( facBesselTrip - facBesExpn );
@@ -1661,49 +2695,37 @@ double ComputeSigmaR::ILNLOqgRisto(double Q, double x, double z0, double z2, dou
     return res;
 }
 
-int integrand_ILqgunsub(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) { //integrand_ILbeufQGiancu
+template<class Scheme>
+int integrand_ILqgunsub_t(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) { //integrand_ILbeufQGiancu
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
     }
+    double jac=1.0-z2min; // z2, x01 and x02 jacobians from the variable maps
     double z1=(1.0-z2min)*x[0];
-    double z2=((1.0-z1)-z2min)*x[1]+z2min; // linear z_2 int
-    // double ymax = std::log(1-z1);
-    // double ymin = std::log(z2min);
-    // double y=(ymax-ymin)*x[1]+ymin;
-    // double z2=std::exp(y);
-    double x01=nlodis_config::MAXR*x[2];
-    double x02=nlodis_config::MAXR*x[3];
-    // double rhomax=std::log(nlodis_config::MAXR);
-    // double rhomin=std::log(nlodis_config::MINR);
-    // double rho01=(rhomax-rhomin)*x[2] + rhomin;
-    // double rho02=(rhomax-rhomin)*x[3] + rhomin;
-    // double x01=std::exp(rho01);
-    // double x02=std::exp(rho02);
+    double z2=QGMapZ2(dataptr->qgmap, x[1], z2min, 1.0-z1, jac);
+    double x01=QGMapR(dataptr->qgmap, x[2], jac);
+    double x02=QGMapR(dataptr->qgmap, x[3], jac);
     double phix0102=2.0*M_PI*x[4];
     double x01sq=Sq(x01);
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
-    double jac=(1.0-z2min)*(1.0-z1-z2min)*Sq(nlodis_config::MAXR); // linear z_2 int, linear x01 x02
-    // double jac=(1.0-z2min)*(ymax-ymin)*z2; // log z_2 int
-    // double jac=(1.0-z2min)*(1.0-z1-z2min)*Sq(rhomax-rhomin)*x01*x02; // linear z_2 int, log x01, log x02
 
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Scheme::Xrpdty_NLO(Optr,dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     Alphasdata alphasdata;
     alphasdata.x01sq=x01sq;
     alphasdata.x02sq=x02sq;
     alphasdata.x21sq=x21sq;
-    double alphabar=Optr->Alphabar_QG( &alphasdata );
+    double alphabar=Scheme::Alphabar_QG(Optr, &alphasdata);
     double alphfac=alphabar*CF/Nc;
 
-    double res =   jac*alphfac*( Optr->ILNLOqg(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq) )/z2*x01*x02;
+    double res =   jac*alphfac*( Optr->ILNLOqg_t<typename Scheme::Rho>(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq) )/z2*x01*x02;
 
     if(gsl_finite(res)==1){
         *f=res;
@@ -1713,13 +2735,41 @@ int integrand_ILqgunsub(const int *ndim, const double x[], const int *ncomp,doub
     return 0;
 }
 
+int integrand_ILqgunsub(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
+    return integrand_ILqgunsub_t<RuntimeScheme>(ndim, x, ncomp, f, userdata);
+}
+
+// The impact factors are evaluated point by point, they gather the tripole and Bessel functions of
+// both the x02 and x02=0 (z2->0 subtraction) configurations
+template<class Scheme>
+int integrand_ILqgunsub_batch_t(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    Userdata *dataptr = (Userdata*)userdata;
+    const double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    const int n=*nvec;
+    if (dataptr->z2min > 1.0){
+        for (int i=0; i<n; i++) f[i]=0;
+        return 0;
+    }
+    BatchColumns& c = BatchWorkspace(n);
+    QGCoordinates(x, *ndim, n, dataptr->z2min, dataptr->qgmap, c);
+    QGSchemeColumns<Scheme>(dataptr, n, c);
+    for (int i=0; i<n; i++)
+        c.impact[i] = Optr->ILNLOqg_t<typename Scheme::Rho>(Q, c.rpdty[i], c.z1[i], c.z2[i], c.x01sq[i], c.x02sq[i], c.x21sq[i]);
+    QGCombine(n, c, c.impact, f, 1);
+    return 0;
+}
+
+int integrand_ILqgunsub_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    return integrand_ILqgunsub_batch_t<RuntimeScheme>(ndim, x, ncomp, f, userdata, nvec, core);
+}
+
 int integrand_ILsigma3(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -1733,7 +2783,7 @@ int integrand_ILsigma3(const int *ndim, const double x[], const int *ncomp,doubl
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     Alphasdata alphasdata;
     alphasdata.x01sq=x01sq;
@@ -1752,40 +2802,40 @@ int integrand_ILsigma3(const int *ndim, const double x[], const int *ncomp,doubl
     return 0;
 }
 
-int integrand_ILqgsub(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
+template<class Scheme>
+int integrand_ILqgsub_t(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min >= 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
     }
+    double jac=1.0; // z2, x01 and x02 jacobians from the variable maps
     double z1=x[0];
-    double z2=(1.0-z2min)*x[1]+z2min;
-    double x01=nlodis_config::MAXR*x[2];
-    double x02=nlodis_config::MAXR*x[3];
+    double z2=QGMapZ2(dataptr->qgmap, x[1], z2min, 1.0, jac);
+    double x01=QGMapR(dataptr->qgmap, x[2], jac);
+    double x02=QGMapR(dataptr->qgmap, x[3], jac);
     double phix0102=2.0*M_PI*x[4];
     double x01sq=Sq(x01);
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
-    double jac=(1.0-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Scheme::Xrpdty_NLO(Optr,dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     Alphasdata alphasdata;
     alphasdata.x01sq=x01sq;
     alphasdata.x02sq=x02sq;
     alphasdata.x21sq=x21sq;
-    double alphabar=Optr->Alphabar_QG( &alphasdata );
+    double alphabar=Scheme::Alphabar_QG(Optr, &alphasdata);
     double alphfac=alphabar*CF/Nc;
 
     double ILNLOqg_z2 = 0;
     if (1-z1-z2 > 0){ // heaviside theta front factor on the full NLO term
-        ILNLOqg_z2 = (Optr->ILNLOqg(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq));
+        ILNLOqg_z2 = (Optr->ILNLOqg_t<typename Scheme::Rho>(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq));
     }
-    double ILNLOqg_z2_to_0 = Optr->ILNLOqg_subterm(Q,Xrpdt,z1, 0,x01sq,x02sq,x21sq);
+    double ILNLOqg_z2_to_0 = Scheme::ILNLOqg_subterm(Optr,Q,Xrpdt,z1, 0,x01sq,x02sq,x21sq);
 
     double res = jac*alphfac*(
                     ILNLOqg_z2
@@ -1801,6 +2851,10 @@ int integrand_ILqgsub(const int *ndim, const double x[], const int *ncomp,double
     return 0;
 }
 
+int integrand_ILqgsub(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
+    return integrand_ILqgsub_t<RuntimeScheme>(ndim, x, ncomp, f, userdata);
+}
+
 int integrand_ILqgunsubRisto(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata){
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
@@ -1870,96 +2924,327 @@ int integrand_ILqgsubRisto(const int *ndim, const double x[], const int *ncomp,
         return 0;
 }
 
+// TABULATED DIPOLE-LOOP KERNELS, L AND T
+// The massive kernels are built only on request, see nlodis_config::DIPOLE_LOOP_KERNELS_MASSIVE
+static bool MassiveDipoleLoopKernels() {
+    return nlodis_config::DIPOLE_LOOP_KERNELS && nlodis_config::DIPOLE_LOOP_KERNELS_MASSIVE;
+}
+
+double ComputeSigmaR::NLOdip_kernel(double Q, double x, double mf, int term) {
+    const DipoleLoopKernel kernel = DipoleLoopKernels(Q, mf);
+    const int n = kernel.r.size();
+    const double* r = &kernel.r[0];
+    std::vector<double> X(n), S(n);
+    for (int i=0; i<n; i++)
+        X[i] = Xrpdty_DIP(x, Sq(Q), Sq(r[i]));
+    Sr(r, &X[0], &S[0], n);
+    double res = 0;
+    for (int i=0; i<n; i++){
+        double alphfac = Alphabar(Sq(r[i]))*CF/Nc;
+        res += kernel.weights[i]*Sq(r[i])*(1.0-S[i])*alphfac*kernel.kernel[term][i];
+    }
+    return res;
+}
+
 // integrations
 double ComputeSigmaR::LNLOdip(double Q, double x) { // old LNLObeufDIP
     double integral, error, prob;
     const int ndim=2;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILdip,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    if (nlodis_config::DIPOLE_LOOP_KERNELS)
+        return fac*2.0*M_PI*NLOdip_kernel(Q, x, 0, DIPLOOP_L);
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("LNLOdip",ndim),ndim,integrand_ILdip,&userdata,&integral,&error,&prob,integrand_ILdip_batch,GridKey(integrand_ILdip,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::LNLOdip_z2(double Q, double x) { // old LNLObeufDIP
     double integral, error, prob;
     const int ndim=3;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILdip_z2,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("LNLOdip_z2",ndim),ndim,integrand_ILdip_z2,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILdip_z2,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
+}
+
+// Unsubtracted qg integrand f minus coef times its control variate g
+struct QGControlVariateUserdata{
+    integrand_t integrand, subterm;
+    Userdata* point;
+    double coef[2];     // Per component
+};
+
+int integrand_qgunsub_cv(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    QGControlVariateUserdata *cv = (QGControlVariateUserdata*)userdata;
+    double g[2];
+    cv->integrand(ndim, x, ncomp, f, cv->point);
+    cv->subterm(ndim, x, ncomp, g, cv->point);
+    for (int i=0; i<*ncomp; i++)
+        f[i] -= cv->coef[i]*g[i];
+    return 0;
+}
+
+// Point of the control variates integrated over z1, and their rule in z1/(1-z2) on [0,1]
+struct QGSubtermUserdata{
+    Userdata* point;
+    std::vector<double> nodes, weights;
+};
+
+// n point Gauss-Legendre rule in t with z1/(1-z2) = t^3/(t^3 + (1-t)^3), which resolves the LO
+// impact factors at both ends of the interval, where they peak at large Q x01
+static void QGSubtermZ1Rule(int n, std::vector<double>& nodes, std::vector<double>& weights){
+    std::vector<double> t, w;
+    GaussLegendreNodes(std::max(n, 1), 0, 1, t, w);
+    for (size_t i=0; i<t.size(); i++){
+        double a = t[i]*t[i]*t[i], b = Sq(1.0-t[i])*(1.0-t[i]);
+        nodes.push_back(a/(a+b));
+        weights.push_back(w[i]*3.0*Sq(t[i]*(1.0-t[i]))/Sq(a+b));
+    }
+}
+
+// Integral over z1 in [0, 1-z2] of the LO impact factor (pol 0: L, 1: T) divided by its value
+// at the node z1 where it is largest, 0 if it vanishes at every node. The subtraction terms
+// depend on z1 only through the LO impact factor, so this times a subtraction term at z1 is
+// its integral over z1.
+static double QGSubtermZ1Weight(const QGSubtermUserdata* sub, ComputeSigmaR* O, int pol, double Q, double z2,
+    double x01sq, double& z1){
+    double integral=0, largest=0;
+    z1 = 0;
+    for (size_t i=0; i<sub->nodes.size(); i++){
+        double z = (1.0-z2)*sub->nodes[i];
+        double lo = (pol == 0) ? O->ILLO(Q, z, x01sq) : O->ITLO(Q, z, x01sq);
+        integral += sub->weights[i]*lo;
+        if (lo > largest){
+            largest = lo;
+            z1 = z;
+        }
+    }
+    return largest > 0 ? (1.0-z2)*integral/largest : 0;
+}
+
+// Massless qg integrand with some of its variables integrated with fixed Gauss-Legendre rules
+// inside each sample, cf. PERF_MODE=MASSIVE_EXPLICIT_BESSEL_DIM_REDUCTION of the massive terms
+struct QGNestedUserdata{
+    integrand_t integrand;
+    batch_integrand_t batch;    // Evaluates the nodes of a sample in one call, if not NULL
+    Userdata* point;
+    int outer[5];               // Variable of the integrand of each sampled variable
+    std::vector<double> nodes;  // 5 variables per node, the sampled ones are filled in per sample
+    std::vector<double> weights;
+};
+
+int integrand_qg_nested(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    QGNestedUserdata *nested = (QGNestedUserdata*)userdata;
+    const int fulldim=5, n=nested->weights.size();
+    static thread_local std::vector<double> u, g;
+    u.assign(nested->nodes.begin(), nested->nodes.end());
+    g.resize(n*(*ncomp));
+    for (int i=0; i<n; i++)
+        for (int k=0; k<*ndim; k++)
+            u[i*fulldim + nested->outer[k]] = x[k];
+    if (nested->batch != NULL){
+        const int core=0;
+        nested->batch(&fulldim, &u[0], ncomp, &g[0], nested->point, &n, &core);
+    } else {
+        for (int i=0; i<n; i++)
+            nested->integrand(&fulldim, &u[i*fulldim], ncomp, &g[i*(*ncomp)], nested->point);
+    }
+    for (int c=0; c<*ncomp; c++)
+        f[c] = 0;
+    for (int i=0; i<n; i++)
+        for (int c=0; c<*ncomp; c++)
+            f[c] += nested->weights[i]*g[i*(*ncomp) + c];
+    return 0;
+}
+
+// Integral of a massless qg integrand over the unit hypercube (z1, z2, x01, x02, phi). The angle
+// x[4] is integrated with the QG_NESTED_PHI_POINTS point Gauss-Legendre rule on [0,1/2], as the
+// integrands depend on it only through cos(phi), and x[0] of the unsub terms with the
+// QG_NESTED_Z1_POINTS point rule on [0,1]. z1 of the sub terms is always sampled, the theta
+// function of the full term makes them discontinuous in it. Cuba integrates the rest.
+static void QGIntegrate(const string& term, integrand_t integrand, batch_integrand_t batch, Userdata& userdata,
+    int ncomp, bool unsub, double integral[], double error[]){
+    const ComputeSigmaR* O = userdata.ComputerPtr;
+    const int nphi = std::max(nlodis_config::QG_NESTED_PHI_POINTS, 0);
+    const int nz1 = unsub ? std::max(nlodis_config::QG_NESTED_Z1_POINTS, 0) : 0;
+    double prob[2];
+    if (nphi == 0 && nz1 == 0){
+        const int ndim=5;
+        Cuba(O->Policy(term,ndim),ndim,ncomp,integrand,&userdata,integral,error,prob,batch,GridKey(integrand,userdata));
+        return;
+    }
+
+    QGNestedUserdata nested;
+    nested.integrand = integrand;
+    nested.batch = (nlodis_config::CUBA_NVEC > 1) ? batch : NULL;
+    nested.point = &userdata;
+    int ndim = 0;
+    for (int k=0; k<5; k++){
+        if ((k == 0 && nz1 > 0) || (k == 4 && nphi > 0))
+            continue;
+        nested.outer[ndim++] = k;
+    }
+    std::vector<double> z1(1, 0), z1weights(1, 1), phi(1, 0), phiweights(1, 1);
+    if (nz1 > 0){
+        z1.clear(); z1weights.clear();
+        GaussLegendreNodes(nz1, 0, 1, z1, z1weights);
+    }
+    if (nphi > 0){
+        phi.clear(); phiweights.clear();
+        GaussLegendreNodes(nphi, 0, 0.5, phi, phiweights);
+        for (size_t j=0; j<phiweights.size(); j++)
+            phiweights[j] *= 2.0;
+    }
+    for (size_t i=0; i<z1.size(); i++){
+        for (size_t j=0; j<phi.size(); j++){
+            double node[5] = {z1[i], 0, 0, 0, phi[j]};
+            nested.nodes.insert(nested.nodes.end(), node, node+5);
+            nested.weights.push_back(z1weights[i]*phiweights[j]);
+        }
+    }
+    Cuba(O->Policy(term,ndim),ndim,ncomp,integrand_qg_nested,&nested,integral,error,prob,NULL,GridKey(integrand,userdata));
+}
+
+// Integral of the unsubtracted qg integrand (term) with the z2->0 subtraction term of the sub
+// scheme, subterm, as a control variate on the same samples. f - coef g is integrated with the
+// policy of the term, and coef times the integral of g is added back from subterm_z1, the same
+// integrated over z1, which Cuba samples in 4D. The coefficient coef = Cov(f, g)/Var(g) and the
+// variances and evaluation times of f - coef g and subterm_z1 come from QG_PILOT_EVALS uniform
+// samples. They give the time of the two integrations relative to integrating f directly; the
+// error goal of the term is split between them to minimize it, and if it is not below 1, f is
+// integrated directly instead.
+static void QGControlVariate(const string& term, integrand_t integrand, batch_integrand_t batch, integrand_t subterm,
+    integrand_t subterm_z1, Userdata& userdata, int ncomp, double integral[], double error[]){
+    const int ndim=5, subdim=4;
+    const int n = std::max(nlodis_config::QG_PILOT_EVALS, 2);
+    std::mt19937 gen(1);
+    std::uniform_real_distribution<double> rnd(0, 1);
+    QGControlVariateUserdata cv = {integrand, subterm, &userdata, {0, 0}};
+    QGSubtermUserdata sub;
+    sub.point = &userdata;
+    QGSubtermZ1Rule(nlodis_config::QG_CONTROL_VARIATE_Z1_POINTS, sub.nodes, sub.weights);
+
+    // Pilot: f and g on the same samples, subterm_z1 on the first four variables of the samples
+    std::vector<double> u(ndim*n), f(ncomp*n), g(ncomp*n), G(ncomp*n);
+    for (size_t i=0; i<u.size(); i++)
+        u[i] = rnd(gen);
+    for (int i=0; i<n; i++){
+        integrand(&ndim, &u[ndim*i], &ncomp, &f[ncomp*i], &userdata);
+        subterm(&ndim, &u[ndim*i], &ncomp, &g[ncomp*i], &userdata);
+        subterm_z1(&subdim, &u[ndim*i], &ncomp, &G[ncomp*i], &sub);
+    }
+
+    // Per component: the variance ratio Var(f - coef g)/Var(f), and the relative tolerances of
+    // the two integrations which give the error goal of f. The choice depends on the fixed seed
+    // pilot samples only, not on timings, so that it is the same on every run and machine.
+    const ComputeSigmaR* O = userdata.ComputerPtr;
+    IntegratorPolicy policy = O->Policy(term,ndim);
+    IntegratorPolicy subpolicy = O->Policy(term+"_subterm",subdim);
+    double reduction[2]={1,1};
+    double epsrel = -1, subepsrel = -1;
+    bool use = true;
+    for (int c=0; c<ncomp; c++){
+        double sumf=0, sumg=0, sumG=0, sumfg=0, sumff=0, sumgg=0, sumGG=0;
+        for (int i=0; i<n; i++){
+            const double fi = f[ncomp*i+c], gi = g[ncomp*i+c], Gi = G[ncomp*i+c];
+            sumf += fi; sumg += gi; sumG += Gi;
+            sumfg += fi*gi; sumff += fi*fi; sumgg += gi*gi; sumGG += Gi*Gi;
+        }
+        const double varf = sumff/n - Sq(sumf/n);
+        const double varg = sumgg/n - Sq(sumg/n);
+        const double varG = sumGG/n - Sq(sumG/n);
+        if (!(varf > 0 && varg > 0 && varG > 0 && sumG != 0)){
+            use = false;
+            continue;
+        }
+        cv.coef[c] = (sumfg/n - sumf/n*sumg/n)/varg;
+        const double varr = std::max(varf - cv.coef[c]*(sumfg/n - sumf/n*sumg/n), 0.0);
+        reduction[c] = varr/varf;
+        use = use && reduction[c] < nlodis_config::QG_CONTROL_VARIATE_MAX_VARIANCE_RATIO;
+        // Error e split as e_r^2 + e_G^2 = e^2 in proportion to the standard deviations,
+        // the minimum of the number of samples at equal cost per sample
+        const double ar = std::sqrt(varr), aG = std::abs(cv.coef[c])*std::sqrt(varG);
+        const double goal = policy.epsrel*std::abs(sumf/n);
+        const double remainder = std::abs(sumf - cv.coef[c]*sumg)/n;
+        const double r = remainder > 0 ? goal*std::sqrt(ar/(ar+aG))/remainder : policy.epsrel;
+        const double s = goal*std::sqrt(aG/(ar+aG))/std::abs(cv.coef[c]*sumG/n);
+        epsrel = (epsrel < 0) ? r : std::min(epsrel, r);
+        subepsrel = (subepsrel < 0) ? s : std::min(subepsrel, s);
+    }
+    if (nlodis_config::VERBOSE){
+        #pragma omp critical
+        {
+            cout << "# " << term << " control variate at Q=" << userdata.Q << ", x=" << userdata.xbj << ":";
+            for (int c=0; c<ncomp; c++)
+                cout << " coefficient " << cv.coef[c] << ", pilot variance ratio " << reduction[c] << ";";
+            cout << (use ? " used" : " not used, integrating directly") << endl;
+        }
+    }
+    if (!use){
+        QGIntegrate(term, integrand, batch, userdata, ncomp, true, integral, error);
+        return;
+    }
+
+    double prob[2], subintegral[2], suberror[2];
+    policy.epsrel = epsrel;
+    subpolicy.epsrel = subepsrel;
+    Cuba(policy,ndim,ncomp,integrand_qgunsub_cv,&cv,integral,error,prob,NULL,GridKey(integrand,userdata,QG_CONTROL_VARIATE_REMAINDER));
+    Cuba(subpolicy,subdim,ncomp,subterm_z1,&sub,subintegral,suberror,prob,NULL,GridKey(subterm_z1,userdata));
+    for (int c=0; c<ncomp; c++){
+        integral[c] += cv.coef[c]*subintegral[c];
+        error[c] = std::hypot(error[c], cv.coef[c]*suberror[c]);
+    }
 }
 
 double ComputeSigmaR::LNLOqgunsub(double Q, double x) { // old LNLObeufQGiancu
-    double integral, error, prob;
-    const int ndim=5;
+    double integral, error;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILqgunsub,&userdata,&integral,&error,&prob);
-    // return 2*fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
-    return 2*fac*2.0*M_PI*integral; // removed x01, x02 integral jacobians --- use with logarithmic x01, x02 integrals
+    Userdata userdata = PointContext(Q, x);
+    if (nlodis_config::QG_VARIABLE_MAPS)
+        QGPilotMap(this, ILqgunsub_integrand, &userdata, &userdata.qgmap, 1, Q, userdata.z2min);
+    if (nlodis_config::QG_CONTROL_VARIATE)
+        QGControlVariate("LNLOqgunsub", ILqgunsub_integrand, ILqgunsub_batch, ILqgunsub_subterm, ILqgunsub_subterm_z1,
+            userdata, 1, &integral, &error);
+    else
+        QGIntegrate("LNLOqgunsub", ILqgunsub_integrand, ILqgunsub_batch, userdata, 1, true, &integral, &error);
+    return Integrated(0, Q, 2*fac*2.0*M_PI*integral, integral, error); // x01, x02 jacobians from the variable maps
 }
 
 double ComputeSigmaR::LNLOsigma3(double Q, double x) {
     double integral, error, prob;
     const int ndim=5;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILsigma3,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("LNLOsigma3",ndim),ndim,integrand_ILsigma3,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILsigma3,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::LNLOqgsub(double Q, double x) { // no old implementation/version. CXY is similar but distinct, sub vs. xbj-sub.
-    double integral, error, prob;
-    const int ndim=5;
+    double integral, error;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILqgsub,&userdata,&integral,&error,&prob);
-    return 2*fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x);
+    if (nlodis_config::QG_VARIABLE_MAPS)
+        QGPilotMap(this, ILqgsub_integrand, &userdata, &userdata.qgmap, 1, Q, userdata.z2min);
+    QGIntegrate("LNLOqgsub", ILqgsub_integrand, NULL, userdata, 1, false, &integral, &error);
+    return Integrated(0, Q, 2*fac*2.0*M_PI*integral, integral, error);
 }
 
 double ComputeSigmaR::LNLOqgunsubRisto(double Q, double x) {
     double integral, error, prob;
     const int ndim=5;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILqgunsubRisto,&userdata,&integral,&error,&prob);
-    return (2/2)*fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral; // TODO a difference of a factor of 2 w.r.t. BEUF formulation was discovered in initial testing
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("LNLOqgunsubRisto",ndim),ndim,integrand_ILqgunsubRisto,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsubRisto,userdata));
+    return Integrated(0, Q, (2/2)*fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error); // TODO a difference of a factor of 2 w.r.t. BEUF formulation was discovered in initial testing
 }
 
 double ComputeSigmaR::LNLOqgsubRisto(double Q, double x) {
     double integral, error, prob;
     const int ndim=5;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILqgsubRisto,&userdata,&integral,&error,&prob);
-    return (2/2)*fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral; // TODO a difference of a factor of 2 w.r.t. BEUF formulation was discovered in initial testing
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("LNLOqgsubRisto",ndim),ndim,integrand_ILqgsubRisto,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgsubRisto,userdata));
+    return Integrated(0, Q, (2/2)*fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error); // TODO a difference of a factor of 2 w.r.t. BEUF formulation was discovered in initial testing
 }
 //*/
 
@@ -1980,7 +3265,7 @@ int integrand_ILdip_massive_LiLogConst(const int *ndim, const double x[], const
 
     double alphabar=Optr->Alphabar(x01sq);
     double alphfac=alphabar*CF/Nc;
-    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, dataptr->Qsq, x01sq);
     double SKernel = 1.0 - Optr->Sr(x01,Xrpdty_lo);
     double res;
 
@@ -2006,7 +3291,7 @@ int integrand_ILdip_massive_Iab(const int *ndim, const double x[], const int *nc
 
     double alphabar=Optr->Alphabar(x01sq);
     double alphfac=alphabar*CF/Nc;
-    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, dataptr->Qsq, x01sq);
     double SKernel = 1.0 - Optr->Sr(x01,Xrpdty_lo);
     double res;
 
@@ -2033,7 +3318,7 @@ int integrand_ILdip_massive_Icd(const int *ndim, const double x[], const int *nc
 
     double alphabar=Optr->Alphabar(x01sq);
     double alphfac=alphabar*CF/Nc;
-    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, dataptr->Qsq, x01sq);
     double SKernel = 1.0 - Optr->Sr(x01,Xrpdty_lo);
     double res;
 
@@ -2049,11 +3334,10 @@ int integrand_ILdip_massive_Icd(const int *ndim, const double x[], const int *nc
 int integrand_ILqgunsub_massive(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -2072,7 +3356,7 @@ int integrand_ILqgunsub_massive(const int *ndim, const double x[], const int *nc
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     // if (isnan(x01) or isnan(x02) or isnan(sqrt(x21sq))){
     //     cout << x01 << " " << Xrpdt << " " << x02 << " " << Xrpdt << " " << sqrt(x21sq) << " " << Xrpdt << endl; 
@@ -2107,11 +3391,10 @@ int integrand_ILqgunsub_massive(const int *ndim, const double x[], const int *nc
 int integrand_ILqgunsub_massive_I1(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -2126,7 +3409,7 @@ int integrand_ILqgunsub_massive_I1(const int *ndim, const double x[], const int
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
     double SKernel_dipole = 1.0 - Optr->Sr(x01,Xrpdt);
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
@@ -2153,11 +3436,10 @@ int integrand_ILqgunsub_massive_I1(const int *ndim, const double x[], const int
 int integrand_ILqgunsub_massive_I2(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -2174,7 +3456,7 @@ int integrand_ILqgunsub_massive_I2(const int *ndim, const double x[], const int
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
     Alphasdata alphasdata;
@@ -2200,11 +3482,10 @@ int integrand_ILqgunsub_massive_I2(const int *ndim, const double x[], const int
 int integrand_ILqgunsub_massive_I2_fast(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -2215,13 +3496,13 @@ int integrand_ILqgunsub_massive_I2_fast(const int *ndim, const double x[], const
     double x01=nlodis_config::MAXR*x[2];
     double x02=nlodis_config::MAXR*x[3];
     double phix0102=2.0*M_PI*x[4];
-    double y_t1 = x[5];
+    double y_t1 = *ndim > 5 ? x[5] : 0; // No y_t dimension with the tabulated G functions
     // double y_u1 = x[6]; // not used in fast
     double x01sq=Sq(x01);
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
     Alphasdata alphasdata;
@@ -2246,11 +3527,10 @@ int integrand_ILqgunsub_massive_I2_fast(const int *ndim, const double x[], const
 int integrand_ILqgunsub_massive_I3(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -2269,7 +3549,7 @@ int integrand_ILqgunsub_massive_I3(const int *ndim, const double x[], const int
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     // if (isnan(x01) or isnan(x02) or isnan(sqrt(x21sq))){
     //     cout << x01 << " " << Xrpdt << " " << x02 << " " << Xrpdt << " " << sqrt(x21sq) << " " << Xrpdt << endl; 
@@ -2303,11 +3583,10 @@ int integrand_ILqgunsub_massive_I3(const int *ndim, const double x[], const int
 int integrand_ILqgunsub_massive_I3_fast(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -2318,15 +3597,15 @@ int integrand_ILqgunsub_massive_I3_fast(const int *ndim, const double x[], const
     double x01=nlodis_config::MAXR*x[2];
     double x02=nlodis_config::MAXR*x[3];
     double phix0102=2.0*M_PI*x[4];
-    double y_t1 = x[5];
-    double y_t2 = x[6];
+    double y_t1 = *ndim > 5 ? x[5] : 0; // No y_t dimensions with the tabulated G functions
+    double y_t2 = *ndim > 6 ? x[6] : 0;
     // double y_u1 = x[7]; // not used in fast
     // double y_u2 = x[8]; // not used in fast
     double x01sq=Sq(x01);
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
@@ -2355,70 +3634,54 @@ int integrand_ILqgunsub_massive_I3_fast(const int *ndim, const double x[], const
 double ComputeSigmaR::LNLOdip_massive_LiLogConst(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=2;
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILdip_massive_LiLogConst,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    if (MassiveDipoleLoopKernels())
+        return fac*2.0*M_PI*NLOdip_kernel(Q, x, mf, DIPLOOP_L_LILOGCONST);
+    Cuba(Policy("LNLOdip_massive_LiLogConst",ndim),ndim,integrand_ILdip_massive_LiLogConst,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILdip_massive_LiLogConst,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 
 double ComputeSigmaR::LNLOdip_massive_Iab(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=3; // One more integral than in the Li & Log & Const terms
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILdip_massive_Iab,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    if (MassiveDipoleLoopKernels())
+        return fac*2.0*M_PI*NLOdip_kernel(Q, x, mf, DIPLOOP_L_IAB);
+    Cuba(Policy("LNLOdip_massive_Iab",ndim),ndim,integrand_ILdip_massive_Iab,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILdip_massive_Iab,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::LNLOdip_massive_Icd(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=4; // Two more integrals than in the Li & Log & Const terms
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILdip_massive_Icd,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    if (MassiveDipoleLoopKernels())
+        return fac*2.0*M_PI*NLOdip_kernel(Q, x, mf, DIPLOOP_L_ICD);
+    Cuba(Policy("LNLOdip_massive_Icd",ndim),ndim,integrand_ILdip_massive_Icd,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILdip_massive_Icd,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::LNLOqgunsub_massive(double Q, double x, double mf) {
     double integral, error, prob;
     // const int ndim=5; // 5 + 2*2 deterministic cuhre dimensions from G_qg*G_qg evaluated inside the integral
     const int ndim=9; // MC full phase space
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILqgunsub_massive,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    Cuba(Policy("LNLOqgunsub_massive",ndim),ndim,integrand_ILqgunsub_massive,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsub_massive,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::LNLOqgunsub_massive_I1(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=5; 
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ILqgunsub_massive_I1,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    Cuba(Policy("LNLOqgunsub_massive_I1",ndim),ndim,integrand_ILqgunsub_massive_I1,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsub_massive_I1,userdata));
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::LNLOqgunsub_massive_I2(double Q, double x, double mf) {
@@ -2426,21 +3689,19 @@ double ComputeSigmaR::LNLOqgunsub_massive_I2(double Q, double x, double mf) {
     int ndim;
     // const int ndim=7; // MC 5+2 phase space
     // const int ndim=6; // fast MC 5+1 phase space
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
     if (nlodis_config::PERF_MODE == nlodis_config::DISABLED) {
         ndim = 7;
-        Cuba(cubamethod,ndim,integrand_ILqgunsub_massive_I2,&userdata,&integral,&error,&prob);
+        Cuba(Policy("LNLOqgunsub_massive_I2",ndim),ndim,integrand_ILqgunsub_massive_I2,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsub_massive_I2,userdata));
     } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_EXPLICIT_BESSEL_DIM_REDUCTION) {
         ndim = 6;
-        Cuba(cubamethod,ndim,integrand_ILqgunsub_massive_I2_fast,&userdata,&integral,&error,&prob);
+        Cuba(Policy("LNLOqgunsub_massive_I2",ndim),ndim,integrand_ILqgunsub_massive_I2_fast,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsub_massive_I2_fast,userdata));
+    } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_TABULATED_G) {
+        ndim = 5; // y_t integrals in the G tables
+        Cuba(Policy("LNLOqgunsub_massive_I2",ndim),ndim,integrand_ILqgunsub_massive_I2_fast,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsub_massive_I2_fast,userdata));
     }
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::LNLOqgunsub_massive_I3(double Q, double x, double mf) {
@@ -2448,21 +3709,19 @@ double ComputeSigmaR::LNLOqgunsub_massive_I3(double Q, double x, double mf) {
     int ndim;
     // const int ndim=9; // MC full 5+2+2 phase space
     // const int ndim=7; // fast MC full 5+2 phase space
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
     if (nlodis_config::PERF_MODE == nlodis_config::DISABLED) {
         ndim = 9;
-        Cuba(cubamethod,ndim,integrand_ILqgunsub_massive_I3,&userdata,&integral,&error,&prob);
+        Cuba(Policy("LNLOqgunsub_massive_I3",ndim),ndim,integrand_ILqgunsub_massive_I3,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsub_massive_I3,userdata));
     } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_EXPLICIT_BESSEL_DIM_REDUCTION) {
         ndim = 7;
-        Cuba(cubamethod,ndim,integrand_ILqgunsub_massive_I3_fast,&userdata,&integral,&error,&prob);
+        Cuba(Policy("LNLOqgunsub_massive_I3",ndim),ndim,integrand_ILqgunsub_massive_I3_fast,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsub_massive_I3_fast,userdata));
+    } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_TABULATED_G) {
+        ndim = 5; // y_t integrals in the G tables
+        Cuba(Policy("LNLOqgunsub_massive_I3",ndim),ndim,integrand_ILqgunsub_massive_I3_fast,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ILqgunsub_massive_I3_fast,userdata));
     }
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    return Integrated(0, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 
@@ -2478,7 +3737,7 @@ double ComputeSigmaR::LNLOqgunsub_massive_I3(double Q, double x, double mf) {
 // NLO
 double ComputeSigmaR::ITdip(double Q, double z1, double x01sq) {
     double fac1 = z1*(1-z1)*(Sq(z1)+Sq(1.0 - z1));
-    double facNLO = Sq(Q*gsl_sf_bessel_K1(Q*sqrt(z1*(1-z1)*x01sq)));
+    double facNLO = Sq(Q*BesselK1(Q*sqrt(z1*(1-z1)*x01sq)));
     return fac1*facNLO;
 }
 
@@ -2493,7 +3752,7 @@ int integrand_ITdip(const int *ndim, const double x[], const int *ncomp, double
 
     double alphabar=Optr->Alphabar(x01sq);
     double alphfac=alphabar*CF/Nc;
-    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, dataptr->Qsq, x01sq);
     double SKernel = 1.0 - Optr->Sr(x01,Xrpdty_lo);
     double regconst = 5.0/2.0 - Sq(M_PI)/6.0;
     double res;
@@ -2508,13 +3767,37 @@ int integrand_ITdip(const int *ndim, const double x[], const int *ncomp, double
     return 0;
 }
 
+// The dipole term vanishes at x01=0 or z1=0,1, where the scalar integrand gives a non-finite result
+int integrand_ITdip_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    Userdata *dataptr = (Userdata*)userdata;
+    const double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    const int n=*nvec;
+    BatchColumns& c = BatchWorkspace(n);
+    LOCoordinates(x, *ndim, n, Q, 1e-300, c);
+    for (int i=0; i<n; i++){
+        c.alphabar[i] = Optr->Alphabar(c.x01sq[i]);
+        c.rpdty[i] = Optr->Xrpdty_DIP(dataptr->xbj, dataptr->Qsq, c.x01sq[i]);
+    }
+    Optr->Sr(&c.x01[0], &c.rpdty[0], &c.S[0], n);
+    BesselK1(&c.besselarg[0], &c.bessel[0], n);
+
+    const double regconst = 5.0/2.0 - Sq(M_PI)/6.0;
+    const double *z1=&c.z1[0], *x01=&c.x01[0], *arg=&c.arg[0], *bessel=&c.bessel[0], *S=&c.S[0], *alphabar=&c.alphabar[0];
+    for (int i=0; i<n; i++){
+        double alphfac = alphabar[i]*CF/Nc;
+        double res = (1.0-S[i])*z1[i]*(1.0-z1[i])*(Sq(z1[i])+Sq(1.0-z1[i]))*Sq(Q*bessel[i])*x01[i]*( alphfac*(0.5*Sq(log(z1[i]/(1-z1[i]))) + regconst ) );
+        f[i] = (arg[i] < 1e-300 || gsl_finite(res)!=1) ? 0 : res;
+    }
+    return 0;
+}
+
 int integrand_ITdip_z2(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     double res;
     if (z2min > 0.5){ // Check that z2min is not too large since z1 limits are [z2min , 1-z2min]. IF it is too large, return res=0.
         res = 0;
@@ -2544,7 +3827,8 @@ int integrand_ITdip_z2(const int *ndim, const double x[], const int *ncomp, doub
     return 0;
 }
 
-double ComputeSigmaR::Bessel1Tripole(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
+template<class Rho>
+double ComputeSigmaR::Bessel1Tripole_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
     double x01=sqrt(x01sq);
     double x02=sqrt(x02sq);
     double x21=sqrt(x21sq);
@@ -2552,9 +3836,9 @@ double ComputeSigmaR::Bessel1Tripole(double Q, double x, double z1, double z2, d
     double X3sq = z1*(1.0 - z1 - z2)*x01sq + z2*(1.0 - z1 - z2)*x02sq + z2*z1*x21sq;
 
     double Qsq = Sq(Q);
-    double x_x01 = cov_to_eta_x(x01, x, Qsq);
-    double x_x02 = cov_to_eta_x(x02, x, Qsq);
-    double x_x21 = cov_to_eta_x(x21, x, Qsq);
+    double x_x01 = cov_to_eta_x_t<Rho>(x01, x, Qsq);
+    double x_x02 = cov_to_eta_x_t<Rho>(x02, x, Qsq);
+    double x_x21 = cov_to_eta_x_t<Rho>(x21, x, Qsq);
 
     double bessel_innerfun = Q*sqrt(X3sq);
     double facNLO = 0;
@@ -2564,13 +3848,14 @@ double ComputeSigmaR::Bessel1Tripole(double Q, double x, double z1, double z2, d
     } else if (bessel_innerfun < 1e-30){
         return 1;
     }else{
-        facNLO = Sq(Q*gsl_sf_bessel_K1(bessel_innerfun));
+        facNLO = Sq(Q*BesselK1(bessel_innerfun));
     }
     double res = facNLO*(1-SrTripole(x01, x_x01, x02, x_x02, x21, x_x21));
     return res;
 }
 
-double ComputeSigmaR::ITNLOqg(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) { // old ITNLObeufQG
+template<class Rho>
+double ComputeSigmaR::ITNLOqg_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) { // old ITNLObeufQG
     double x20x21 = -0.5*(x01sq - x21sq - x02sq);
     double X3sq 	= z1*(1.0 - z1 - z2)*x01sq + z2*(1.0 - z1 - z2)*x02sq + z2*z1*x21sq;
 
@@ -2582,13 +3867,21 @@ double ComputeSigmaR::ITNLOqg(double Q, double x, double z1, double z2, double x
     double fac13 	= 1/x02sq - fun2;
     double fac3 	= Sq(xi)*(	fac11*fun2	+ 2*fac1*(1-xi)*x20x21/(x02sq*X3sq)	-	(1-z1)*(1-xi)*(z1+xi-z1*xi)/X3sq	);
 
-    double facNLO1 = Bessel1Tripole(Q, x, z1, z2, x01sq, x02sq, x21sq);
-    double facNLO2 = Bessel1Tripole(Q, x, z1, z2, x01sq, 0    , x01sq);
+    double facNLO1 = Bessel1Tripole_t<Rho>(Q, x, z1, z2, x01sq, x02sq, x21sq);
+    double facNLO2 = Bessel1Tripole_t<Rho>(Q, x, z1, z2, x01sq, 0    , x01sq);
 
     double res = fac1*((fac11*fac12*fac13)*(facNLO1 - facNLO2) + fac3*facNLO1);
     return res;
 }
 
+double ComputeSigmaR::Bessel1Tripole(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
+    return Bessel1Tripole_t<RuntimeRho>(Q, x, z1, z2, x01sq, x02sq, x21sq);
+}
+
+double ComputeSigmaR::ITNLOqg(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
+    return ITNLOqg_t<RuntimeRho>(Q, x, z1, z2, x01sq, x02sq, x21sq);
+}
+
 double ComputeSigmaR::ITNLOsigma3(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) {
     double impactfac_lo = ITLO(Q,z1,x01sq);
     double BKkernel = (K_kernel(x01sq,x02sq,x21sq) - 1.0)*2*K_lobk(x01sq,x02sq,x21sq);
@@ -2643,14 +3936,14 @@ double ComputeSigmaR::ITNLOqgRisto(double Q, double x, double z0, double z2, dou
 
     double facBesExpn, facBesExpo;
     if(Qbarn*sqrt(x01sq)>1e-8 && Qbarn*sqrt(x01sq)<5e2){
-        facBesExpn = Sq(Q*gsl_sf_bessel_K1(Qbarn*sqrt(x01sq)))*facExpn*SKernel;
+        facBesExpn = Sq(Q*BesselK1(Qbarn*sqrt(x01sq)))*facExpn*SKernel;
     }else{ facBesExpn = 0; }
     if(Qbaro*sqrt(x01sq)>1e-8 && Qbaro*sqrt(x01sq)<5e2){
-        facBesExpo = Sq(Q*gsl_sf_bessel_K1(Qbaro*sqrt(x01sq)))*facExpo*SKernel;
+        facBesExpo = Sq(Q*BesselK1(Qbaro*sqrt(x01sq)))*facExpo*SKernel;
     }else{ facBesExpo = 0; }
     //*/
-    //double facBesExpn = Sq(Q*gsl_sf_bessel_K1(Qbarn*sqrt(x01sq)))*std::exp(-x02sq/(std::exp(M_EULER)*x01sq))*SKernel;
-    //double facBesExpo = Sq(Q*gsl_sf_bessel_K1(Qbaro*sqrt(x01sq)))*std::exp(-x21sq/(std::exp(M_EULER)*x01sq))*SKernel;
+    //double facBesExpn = Sq(Q*BesselK1(Qbarn*sqrt(x01sq)))*std::exp(-x02sq/(std::exp(M_EULER)*x01sq))*SKernel;
+    //double facBesExpo = Sq(Q*BesselK1(Qbaro*sqrt(x01sq)))*std::exp(-x21sq/(std::exp(M_EULER)*x01sq))*SKernel;
 
     double term1 = factermF*( facBesselTrip - facBesExpn );
     double term2 = factermG*( facBesselTrip - facBesExpo );
@@ -2660,48 +3953,38 @@ double ComputeSigmaR::ITNLOqgRisto(double Q, double x, double z0, double z2, dou
     return res;
 }
 
-int integrand_ITqgunsub(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata) { // old integrand_ITbeufQGian
+template<class Scheme>
+int integrand_ITqgunsub_t(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata) { // old integrand_ITbeufQGian
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0; //0.01;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
     }
+    double jac=1.0-z2min; // z2, x01 and x02 jacobians from the variable maps
     double z1=(1.0-z2min)*x[0];
-    double z2=((1.0-z1)-z2min)*x[1]+z2min; // linear z_2 int
-    // double ymax = std::log(1-z1);
-    // double ymin = std::log(z2min);
-    // double y=(ymax-ymin)*x[1]+ymin;
-    // double z2=std::exp(y);
-    double x01=nlodis_config::MAXR*x[2];
-    double x02=nlodis_config::MAXR*x[3];
-    // double rhomax=std::log(nlodis_config::MAXR);
-    // double rhomin=std::log(nlodis_config::MINR);
-    // double rho01=(rhomax-rhomin)*x[2] + rhomin;
-    // double rho02=(rhomax-rhomin)*x[3] + rhomin;
-    // double x01=std::exp(rho01);
-    // double x02=std::exp(rho02);
+    double z2=QGMapZ2(dataptr->qgmap, x[1], z2min, 1.0-z1, jac);
+    double x01=QGMapR(dataptr->qgmap, x[2], jac);
+    double x02=QGMapR(dataptr->qgmap, x[3], jac);
     double phix0102=2.0*M_PI*x[4];
     double x01sq=Sq(x01);
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
-    double jac=(1.0-z2min)*(1.0-z1-z2min)*Sq(nlodis_config::MAXR); // linear z_2 int, linear in x01 x02
     // double jac=(1.0-z2min)*(ymax-ymin)*z2; // log z_2 int
     // double jac=(1.0-z2min)*(1.0-z1-z2min)*Sq(rhomax-rhomin)*x01*x02; // linear z_2 int, log x01, log x02
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Scheme::Xrpdty_NLO(Optr,dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     Alphasdata alphasdata;
     alphasdata.x01sq=x01sq;
     alphasdata.x02sq=x02sq;
     alphasdata.x21sq=x21sq;
-    double alphabar=Optr->Alphabar_QG( &alphasdata );
+    double alphabar=Scheme::Alphabar_QG(Optr, &alphasdata);
     double alphfac=alphabar*CF/Nc;
 
-    double res = jac*alphfac*( Optr->ITNLOqg(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq) )/z2*x01*x02;
+    double res = jac*alphfac*( Optr->ITNLOqg_t<typename Scheme::Rho>(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq) )/z2*x01*x02;
 
     if(gsl_finite(res)==1){
         *f=res;
@@ -2711,13 +3994,41 @@ int integrand_ITqgunsub(const int *ndim, const double x[], const int *ncomp, dou
     return 0;
 }
 
+int integrand_ITqgunsub(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata) {
+    return integrand_ITqgunsub_t<RuntimeScheme>(ndim, x, ncomp, f, userdata);
+}
+
+// The impact factors are evaluated point by point, they gather the tripole and Bessel functions of
+// both the x02 and x02=0 (z2->0 subtraction) configurations
+template<class Scheme>
+int integrand_ITqgunsub_batch_t(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    Userdata *dataptr = (Userdata*)userdata;
+    const double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    const int n=*nvec;
+    if (dataptr->z2min > 1.0){
+        for (int i=0; i<n; i++) f[i]=0;
+        return 0;
+    }
+    BatchColumns& c = BatchWorkspace(n);
+    QGCoordinates(x, *ndim, n, dataptr->z2min, dataptr->qgmap, c);
+    QGSchemeColumns<Scheme>(dataptr, n, c);
+    for (int i=0; i<n; i++)
+        c.impact[i] = Optr->ITNLOqg_t<typename Scheme::Rho>(Q, c.rpdty[i], c.z1[i], c.z2[i], c.x01sq[i], c.x02sq[i], c.x21sq[i]);
+    QGCombine(n, c, c.impact, f, 1);
+    return 0;
+}
+
+int integrand_ITqgunsub_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    return integrand_ITqgunsub_batch_t<RuntimeScheme>(ndim, x, ncomp, f, userdata, nvec, core);
+}
+
 int integrand_ITsigma3(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -2731,7 +4042,7 @@ int integrand_ITsigma3(const int *ndim, const double x[], const int *ncomp,doubl
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     Alphasdata alphasdata;
     alphasdata.x01sq=x01sq;
@@ -2750,40 +4061,40 @@ int integrand_ITsigma3(const int *ndim, const double x[], const int *ncomp,doubl
     return 0;
 }
 
-int integrand_ITqgsub(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata) {
+template<class Scheme>
+int integrand_ITqgsub_t(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min >= 1.0){ // Check that z2min is not too large. IF it is too large, return res=0.
         *f=0;
         return 0;
     }
+    double jac=1.0; // z2, x01 and x02 jacobians from the variable maps
     double z1=x[0];
-    double z2=(1.0-z2min)*x[1]+z2min;
-    double x01=nlodis_config::MAXR*x[2];
-    double x02=nlodis_config::MAXR*x[3];
+    double z2=QGMapZ2(dataptr->qgmap, x[1], z2min, 1.0, jac);
+    double x01=QGMapR(dataptr->qgmap, x[2], jac);
+    double x02=QGMapR(dataptr->qgmap, x[3], jac);
     double phix0102=2.0*M_PI*x[4];
     double x01sq=Sq(x01);
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
-    double jac=(1.0-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Scheme::Xrpdty_NLO(Optr,dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     Alphasdata alphasdata;
     alphasdata.x01sq=x01sq;
     alphasdata.x02sq=x02sq;
     alphasdata.x21sq=x21sq;
-    double alphabar=Optr->Alphabar_QG( &alphasdata );
+    double alphabar=Scheme::Alphabar_QG(Optr, &alphasdata);
     double alphfac=alphabar*CF/Nc;
 
     double ITNLOqg_z2 = 0;
     if (1-z1-z2 > 0){ // heaviside theta front factor on the full NLO term
-        ITNLOqg_z2 = (Optr->ITNLOqg(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq));
+        ITNLOqg_z2 = (Optr->ITNLOqg_t<typename Scheme::Rho>(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq));
     }
-    double ITNLOqg_z2_to_0 = Optr->ITNLOqg_subterm(Q,Xrpdt,z1,0,x01sq,x02sq,x21sq);
+    double ITNLOqg_z2_to_0 = Scheme::ITNLOqg_subterm(Optr,Q,Xrpdt,z1,0,x01sq,x02sq,x21sq);
 
     double res = jac*alphfac*(
                     ITNLOqg_z2
@@ -2799,6 +4110,10 @@ int integrand_ITqgsub(const int *ndim, const double x[], const int *ncomp, doubl
     return 0;
 }
 
+int integrand_ITqgsub(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata) {
+    return integrand_ITqgsub_t<RuntimeScheme>(ndim, x, ncomp, f, userdata);
+}
+
 int integrand_ITqgunsubRisto(const int *ndim, const double x[], const int *ncomp, double *f, void *userdata){
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
@@ -2872,91 +4187,71 @@ double ComputeSigmaR::TNLOdip(double Q, double x) { // old name: TNLObeufDIP
     double integral, error, prob;
     const int ndim=2;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITdip,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    if (nlodis_config::DIPOLE_LOOP_KERNELS)
+        return fac*2.0*M_PI*NLOdip_kernel(Q, x, 0, DIPLOOP_T);
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("TNLOdip",ndim),ndim,integrand_ITdip,&userdata,&integral,&error,&prob,integrand_ITdip_batch,GridKey(integrand_ITdip,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::TNLOdip_z2(double Q, double x) { // old name: TNLObeufDIP
     double integral, error, prob;
     const int ndim=3;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITdip_z2,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("TNLOdip_z2",ndim),ndim,integrand_ITdip_z2,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITdip_z2,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::TNLOqgunsub(double Q, double x) { // old TNLObeufQGiancu
-    double integral, error, prob;
-    const int ndim=5;
+    double integral, error;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITqgunsub,&userdata,&integral,&error,&prob);
-    // return 2*fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
-    return 2*fac*2.0*M_PI*integral; // removed x01 x02 integral jacobian --- use with logarithmic x01 x02 integral
+    Userdata userdata = PointContext(Q, x);
+    if (nlodis_config::QG_VARIABLE_MAPS)
+        QGPilotMap(this, ITqgunsub_integrand, &userdata, &userdata.qgmap, 1, Q, userdata.z2min);
+    if (nlodis_config::QG_CONTROL_VARIATE)
+        QGControlVariate("TNLOqgunsub", ITqgunsub_integrand, ITqgunsub_batch, ITqgunsub_subterm, ITqgunsub_subterm_z1,
+            userdata, 1, &integral, &error);
+    else
+        QGIntegrate("TNLOqgunsub", ITqgunsub_integrand, ITqgunsub_batch, userdata, 1, true, &integral, &error);
+    return Integrated(1, Q, 2*fac*2.0*M_PI*integral, integral, error); // x01, x02 jacobians from the variable maps
 }
 
 double ComputeSigmaR::TNLOsigma3(double Q, double x) {
     double integral, error, prob;
     const int ndim=5;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITsigma3,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("TNLOsigma3",ndim),ndim,integrand_ITsigma3,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITsigma3,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::TNLOqgsub(double Q, double x) {
-    double integral, error, prob;
-    const int ndim=5;
+    double integral, error;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITqgsub,&userdata,&integral,&error,&prob);
-    return 2*fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x);
+    if (nlodis_config::QG_VARIABLE_MAPS)
+        QGPilotMap(this, ITqgsub_integrand, &userdata, &userdata.qgmap, 1, Q, userdata.z2min);
+    QGIntegrate("TNLOqgsub", ITqgsub_integrand, NULL, userdata, 1, false, &integral, &error);
+    return Integrated(1, Q, 2*fac*2.0*M_PI*integral, integral, error);
 }
 
 double ComputeSigmaR::TNLOqgunsubRisto(double Q, double x) {
     double integral, error, prob;
     const int ndim=5;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITqgunsubRisto,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("TNLOqgunsubRisto",ndim),ndim,integrand_ITqgunsubRisto,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgunsubRisto,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::TNLOqgsubRisto(double Q, double x) {
     double integral, error, prob;
     const int ndim=5;
     double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITqgsubRisto,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("TNLOqgsubRisto",ndim),ndim,integrand_ITqgsubRisto,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgsubRisto,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 
@@ -2980,7 +4275,7 @@ int integrand_ITdip_massive_I1(const int *ndim, const double x[], const int *nco
 
     double alphabar=Optr->Alphabar(x01sq);
     double alphfac=alphabar*CF/Nc;
-    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, dataptr->Qsq, x01sq);
     double SKernel = 1.0 - Optr->Sr(x01,Xrpdty_lo);
     double res;
 
@@ -3006,7 +4301,7 @@ int integrand_ITdip_massive_I2(const int *ndim, const double x[], const int *nco
 
     double alphabar=Optr->Alphabar(x01sq);
     double alphfac=alphabar*CF/Nc;
-    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, dataptr->Qsq, x01sq);
     double SKernel = 1.0 - Optr->Sr(x01,Xrpdty_lo);
     double res;
 
@@ -3033,7 +4328,7 @@ int integrand_ITdip_massive_I3(const int *ndim, const double x[], const int *nco
 
     double alphabar=Optr->Alphabar(x01sq);
     double alphfac=alphabar*CF/Nc;
-    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, Sq(Q), x01sq);
+    double Xrpdty_lo = Optr->Xrpdty_DIP(xbj, dataptr->Qsq, x01sq);
     double SKernel = 1.0 - Optr->Sr(x01,Xrpdty_lo);
     double res;
 
@@ -3049,11 +4344,10 @@ int integrand_ITdip_massive_I3(const int *ndim, const double x[], const int *nco
 int integrand_ITqgunsub_massive_I1(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -3068,7 +4362,7 @@ int integrand_ITqgunsub_massive_I1(const int *ndim, const double x[], const int
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
     double SKernel_dipole = 1.0 - Optr->Sr(x01,Xrpdt);
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
@@ -3095,11 +4389,10 @@ int integrand_ITqgunsub_massive_I1(const int *ndim, const double x[], const int
 int integrand_ITqgunsub_massive_I2(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -3116,7 +4409,7 @@ int integrand_ITqgunsub_massive_I2(const int *ndim, const double x[], const int
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
     Alphasdata alphasdata;
@@ -3142,11 +4435,10 @@ int integrand_ITqgunsub_massive_I2(const int *ndim, const double x[], const int
 int integrand_ITqgunsub_massive_I2_fast(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -3157,13 +4449,13 @@ int integrand_ITqgunsub_massive_I2_fast(const int *ndim, const double x[], const
     double x01=nlodis_config::MAXR*x[2];
     double x02=nlodis_config::MAXR*x[3];
     double phix0102=2.0*M_PI*x[4];
-    double y_t1 = x[5];
+    double y_t1 = *ndim > 5 ? x[5] : 0; // No y_t dimension with the tabulated G functions
     // double y_u1 = x[6]; // not used in fast
     double x01sq=Sq(x01);
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
     Alphasdata alphasdata;
@@ -3188,11 +4480,10 @@ int integrand_ITqgunsub_massive_I2_fast(const int *ndim, const double x[], const
 int integrand_ITqgunsub_massive_I3(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -3211,7 +4502,7 @@ int integrand_ITqgunsub_massive_I3(const int *ndim, const double x[], const int
     double x02sq=Sq(x02);
     double x21sq=std::max(0.0, x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102));
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
@@ -3239,11 +4530,10 @@ int integrand_ITqgunsub_massive_I3(const int *ndim, const double x[], const int
 int integrand_ITqgunsub_massive_I3_fast(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) {
     Userdata *dataptr = (Userdata*)userdata;
     double Q=dataptr->Q;
-    double xbj=dataptr->xbj;
     double X0=dataptr->icX0;
     double mf=dataptr->qMass;
     ComputeSigmaR *Optr = dataptr->ComputerPtr;
-    double z2min = Optr->z2lower_bound(xbj,Sq(Q));
+    double z2min = dataptr->z2min;
     if (z2min > 1.0){ // Check that z2min is not too large. IF it is too large, return *f=0.
         *f=0;
         return 0;
@@ -3254,15 +4544,15 @@ int integrand_ITqgunsub_massive_I3_fast(const int *ndim, const double x[], const
     double x01=nlodis_config::MAXR*x[2];
     double x02=nlodis_config::MAXR*x[3];
     double phix0102=2.0*M_PI*x[4];
-    double y_t1 = x[5];
-    double y_t2 = x[6];
+    double y_t1 = *ndim > 5 ? x[5] : 0; // No y_t dimensions with the tabulated G functions
+    double y_t2 = *ndim > 6 ? x[6] : 0;
     // double y_u1 = x[7]; // not used in fast
     // double y_u2 = x[8]; // not used in fast
     double x01sq=Sq(x01);
     double x02sq=Sq(x02);
     double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
     double jac=(1.0-z2min)*(1.0-z1-z2min);
-    double Xrpdt= Optr->Xrpdty_NLO(Q*Q, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
+    double Xrpdt= Optr->Xrpdty_NLO(dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq); //z2min * X0/z2;
 
     double SKernel_tripole = 1.0 - Optr->SrTripole(x01,Xrpdt,x02,Xrpdt,sqrt(x21sq),Xrpdt);
 
@@ -3289,41 +4579,35 @@ int integrand_ITqgunsub_massive_I3_fast(const int *ndim, const double x[], const
 double ComputeSigmaR::TNLOdip_massive_I1(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=2;
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITdip_massive_I1,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    if (MassiveDipoleLoopKernels())
+        return fac*2.0*M_PI*NLOdip_kernel(Q, x, mf, DIPLOOP_T_I1);
+    Cuba(Policy("TNLOdip_massive_I1",ndim),ndim,integrand_ITdip_massive_I1,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITdip_massive_I1,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 
 double ComputeSigmaR::TNLOdip_massive_I2(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=3; // One more integral than in the Li & Log & Const terms
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITdip_massive_I2,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    if (MassiveDipoleLoopKernels())
+        return fac*2.0*M_PI*NLOdip_kernel(Q, x, mf, DIPLOOP_T_I2);
+    Cuba(Policy("TNLOdip_massive_I2",ndim),ndim,integrand_ITdip_massive_I2,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITdip_massive_I2,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::TNLOdip_massive_I3(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=4; // Two more integrals than in the Li & Log & Const terms
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITdip_massive_I3,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    if (MassiveDipoleLoopKernels())
+        return fac*2.0*M_PI*NLOdip_kernel(Q, x, mf, DIPLOOP_T_I3);
+    Cuba(Policy("TNLOdip_massive_I3",ndim),ndim,integrand_ITdip_massive_I3,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITdip_massive_I3,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral, integral, error);
 }
 
 
@@ -3331,15 +4615,10 @@ double ComputeSigmaR::TNLOdip_massive_I3(double Q, double x, double mf) {
 double ComputeSigmaR::TNLOqgunsub_massive_I1(double Q, double x, double mf) {
     double integral, error, prob;
     const int ndim=5; 
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
-    Cuba(cubamethod,ndim,integrand_ITqgunsub_massive_I1,&userdata,&integral,&error,&prob);
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
+    Cuba(Policy("TNLOqgunsub_massive_I1",ndim),ndim,integrand_ITqgunsub_massive_I1,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgunsub_massive_I1,userdata));
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::TNLOqgunsub_massive_I2(double Q, double x, double mf) {
@@ -3347,21 +4626,19 @@ double ComputeSigmaR::TNLOqgunsub_massive_I2(double Q, double x, double mf) {
     int ndim;
     // const int ndim=7; // MC 5+2 phase space
     // const int ndim=6; // fast MC 5+1 phase space
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
     if (nlodis_config::PERF_MODE == nlodis_config::DISABLED) {
         ndim = 7;
-        Cuba(cubamethod,ndim,integrand_ITqgunsub_massive_I2,&userdata,&integral,&error,&prob);
+        Cuba(Policy("TNLOqgunsub_massive_I2",ndim),ndim,integrand_ITqgunsub_massive_I2,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgunsub_massive_I2,userdata));
     } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_EXPLICIT_BESSEL_DIM_REDUCTION) {
         ndim = 6;
-        Cuba(cubamethod,ndim,integrand_ITqgunsub_massive_I2_fast,&userdata,&integral,&error,&prob);
+        Cuba(Policy("TNLOqgunsub_massive_I2",ndim),ndim,integrand_ITqgunsub_massive_I2_fast,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgunsub_massive_I2_fast,userdata));
+    } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_TABULATED_G) {
+        ndim = 5; // y_t integrals in the G tables
+        Cuba(Policy("TNLOqgunsub_massive_I2",ndim),ndim,integrand_ITqgunsub_massive_I2_fast,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgunsub_massive_I2_fast,userdata));
     }
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 double ComputeSigmaR::TNLOqgunsub_massive_I3(double Q, double x, double mf) {
@@ -3369,22 +4646,877 @@ double ComputeSigmaR::TNLOqgunsub_massive_I3(double Q, double x, double mf) {
     int ndim;
     // const int ndim=9; // MC full 5+2+2 phase space
     // const int ndim=7; // fast MC full 5+2 phase space
-    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(mf);
-    Userdata userdata;
-    userdata.Q=Q;
-    userdata.xbj=x;
-    userdata.icX0=icX0;
-    userdata.qMass=mf;
-    userdata.ComputerPtr=this;
+    Userdata userdata = PointContext(Q, x, mf);
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*userdata.sumef;
     if (nlodis_config::PERF_MODE == nlodis_config::DISABLED) {
         ndim = 9;
-        Cuba(cubamethod,ndim,integrand_ITqgunsub_massive_I3,&userdata,&integral,&error,&prob);
+        Cuba(Policy("TNLOqgunsub_massive_I3",ndim),ndim,integrand_ITqgunsub_massive_I3,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgunsub_massive_I3,userdata));
     } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_EXPLICIT_BESSEL_DIM_REDUCTION) {
         ndim = 7;
-        Cuba(cubamethod,ndim,integrand_ITqgunsub_massive_I3_fast,&userdata,&integral,&error,&prob);
+        Cuba(Policy("TNLOqgunsub_massive_I3",ndim),ndim,integrand_ITqgunsub_massive_I3_fast,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgunsub_massive_I3_fast,userdata));
+    } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_TABULATED_G) {
+        ndim = 5; // y_t integrals in the G tables
+        Cuba(Policy("TNLOqgunsub_massive_I3",ndim),ndim,integrand_ITqgunsub_massive_I3_fast,&userdata,&integral,&error,&prob,NULL,GridKey(integrand_ITqgunsub_massive_I3_fast,userdata));
     }
-    return fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral;
+    return Integrated(1, Q, fac*2.0*M_PI*nlodis_config::MAXR*nlodis_config::MAXR*integral, integral, error);
 }
 
 
 //*/
+
+
+
+///===========================================================================================
+// FUSED L + T
+// The longitudinal and transverse terms share the coordinates, the couplings, the dipoles
+// and the Bessel function arguments, and are integrated as components of one Cuba call.
+// Cuba stops when every component satisfies the precision goal.
+
+static void PrintComponentErrors(string name, double Q, double x, int ncomp, const double integral[], const double error[]){
+    if (!nlodis_config::VERBOSE) return;
+    cout << "# " << name << " Q=" << Q << " x=" << x << " relative errors:";
+    for (int i=0; i<ncomp; i++)
+        cout << " " << error[i]/std::abs(integral[i]);
+    cout << endl;
+}
+
+// LO impact factors at the initial condition and the dipole term, the photon wave functions
+// are the same for both:
+// ILLO = ILdip = 4 Q^2 z1^2 (1-z1)^2 K0^2, ITLO = ITdip = Q^2 z1 (1-z1)(z1^2+(1-z1)^2) K1^2
+int integrand_LTICdip(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    Userdata *dataptr = (Userdata*)userdata;
+    double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    double z1=x[0];
+    double x01=nlodis_config::MAXR*x[1];
+    double x01sq=Sq(x01);
+    double arg=Q*sqrt(z1*(1.0-z1)*x01sq);
+    double wfL=0, wfT=0;
+    if (arg > 0){
+        wfL = 4.0*Sq(z1)*Sq(1.0-z1)*Sq(Q*BesselK0(arg));
+        wfT = z1*(1.0-z1)*(Sq(z1)+Sq(1.0-z1))*Sq(Q*BesselK1(arg));
+    }
+
+    double Sic = Optr->Sr(x01, Optr->Xrpdty_LO(dataptr->icX0, dataptr->Qsq, x01sq));
+    double resT = (1.0-Sic)*wfT*x01;
+    f[0] = arg < 1e-7 ? 0 : (1.0-Sic)*wfL*x01;
+    f[1] = (arg < 1e-7 || gsl_finite(resT)!=1) ? 0 : resT;
+
+    double alphfac = Optr->Alphabar(x01sq)*CF/Nc;
+    double Sdip = Optr->Sr(x01, Optr->Xrpdty_DIP(dataptr->xbj, dataptr->Qsq, x01sq));
+    double regconst = 5.0/2.0 - Sq(M_PI)/6.0;
+    double zfac = alphfac*(0.5*Sq(log(z1/(1-z1))) + regconst);
+    double resLdip = (1.0-Sdip)*wfL*x01*zfac;
+    double resTdip = (1.0-Sdip)*wfT*x01*zfac;
+    f[2] = (arg > 0 && gsl_finite(resLdip)==1) ? resLdip : 0;
+    f[3] = (arg > 0 && gsl_finite(resTdip)==1) ? resTdip : 0;
+    return 0;
+}
+
+int integrand_LTICdip_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    Userdata *dataptr = (Userdata*)userdata;
+    const double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    const int n=*nvec;
+    BatchColumns& c = BatchWorkspace(n);
+    LOCoordinates(x, *ndim, n, Q, 1e-300, c);
+    for (int i=0; i<n; i++){
+        c.alphabar[i] = Optr->Alphabar(c.x01sq[i]);
+        c.rpdty[i] = Optr->Xrpdty_LO(dataptr->icX0, dataptr->Qsq, c.x01sq[i]);
+        c.rpdty2[i] = Optr->Xrpdty_DIP(dataptr->xbj, dataptr->Qsq, c.x01sq[i]);
+    }
+    Optr->Sr(&c.x01[0], &c.rpdty[0], &c.S[0], n);
+    Optr->Sr(&c.x01[0], &c.rpdty2[0], &c.S2[0], n);
+    BesselK0(&c.besselarg[0], &c.bessel[0], n);
+    BesselK1(&c.besselarg[0], &c.bessel2[0], n);
+
+    const double regconst = 5.0/2.0 - Sq(M_PI)/6.0;
+    for (int i=0; i<n; i++){
+        double z1 = c.z1[i];
+        double wfL = 4.0*Sq(z1)*Sq(1.0-z1)*Sq(Q*c.bessel[i]);
+        double wfT = z1*(1.0-z1)*(Sq(z1)+Sq(1.0-z1))*Sq(Q*c.bessel2[i]);
+        double resT = (1.0-c.S[i])*wfT*c.x01[i];
+        f[4*i] = c.arg[i] < 1e-7 ? 0 : (1.0-c.S[i])*wfL*c.x01[i];
+        f[4*i+1] = (c.arg[i] < 1e-7 || gsl_finite(resT)!=1) ? 0 : resT;
+
+        double zfac = c.alphabar[i]*CF/Nc*(0.5*Sq(log(z1/(1-z1))) + regconst);
+        double resLdip = (1.0-c.S2[i])*wfL*c.x01[i]*zfac;
+        double resTdip = (1.0-c.S2[i])*wfT*c.x01[i]*zfac;
+        f[4*i+2] = (c.arg[i] < 1e-300 || gsl_finite(resLdip)!=1) ? 0 : resLdip;
+        f[4*i+3] = (c.arg[i] < 1e-300 || gsl_finite(resTdip)!=1) ? 0 : resTdip;
+    }
+    return 0;
+}
+
+void ComputeSigmaR::LTICdip(double Q, double x, double res[4]) {
+    double integral[4], error[4], prob[4];
+    const int ndim=2, ncomp=4;
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
+    if (nlodis_config::PHOTON_OVERLAP_TABLES && nlodis_config::DIPOLE_LOOP_KERNELS){
+        // Both terms are 1D dipole size integrals, nothing left for Cuba
+        res[0] = fac*2.0*M_PI*LOp_overlap(Q, icX0, 0, 0);
+        res[1] = fac*2.0*M_PI*LOp_overlap(Q, icX0, 0, 1);
+        res[2] = fac*2.0*M_PI*NLOdip_kernel(Q, x, 0, DIPLOOP_L);
+        res[3] = fac*2.0*M_PI*NLOdip_kernel(Q, x, 0, DIPLOOP_T);
+        return;
+    }
+    Userdata userdata = PointContext(Q, x);
+    Cuba(Policy("LTICdip",ndim),ndim,ncomp,integrand_LTICdip,&userdata,integral,error,prob,integrand_LTICdip_batch,GridKey(integrand_LTICdip,userdata));
+    PrintComponentErrors("LTICdip", Q, x, ncomp, integral, error);
+    for (int i=0; i<ncomp; i++)
+        res[i] = Integrated(i%2, Q, fac*2.0*M_PI*nlodis_config::MAXR*integral[i], integral[i], error[i]);
+}
+
+// Photon wave function part of Bessel0Tripole_t and Bessel1Tripole_t, returns false if
+// the tripole factor is left out: the result vanishes for Q X3 > 200 and is 1 for Q X3 < 1e-30
+static bool TripoleWavefunctionsLT(double Q, double X3sq, double& wfL, double& wfT){
+    double bessel_innerfun = Q*sqrt(X3sq);
+    if (bessel_innerfun > 200){
+        wfL = wfT = 0;
+        return false;
+    } else if (bessel_innerfun < 1e-30){
+        wfL = wfT = 1;
+        return false;
+    }
+    wfL = 4.0*Sq(Q*BesselK0( bessel_innerfun ));
+    wfT = Sq(Q*BesselK1( bessel_innerfun ));
+    return true;
+}
+
+// Impact factors of ILNLOqg_t and ITNLOqg_t from the tripole factors of the x02 (1) and x02=0 (2) configurations
+static void QGImpactFactorsLT(double z1, double z2, double x01sq, double x02sq, double x21sq,
+    double facL1, double facT1, double facL2, double facT2, double& resL, double& resT){
+    double x20x21 = -0.5*(x01sq - x21sq - x02sq);
+    double X3sq = z1*(1.0 - z1 - z2)*x01sq + z2*(1.0 - z1 - z2)*x02sq + z2*z1*x21sq;
+    double xi = z2/(1.0-z1);
+    double fun2 = x20x21/(x02sq*x21sq);
+    double fac2 = 1/x02sq - fun2;
+
+    resL = Sq(z1)*Sq(1.0 - z1)*((1+Sq(1-xi))*fac2*(facL1 - facL2) + Sq(xi)*fun2*facL1);
+    if (gsl_finite(resL)!=1) resL = 0;
+
+    double fac1  = z1*(1.0 - z1);
+    double fac11 = Sq(z1)+Sq(1-z1);
+    double fac12 = 1+Sq(1-xi);
+    double fac3  = Sq(xi)*( fac11*fun2 + 2*fac1*(1-xi)*x20x21/(x02sq*X3sq) - (1-z1)*(1-xi)*(z1+xi-z1*xi)/X3sq );
+    resT = fac1*((fac11*fac12*fac2)*(facT1 - facT2) + fac3*facT1);
+}
+
+// Bessel0Tripole_t and Bessel1Tripole_t with a single tripole evaluation
+template<class Rho>
+void ComputeSigmaR::BesselTripoleLT_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq,
+    double& resL, double& resT) {
+    double X3sq = z1*(1.0 - z1 - z2)*x01sq + z2*(1.0 - z1 - z2)*x02sq + z2*z1*x21sq;
+    if (!TripoleWavefunctionsLT(Q, X3sq, resL, resT))
+        return;
+
+    double x01=sqrt(x01sq);
+    double x02=sqrt(x02sq);
+    double x21=sqrt(x21sq);
+    double Qsq = Sq(Q);
+    double x_x01 = cov_to_eta_x_t<Rho>(x01, x, Qsq);
+    double x_x02 = cov_to_eta_x_t<Rho>(x02, x, Qsq);
+    double x_x21 = cov_to_eta_x_t<Rho>(x21, x, Qsq);
+    double Skernel = 1-SrTripole(x01, x_x01, x02, x_x02, x21, x_x21);
+    resL *= Skernel;
+    resT *= Skernel;
+}
+
+// ILNLOqg_t and ITNLOqg_t
+template<class Rho>
+void ComputeSigmaR::INLOqgLT_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq,
+    double& resL, double& resT) {
+    double facL1, facT1, facL2, facT2;
+    BesselTripoleLT_t<Rho>(Q, x, z1, z2, x01sq, x02sq, x21sq, facL1, facT1);
+    BesselTripoleLT_t<Rho>(Q, x, z1, z2, x01sq, 0    , x01sq, facL2, facT2);
+    QGImpactFactorsLT(z1, z2, x01sq, x02sq, x21sq, facL1, facT1, facL2, facT2, resL, resT);
+}
+
+template<class Scheme>
+int integrand_LTqgunsub_t(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    Userdata *dataptr = (Userdata*)userdata;
+    double Q=dataptr->Q;
+    double X0=dataptr->icX0;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    double z2min = dataptr->z2min;
+    if (z2min > 1.0){
+        f[0]=f[1]=0;
+        return 0;
+    }
+    double jac=1.0-z2min; // z2, x01 and x02 jacobians from the variable maps
+    double z1=(1.0-z2min)*x[0];
+    double z2=QGMapZ2(dataptr->qgmap, x[1], z2min, 1.0-z1, jac);
+    double x01=QGMapR(dataptr->qgmap, x[2], jac);
+    double x02=QGMapR(dataptr->qgmap, x[3], jac);
+    double phix0102=2.0*M_PI*x[4];
+    double x01sq=Sq(x01);
+    double x02sq=Sq(x02);
+    double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
+
+    double Xrpdt= Scheme::Xrpdty_NLO(Optr,dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq);
+
+    Alphasdata alphasdata;
+    alphasdata.x01sq=x01sq;
+    alphasdata.x02sq=x02sq;
+    alphasdata.x21sq=x21sq;
+    double alphabar=Scheme::Alphabar_QG(Optr, &alphasdata);
+    double alphfac=alphabar*CF/Nc;
+
+    double impactL, impactT;
+    Optr->INLOqgLT_t<typename Scheme::Rho>(Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq,impactL,impactT);
+    double resL = jac*alphfac*impactL/z2*x01*x02;
+    double resT = jac*alphfac*impactT/z2*x01*x02;
+    f[0] = gsl_finite(resL)==1 ? resL : 0;
+    f[1] = gsl_finite(resT)==1 ? resT : 0;
+    return 0;
+}
+
+int integrand_LTqgunsub(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    return integrand_LTqgunsub_t<RuntimeScheme>(ndim, x, ncomp, f, userdata);
+}
+
+// z2->0 subtraction terms of the sub scheme in the variables of the unsubtracted qg integrands,
+// the control variates of the L (POL=0), T (POL=1) and fused LT (POL=2) unsub integrands
+template<class Scheme, int POL>
+int integrand_qgunsub_subterm_t(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    Userdata *dataptr = (Userdata*)userdata;
+    double Q=dataptr->Q;
+    double X0=dataptr->icX0;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    double z2min = dataptr->z2min;
+    if (z2min > 1.0){
+        for (int i=0; i<*ncomp; i++) f[i]=0;
+        return 0;
+    }
+    double jac=1.0-z2min; // z2, x01 and x02 jacobians from the variable maps
+    double z1=(1.0-z2min)*x[0];
+    double z2=QGMapZ2(dataptr->qgmap, x[1], z2min, 1.0-z1, jac);
+    double x01=QGMapR(dataptr->qgmap, x[2], jac);
+    double x02=QGMapR(dataptr->qgmap, x[3], jac);
+    double phix0102=2.0*M_PI*x[4];
+    double x01sq=Sq(x01);
+    double x02sq=Sq(x02);
+    double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
+
+    double Xrpdt= Scheme::Xrpdty_NLO(Optr,dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq);
+
+    Alphasdata alphasdata;
+    alphasdata.x01sq=x01sq;
+    alphasdata.x02sq=x02sq;
+    alphasdata.x21sq=x21sq;
+    double alphfac=Scheme::Alphabar_QG(Optr, &alphasdata)*CF/Nc;
+
+    int k=0;
+    if (POL != 1){
+        double resL = jac*alphfac*Scheme::ILNLOqg_subterm(Optr,Q,Xrpdt,z1,0,x01sq,x02sq,x21sq)/z2*x01*x02;
+        f[k++] = gsl_finite(resL)==1 ? resL : 0;
+    }
+    if (POL != 0){
+        double resT = jac*alphfac*Scheme::ITNLOqg_subterm(Optr,Q,Xrpdt,z1,0,x01sq,x02sq,x21sq)/z2*x01*x02;
+        f[k++] = gsl_finite(resT)==1 ? resT : 0;
+    }
+    return 0;
+}
+
+// The same integrated over z1, in (z2, x01, x02, phi) with a QGSubtermUserdata
+template<class Scheme, int POL>
+int integrand_qgunsub_subterm_z1_t(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    QGSubtermUserdata *sub = (QGSubtermUserdata*)userdata;
+    Userdata *dataptr = sub->point;
+    double Q=dataptr->Q;
+    double X0=dataptr->icX0;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    double z2min = dataptr->z2min;
+    if (z2min > 1.0){
+        for (int i=0; i<*ncomp; i++) f[i]=0;
+        return 0;
+    }
+    double jac=1.0; // z2, x01 and x02 jacobians from the variable maps
+    double z2=QGMapZ2(dataptr->qgmap, x[0], z2min, 1.0, jac);
+    double x01=QGMapR(dataptr->qgmap, x[1], jac);
+    double x02=QGMapR(dataptr->qgmap, x[2], jac);
+    double phix0102=2.0*M_PI*x[3];
+    double x01sq=Sq(x01);
+    double x02sq=Sq(x02);
+    double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
+
+    double Xrpdt= Scheme::Xrpdty_NLO(Optr,dataptr->Qsq, z2, z2min, X0, x01sq, x02sq, x21sq);
+
+    Alphasdata alphasdata;
+    alphasdata.x01sq=x01sq;
+    alphasdata.x02sq=x02sq;
+    alphasdata.x21sq=x21sq;
+    double alphfac=Scheme::Alphabar_QG(Optr, &alphasdata)*CF/Nc;
+
+    int k=0;
+    double z1;
+    if (POL != 1){
+        double w=QGSubtermZ1Weight(sub, Optr, 0, Q, z2, x01sq, z1);
+        double resL = w > 0 ? w*jac*alphfac*Scheme::ILNLOqg_subterm(Optr,Q,Xrpdt,z1,0,x01sq,x02sq,x21sq)/z2*x01*x02 : 0;
+        f[k++] = gsl_finite(resL)==1 ? resL : 0;
+    }
+    if (POL != 0){
+        double w=QGSubtermZ1Weight(sub, Optr, 1, Q, z2, x01sq, z1);
+        double resT = w > 0 ? w*jac*alphfac*Scheme::ITNLOqg_subterm(Optr,Q,Xrpdt,z1,0,x01sq,x02sq,x21sq)/z2*x01*x02 : 0;
+        f[k++] = gsl_finite(resT)==1 ? resT : 0;
+    }
+    return 0;
+}
+
+template<class Scheme>
+int integrand_LTqgunsub_batch_t(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    Userdata *dataptr = (Userdata*)userdata;
+    const double Q=dataptr->Q;
+    ComputeSigmaR *Optr = dataptr->ComputerPtr;
+    const int n=*nvec;
+    if (dataptr->z2min > 1.0){
+        for (int i=0; i<2*n; i++) f[i]=0;
+        return 0;
+    }
+    BatchColumns& c = BatchWorkspace(n);
+    QGCoordinates(x, *ndim, n, dataptr->z2min, dataptr->qgmap, c);
+    QGSchemeColumns<Scheme>(dataptr, n, c);
+    for (int i=0; i<n; i++)
+        Optr->INLOqgLT_t<typename Scheme::Rho>(Q, c.rpdty[i], c.z1[i], c.z2[i], c.x01sq[i], c.x02sq[i], c.x21sq[i],
+            c.impact[i], c.impact2[i]);
+    QGCombine(n, c, c.impact, f, 2);
+    QGCombine(n, c, c.impact2, f+1, 2);
+    return 0;
+}
+
+int integrand_LTqgunsub_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) {
+    return integrand_LTqgunsub_batch_t<RuntimeScheme>(ndim, x, ncomp, f, userdata, nvec, core);
+}
+
+void ComputeSigmaR::LTNLOqgunsub(double Q, double x, double res[2]) {
+    double integral[2], error[2];
+    const int ncomp=2;
+    double fac=4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef;
+    Userdata userdata = PointContext(Q, x);
+    if (nlodis_config::QG_VARIABLE_MAPS)
+        QGPilotMap(this, LTqgunsub_integrand, &userdata, &userdata.qgmap, ncomp, Q, userdata.z2min);
+    if (nlodis_config::QG_CONTROL_VARIATE)
+        QGControlVariate("LTNLOqgunsub", LTqgunsub_integrand, LTqgunsub_batch, LTqgunsub_subterm, LTqgunsub_subterm_z1,
+            userdata, ncomp, integral, error);
+    else
+        QGIntegrate("LTNLOqgunsub", LTqgunsub_integrand, LTqgunsub_batch, userdata, ncomp, true, integral, error);
+    PrintComponentErrors("LTNLOqgunsub", Q, x, ncomp, integral, error);
+    for (int i=0; i<ncomp; i++)
+        res[i] = Integrated(i, Q, 2*fac*2.0*M_PI*integral[i], integral[i], error[i]);
+}
+
+
+///===========================================================================================
+// SEVERAL XBJ AT ONE Q
+// The coordinates, couplings and photon wave functions do not depend on xbj, only the
+// dipoles do. All xbj are integrated in one Cuba call with components per xbj.
+
+struct MultiXUserdata{
+    std::vector<Userdata> points;   // PointContext of each xbj
+    double z2min;                   // Smallest z2 lower bound of the points
+    QGMap qgmap;                    // Variables of integrand_LTqgunsub_multix
+};
+
+// f[4i+k] = LO L, LO T, dip L, dip T at xbj[i]
+int integrand_LTLOdip_multix(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    MultiXUserdata *dataptr = (MultiXUserdata*)userdata;
+    const Userdata& point = dataptr->points[0];
+    double Q=point.Q;
+    ComputeSigmaR *Optr = point.ComputerPtr;
+    double z1=x[0];
+    double x01=nlodis_config::MAXR*x[1];
+    double x01sq=Sq(x01);
+    double arg=Q*sqrt(z1*(1.0-z1)*x01sq);
+    double wfL=0, wfT=0;
+    if (arg > 0){
+        wfL = 4.0*Sq(z1)*Sq(1.0-z1)*Sq(Q*BesselK0(arg));
+        wfT = z1*(1.0-z1)*(Sq(z1)+Sq(1.0-z1))*Sq(Q*BesselK1(arg));
+    }
+    double alphfac = Optr->Alphabar(x01sq)*CF/Nc;
+    double regconst = 5.0/2.0 - Sq(M_PI)/6.0;
+    double zfac = alphfac*(0.5*Sq(log(z1/(1-z1))) + regconst);
+
+    for (size_t i=0; i<dataptr->points.size(); i++){
+        const Userdata& p = dataptr->points[i];
+        double* fi = f + 4*i;
+        double Slo = Optr->Sr(x01, Optr->Xrpdty_LO(p.xbj, p.Qsq, x01sq));
+        double resT = (1.0-Slo)*wfT*x01;
+        fi[0] = arg < 1e-7 ? 0 : (1.0-Slo)*wfL*x01;
+        fi[1] = (arg < 1e-7 || gsl_finite(resT)!=1) ? 0 : resT;
+
+        double Sdip = Optr->Sr(x01, Optr->Xrpdty_DIP(p.xbj, p.Qsq, x01sq));
+        double resLdip = (1.0-Sdip)*wfL*x01*zfac;
+        double resTdip = (1.0-Sdip)*wfT*x01*zfac;
+        fi[2] = (arg > 0 && gsl_finite(resLdip)==1) ? resLdip : 0;
+        fi[3] = (arg > 0 && gsl_finite(resTdip)==1) ? resTdip : 0;
+    }
+    return 0;
+}
+
+// f[2i+k] = qg unsub L, T at xbj[i]. z2 is sampled above the smallest z2 lower bound,
+// and the points with a larger bound are cut at their own bound.
+int integrand_LTqgunsub_multix(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    MultiXUserdata *dataptr = (MultiXUserdata*)userdata;
+    const Userdata& point = dataptr->points[0];
+    double Q=point.Q;
+    ComputeSigmaR *Optr = point.ComputerPtr;
+    double z2min = dataptr->z2min;
+    if (z2min > 1.0){
+        for (int i=0; i<*ncomp; i++) f[i]=0;
+        return 0;
+    }
+    double jac=1.0-z2min; // z2, x01 and x02 jacobians from the variable maps
+    double z1=(1.0-z2min)*x[0];
+    double z2=QGMapZ2(dataptr->qgmap, x[1], z2min, 1.0-z1, jac);
+    double x01=QGMapR(dataptr->qgmap, x[2], jac);
+    double x02=QGMapR(dataptr->qgmap, x[3], jac);
+    double phix0102=2.0*M_PI*x[4];
+    double x01sq=Sq(x01);
+    double x02sq=Sq(x02);
+    double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
+    double x21=sqrt(x21sq);
+
+    Alphasdata alphasdata;
+    alphasdata.x01sq=x01sq;
+    alphasdata.x02sq=x02sq;
+    alphasdata.x21sq=x21sq;
+    double alphfac=RuntimeScheme::Alphabar_QG(Optr, &alphasdata)*CF/Nc;
+
+    // Photon wave functions of the x02 and the x02=0 configurations
+    double wfL1, wfT1, wfL2, wfT2;
+    bool tripole1 = TripoleWavefunctionsLT(Q, z1*(1.0 - z1 - z2)*x01sq + z2*(1.0 - z1 - z2)*x02sq + z2*z1*x21sq, wfL1, wfT1);
+    bool tripole2 = TripoleWavefunctionsLT(Q, z1*(1.0 - z1 - z2)*x01sq + z2*z1*x01sq, wfL2, wfT2);
+
+    for (size_t i=0; i<dataptr->points.size(); i++){
+        const Userdata& p = dataptr->points[i];
+        double* fi = f + 2*i;
+        if (z2 < p.z2min){
+            fi[0]=fi[1]=0;
+            continue;
+        }
+        double Xrpdt = RuntimeScheme::Xrpdty_NLO(Optr, p.Qsq, z2, p.z2min, p.icX0, x01sq, x02sq, x21sq);
+        double x_x01 = Optr->cov_to_eta_x_t<RuntimeRho>(x01, Xrpdt, p.Qsq);
+        double S1 = 1, S2 = 1;
+        if (tripole1)
+            S1 = 1-Optr->SrTripole(x01, x_x01, x02, Optr->cov_to_eta_x_t<RuntimeRho>(x02, Xrpdt, p.Qsq),
+                x21, Optr->cov_to_eta_x_t<RuntimeRho>(x21, Xrpdt, p.Qsq));
+        if (tripole2)
+            S2 = 1-Optr->SrTripole(x01, x_x01, 0, Optr->cov_to_eta_x_t<RuntimeRho>(0, Xrpdt, p.Qsq), x01, x_x01);
+
+        double impactL, impactT;
+        QGImpactFactorsLT(z1, z2, x01sq, x02sq, x21sq, wfL1*S1, wfT1*S1, wfL2*S2, wfT2*S2, impactL, impactT);
+        double resL = jac*alphfac*impactL/z2*x01*x02;
+        double resT = jac*alphfac*impactT/z2*x01*x02;
+        fi[0] = gsl_finite(resL)==1 ? resL : 0;
+        fi[1] = gsl_finite(resT)==1 ? resT : 0;
+    }
+    return 0;
+}
+
+MultiXUserdata ComputeSigmaR::MultiXContext(double Q, const std::vector<double>& xbj) {
+    MultiXUserdata userdata;
+    userdata.z2min = 2;
+    for (size_t i=0; i<xbj.size(); i++){
+        userdata.points.push_back(PointContext(Q, xbj[i]));
+        userdata.z2min = std::min(userdata.z2min, userdata.points.back().z2min);
+    }
+    userdata.qgmap = userdata.points[0].qgmap;
+    return userdata;
+}
+
+void ComputeSigmaR::Structf_LTLOdip_multix ( double Q , const std::vector<double>& xbj, std::vector<double>& F ) {
+    const int ndim=2, ncomp=4*xbj.size();
+    std::vector<double> integral(ncomp), error(ncomp), prob(ncomp);
+    double fac=structurefunfac*Sq(Q)*4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef*2.0*M_PI*nlodis_config::MAXR;
+    MultiXUserdata userdata = MultiXContext(Q, xbj);
+    Cuba(Policy("Structf_LTLOdip_multix",ndim),ndim,ncomp,integrand_LTLOdip_multix,&userdata,&integral[0],&error[0],&prob[0],NULL,GridKey(integrand_LTLOdip_multix,userdata.points[0]));
+    PrintComponentErrors("LTLOdip_multix", Q, xbj[0], ncomp, &integral[0], &error[0]);
+    F.resize(ncomp);
+    for (int i=0; i<ncomp; i++)
+        F[i] = fac*integral[i];
+}
+
+void ComputeSigmaR::Structf_LTNLOqg_unsub_multix ( double Q , const std::vector<double>& xbj, std::vector<double>& F ) {
+    const int ndim=5, ncomp=2*xbj.size();
+    std::vector<double> integral(ncomp), error(ncomp), prob(ncomp);
+    double fac=structurefunfac*Sq(Q)*2*4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef*2.0*M_PI;
+    MultiXUserdata userdata = MultiXContext(Q, xbj);
+    if (nlodis_config::QG_VARIABLE_MAPS)
+        QGPilotMap(this, integrand_LTqgunsub_multix, &userdata, &userdata.qgmap, ncomp, Q, userdata.z2min);
+    Cuba(Policy("Structf_LTNLOqg_unsub_multix",ndim),ndim,ncomp,integrand_LTqgunsub_multix,&userdata,&integral[0],&error[0],&prob[0],NULL,GridKey(integrand_LTqgunsub_multix,userdata.points[0]));
+    PrintComponentErrors("LTNLOqgunsub_multix", Q, xbj[0], ncomp, &integral[0], &error[0]);
+    F.resize(ncomp);
+    for (int i=0; i<ncomp; i++)
+        F[i] = fac*integral[i];
+}
+
+void ComputeSigmaR::Structf_NLOunsub_multix ( double Q , const std::vector<double>& xbj,
+    std::vector<double>& FL, std::vector<double>& FT ) {
+    // The IC term is the LO term at icX0
+    std::vector<double> xlo(xbj);
+    xlo.push_back(icX0);
+    std::vector<double> Flodip, Fqg;
+    Structf_LTLOdip_multix(Q, xlo, Flodip);
+    Structf_LTNLOqg_unsub_multix(Q, xbj, Fqg);
+    const int n = xbj.size();
+    double FLic = Flodip[4*n];
+    double FTic = Flodip[4*n+1];
+    FL.resize(n);
+    FT.resize(n);
+    for (int i=0; i<n; i++){
+        FL[i] = FLic + Flodip[4*i+2] + Fqg[2*i];
+        FT[i] = FTic + Flodip[4*i+3] + Fqg[2*i+1];
+    }
+}
+
+
+///===========================================================================================
+// SEVERAL QUARK MASSES AT ONE (Q, XBJ)
+// The terms of the massive structure functions with the same number of integration
+// variables are integrated in one Cuba call over shared samples, with a component per
+// term and quark mass. The masses can be of different flavours, the quark charge of each
+// mass is set by sumef_from_mass in PointContext.
+
+struct MultiMassUserdata{
+    std::vector<integrand_t> integrands;    // Massive integrand of each term
+    std::vector<Userdata> points;           // points[t*nmass+m]: term t at masses[m]
+    int nmass;
+};
+
+// f[t*nmass+m] = term t at masses[m]
+int integrand_multimass(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    MultiMassUserdata *dataptr = (MultiMassUserdata*)userdata;
+    const int one=1;
+    for (size_t c=0; c<dataptr->points.size(); c++)
+        dataptr->integrands[c/dataptr->nmass](ndim, x, &one, &f[c], &dataptr->points[c]);
+    return 0;
+}
+
+// Integrated terms of the massive structure functions, cf. Structf_NLOunsub_massive
+struct MassiveTerm{
+    integrand_t integrand;
+    int ndim;
+    int pol;        // 0: L, 1: T
+    bool ic;        // Evaluated at icX0
+    int maxrpow;    // Powers of nlodis_config::MAXR in the jacobian
+};
+
+static std::vector<MassiveTerm> MassiveTerms(bool nlo, bool withIC) {
+    std::vector<MassiveTerm> terms;
+    // With the photon overlap tables LO is added by Structf_massive_multimass
+    if ((!nlo || withIC) && !nlodis_config::PHOTON_OVERLAP_TABLES){
+        MassiveTerm lo[] = {
+            {integrand_ILLOpMass, 2, 0, nlo, 1},
+            {integrand_ITLOpMass, 2, 1, nlo, 1} };
+        terms.insert(terms.end(), lo, lo+2);
+    }
+    if (!nlo)
+        return terms;
+
+    // With the dipole-loop kernels the dip terms are added by Structf_massive_multimass
+    if (!MassiveDipoleLoopKernels()){
+        MassiveTerm dip[] = {
+            {integrand_ILdip_massive_LiLogConst, 2, 0, false, 1},
+            {integrand_ILdip_massive_Iab, 3, 0, false, 1},
+            {integrand_ILdip_massive_Icd, 4, 0, false, 1},
+            {integrand_ITdip_massive_I1, 2, 1, false, 1},
+            {integrand_ITdip_massive_I2, 3, 1, false, 1},
+            {integrand_ITdip_massive_I3, 4, 1, false, 1} };
+        terms.insert(terms.end(), dip, dip+6);
+    }
+    MassiveTerm qgI1[] = {
+        {integrand_ILqgunsub_massive_I1, 5, 0, false, 2},
+        {integrand_ITqgunsub_massive_I1, 5, 1, false, 2} };
+    terms.insert(terms.end(), qgI1, qgI1+2);
+    if (nlodis_config::PERF_MODE == nlodis_config::DISABLED){
+        MassiveTerm qg[] = {
+            {integrand_ILqgunsub_massive_I2, 7, 0, false, 2},
+            {integrand_ILqgunsub_massive_I3, 9, 0, false, 2},
+            {integrand_ITqgunsub_massive_I2, 7, 1, false, 2},
+            {integrand_ITqgunsub_massive_I3, 9, 1, false, 2} };
+        terms.insert(terms.end(), qg, qg+4);
+    } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_EXPLICIT_BESSEL_DIM_REDUCTION) {
+        MassiveTerm qg[] = {
+            {integrand_ILqgunsub_massive_I2_fast, 6, 0, false, 2},
+            {integrand_ILqgunsub_massive_I3_fast, 7, 0, false, 2},
+            {integrand_ITqgunsub_massive_I2_fast, 6, 1, false, 2},
+            {integrand_ITqgunsub_massive_I3_fast, 7, 1, false, 2} };
+        terms.insert(terms.end(), qg, qg+4);
+    } else if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_TABULATED_G) {
+        // Integrated together with the 5-dimensional I1 terms
+        MassiveTerm qg[] = {
+            {integrand_ILqgunsub_massive_I2_fast, 5, 0, false, 2},
+            {integrand_ILqgunsub_massive_I3_fast, 5, 0, false, 2},
+            {integrand_ITqgunsub_massive_I2_fast, 5, 1, false, 2},
+            {integrand_ITqgunsub_massive_I3_fast, 5, 1, false, 2} };
+        terms.insert(terms.end(), qg, qg+4);
+    }
+    return terms;
+}
+
+void ComputeSigmaR::Structf_massive_multimass ( double Q , double xbj, const std::vector<double>& masses,
+    std::vector<double>& FL, std::vector<double>& FT, bool nlo, bool withIC ) {
+    const int nmass = masses.size();
+    std::vector<MassiveTerm> terms = MassiveTerms(nlo, withIC);
+    FL.assign(nmass, 0);
+    FT.assign(nmass, 0);
+
+    if ((!nlo || withIC) && nlodis_config::PHOTON_OVERLAP_TABLES){
+        const double xlo = nlo ? icX0 : xbj;
+        for (int m=0; m<nmass; m++){
+            double fac = structurefunfac*Sq(Q)*4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(masses[m])*2.0*M_PI;
+            FL[m] += fac*LOp_overlap(Q, xlo, masses[m], 0);
+            FT[m] += fac*LOp_overlap(Q, xlo, masses[m], 1);
+        }
+    }
+
+    if (nlo && MassiveDipoleLoopKernels()){
+        for (int m=0; m<nmass; m++){
+            double fac = structurefunfac*Sq(Q)*4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef_from_mass(masses[m])*2.0*M_PI;
+            for (int t=DIPLOOP_L_LILOGCONST; t<=DIPLOOP_L_ICD; t++)
+                FL[m] += fac*NLOdip_kernel(Q, xbj, masses[m], t);
+            for (int t=DIPLOOP_T_I1; t<=DIPLOOP_T_I3; t++)
+                FT[m] += fac*NLOdip_kernel(Q, xbj, masses[m], t);
+        }
+    }
+
+    std::vector<bool> done(terms.size(), false);
+    for (size_t t0=0; t0<terms.size(); t0++){
+        if (done[t0])
+            continue;
+        // All remaining terms with the dimension of term t0
+        const int ndim = terms[t0].ndim;
+        std::vector<int> group;
+        MultiMassUserdata userdata;
+        userdata.nmass = nmass;
+        for (size_t t=t0; t<terms.size(); t++){
+            if (terms[t].ndim != ndim)
+                continue;
+            done[t] = true;
+            group.push_back(t);
+            userdata.integrands.push_back(terms[t].integrand);
+            for (int m=0; m<nmass; m++)
+                userdata.points.push_back(PointContext(Q, terms[t].ic ? icX0 : xbj, masses[m]));
+        }
+
+        const int ncomp = group.size()*nmass;
+        std::vector<double> integral(ncomp), error(ncomp), prob(ncomp);
+        Cuba(Policy("Structf_massive_multimass",ndim),ndim,ncomp,integrand_multimass,&userdata,&integral[0],&error[0],&prob[0],NULL,GridKey(integrand_multimass,userdata.points[0]));
+        PrintComponentErrors("massive_multimass", Q, xbj, ncomp, &integral[0], &error[0]);
+
+        for (size_t g=0; g<group.size(); g++){
+            const MassiveTerm& term = terms[group[g]];
+            for (int m=0; m<nmass; m++){
+                const Userdata& p = userdata.points[g*nmass + m];
+                double fac = structurefunfac*Sq(Q)*4.0*Nc*alphaem/Sq(2.0*M_PI)*p.sumef
+                    *2.0*M_PI*std::pow(nlodis_config::MAXR, term.maxrpow);
+                (term.pol == 0 ? FL : FT)[m] += fac*integral[g*nmass + m];
+                point_errsq[term.pol] += Sq(fac*error[g*nmass + m]);
+            }
+        }
+    }
+}
+
+
+///===========================================================================================
+// Scheme variants of the massless qg terms on the same samples
+struct QGVariantsUserdata{
+    std::vector<Userdata> points;   // Context of the ComputeSigmaR of each variant
+    std::vector<bool> sub;
+    int pol;
+};
+
+// The variants are evaluated in the variables of the sub scheme, z1 in [0,1] and z2 in [z2min,1],
+// with the theta function 1-z1-z2 > 0 of the full term. f[0] is the first variant, f[k] the
+// difference of variant k to it.
+int integrand_qg_variants(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) {
+    QGVariantsUserdata *data = (QGVariantsUserdata*)userdata;
+    const QGMap& map = data->points[0].qgmap;
+    for (int k=0; k<*ncomp; k++){
+        const Userdata& p = data->points[k];
+        ComputeSigmaR *Optr = p.ComputerPtr;
+        double res = 0;
+        if (p.z2min < 1.0){
+            double jac=1.0; // z2, x01 and x02 jacobians from the variable maps
+            double z1=x[0];
+            double z2=QGMapZ2(map, x[1], p.z2min, 1.0, jac);
+            double x01=QGMapR(map, x[2], jac);
+            double x02=QGMapR(map, x[3], jac);
+            double phix0102=2.0*M_PI*x[4];
+            double x01sq=Sq(x01);
+            double x02sq=Sq(x02);
+            double x21sq=x01sq+x02sq-2.0*sqrt(x01sq*x02sq)*cos(phix0102);
+            double Xrpdt= RuntimeScheme::Xrpdty_NLO(Optr, p.Qsq, z2, p.z2min, p.icX0, x01sq, x02sq, x21sq);
+
+            Alphasdata alphasdata;
+            alphasdata.x01sq=x01sq;
+            alphasdata.x02sq=x02sq;
+            alphasdata.x21sq=x21sq;
+            double alphfac=RuntimeScheme::Alphabar_QG(Optr, &alphasdata)*CF/Nc;
+
+            double full = 0, subterm = 0;
+            if (1-z1-z2 > 0)
+                full = (data->pol == 0) ? Optr->ILNLOqg_t<RuntimeRho>(p.Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq)
+                    : Optr->ITNLOqg_t<RuntimeRho>(p.Q,Xrpdt,z1,z2,x01sq,x02sq,x21sq);
+            if (data->sub[k])
+                subterm = (data->pol == 0) ? RuntimeScheme::ILNLOqg_subterm(Optr,p.Q,Xrpdt,z1,0,x01sq,x02sq,x21sq)
+                    : RuntimeScheme::ITNLOqg_subterm(Optr,p.Q,Xrpdt,z1,0,x01sq,x02sq,x21sq);
+            res = jac*alphfac*(full - subterm)/z2*x01*x02;
+            if (gsl_finite(res)!=1)
+                res = 0;
+        }
+        f[k] = (k == 0) ? res : res - f[0];
+    }
+    return 0;
+}
+
+// Coupling of the qg terms of the running coupling scheme rc, cf. MetaPrescriptionSetter
+static ComputeSigmaR::CmptrMemFn_void QGCoupling(nlodis_config::RunningCouplingDIS rc){
+    switch (rc){
+        case nlodis_config::DIS_RC_FIXED: return &ComputeSigmaR::alpha_bar_QG_fixed;
+        case nlodis_config::DIS_RC_PARENT: return &ComputeSigmaR::alpha_bar_QG_running_pd;
+        case nlodis_config::DIS_RC_GUILLAUME: return &ComputeSigmaR::alpha_bar_QG_running_guillaume;
+        case nlodis_config::DIS_RC_SMALLEST: return &ComputeSigmaR::alpha_bar_QG_running_smallest;
+    }
+    cout << "ERROR: Unknown running coupling " << rc << " of a qg scheme variant." << endl;
+    exit(1);
+}
+
+void ComputeSigmaR::Structf_qg_variants ( double Q , double xbj, int pol, const std::vector<QGSchemeVariant>& variants,
+    std::vector<double>& F, std::vector<double>& Ferr ) {
+    const int ndim=5, ncomp=variants.size();
+    double fac=structurefunfac*Sq(Q)*2*4.0*Nc*alphaem/Sq(2.0*M_PI)*sumef*2.0*M_PI;
+    // A copy of this computer per variant, with the coupling of the variant
+    std::vector<ComputeSigmaR> computers(ncomp, *this);
+    QGVariantsUserdata userdata;
+    userdata.pol = pol;
+    for (int k=0; k<ncomp; k++){
+        computers[k].SetRunningCoupling_QG(QGCoupling(variants[k].rc));
+        userdata.sub.push_back(variants[k].sub);
+    }
+    for (int k=0; k<ncomp; k++)
+        userdata.points.push_back(computers[k].PointContext(Q, xbj));
+    Userdata& first = userdata.points[0];
+    if (nlodis_config::QG_VARIABLE_MAPS)
+        QGPilotMap(this, pol == 0 ? computers[0].ILqgunsub_integrand : computers[0].ITqgunsub_integrand,
+            &first, &first.qgmap, 1, Q, first.z2min);
+
+    // The differences converge with the absolute accuracy asked of the first variant
+    IntegratorPolicy policy = Policy("Structf_qg_variants", ndim);
+    {
+        const int n = std::max(nlodis_config::QG_PILOT_EVALS, 1);
+        std::mt19937 gen(1);
+        std::uniform_real_distribution<double> rnd(0, 1);
+        std::vector<double> f(ncomp);
+        double sum = 0;
+        for (int i=0; i<n; i++){
+            double u[ndim];
+            for (int k=0; k<ndim; k++)
+                u[k] = rnd(gen);
+            integrand_qg_variants(&ndim, u, &ncomp, &f[0], &userdata);
+            sum += f[0];
+        }
+        policy.epsabs = std::max(policy.epsabs, policy.epsrel*std::abs(sum/n));
+    }
+
+    std::vector<double> integral(ncomp), error(ncomp), prob(ncomp);
+    Cuba(policy,ndim,ncomp,integrand_qg_variants,&userdata,&integral[0],&error[0],&prob[0]);
+    PrintComponentErrors("qg_variants", Q, xbj, ncomp, &integral[0], &error[0]);
+    F.resize(ncomp);
+    Ferr.resize(ncomp);
+    for (int k=0; k<ncomp; k++){
+        F[k] = fac*integral[k];
+        Ferr[k] = fac*error[k];
+    }
+}
+
+///===========================================================================================
+// Selection of the scheme specialized qg integrands
+template<class Scheme>
+void AssignUnsubIntegrands(ComputeSigmaR* O){
+    O->ILqgunsub_integrand = integrand_ILqgunsub_t<Scheme>;
+    O->ITqgunsub_integrand = integrand_ITqgunsub_t<Scheme>;
+    O->ILqgunsub_batch = integrand_ILqgunsub_batch_t<Scheme>;
+    O->ITqgunsub_batch = integrand_ITqgunsub_batch_t<Scheme>;
+    O->LTqgunsub_integrand = integrand_LTqgunsub_t<Scheme>;
+    O->LTqgunsub_batch = integrand_LTqgunsub_batch_t<Scheme>;
+}
+
+template<class Scheme>
+void AssignSubIntegrands(ComputeSigmaR* O){
+    O->ILqgsub_integrand = integrand_ILqgsub_t<Scheme>;
+    O->ITqgsub_integrand = integrand_ITqgsub_t<Scheme>;
+    O->ILqgunsub_subterm = integrand_qgunsub_subterm_t<Scheme, 0>;
+    O->ITqgunsub_subterm = integrand_qgunsub_subterm_t<Scheme, 1>;
+    O->LTqgunsub_subterm = integrand_qgunsub_subterm_t<Scheme, 2>;
+    O->ILqgunsub_subterm_z1 = integrand_qgunsub_subterm_z1_t<Scheme, 0>;
+    O->ITqgunsub_subterm_z1 = integrand_qgunsub_subterm_z1_t<Scheme, 1>;
+    O->LTqgunsub_subterm_z1 = integrand_qgunsub_subterm_z1_t<Scheme, 2>;
+}
+
+template<nlodis_config::RunningCouplingDIS RC, nlodis_config::TargetRapidityBKRhoPresc RHO, bool TARGET_ETA>
+void SelectSubTermIntegrands(ComputeSigmaR* O){
+    // The unsub integrands do not depend on the subtraction term
+    AssignUnsubIntegrands< StaticScheme<RC, RHO, TARGET_ETA, nlodis_config::SUBTERM_LOBK_Z2TOZERO> >(O);
+    switch (nlodis_config::SUB_TERM_KERNEL){
+        case nlodis_config::SUBTERM_LOBK_Z2TOZERO:
+            AssignSubIntegrands< StaticScheme<RC, RHO, TARGET_ETA, nlodis_config::SUBTERM_LOBK_Z2TOZERO> >(O); break;
+        case nlodis_config::SUBTERM_LOBK_EXPLICIT:
+            AssignSubIntegrands< StaticScheme<RC, RHO, TARGET_ETA, nlodis_config::SUBTERM_LOBK_EXPLICIT> >(O); break;
+        case nlodis_config::SUBTERM_RESUM:
+            AssignSubIntegrands< StaticScheme<RC, RHO, TARGET_ETA, nlodis_config::SUBTERM_RESUM> >(O); break;
+        case nlodis_config::SUBTERM_KCBK_BEUF:
+            AssignSubIntegrands< StaticScheme<RC, RHO, TARGET_ETA, nlodis_config::SUBTERM_KCBK_BEUF> >(O); break;
+        case nlodis_config::SUBTERM_TRBK_EDMOND:
+            AssignSubIntegrands< StaticScheme<RC, RHO, TARGET_ETA, nlodis_config::SUBTERM_TRBK_EDMOND> >(O); break;
+    }
+}
+
+template<nlodis_config::RunningCouplingDIS RC, nlodis_config::TargetRapidityBKRhoPresc RHO>
+void SelectRapidityIntegrands(ComputeSigmaR* O){
+    if (config::KINEMATICAL_CONSTRAINT == config::KC_EDMOND_K_MINUS)
+        SelectSubTermIntegrands<RC, RHO, true>(O);
+    else
+        SelectSubTermIntegrands<RC, RHO, false>(O);
+}
+
+template<nlodis_config::RunningCouplingDIS RC>
+void SelectRhoIntegrands(ComputeSigmaR* O){
+    switch (nlodis_config::TRBK_RHO_PRESC){
+        case nlodis_config::TRBK_RHO_DISABLED: SelectRapidityIntegrands<RC, nlodis_config::TRBK_RHO_DISABLED>(O); break;
+        case nlodis_config::TRBK_RHO_QQ0: SelectRapidityIntegrands<RC, nlodis_config::TRBK_RHO_QQ0>(O); break;
+        case nlodis_config::TRBK_RHO_RQ0: SelectRapidityIntegrands<RC, nlodis_config::TRBK_RHO_RQ0>(O); break;
+        case nlodis_config::TRBK_RHO_X_R: SelectRapidityIntegrands<RC, nlodis_config::TRBK_RHO_X_R>(O); break;
+        case nlodis_config::TRBK_RHO_MAX_X_Y_R: SelectRapidityIntegrands<RC, nlodis_config::TRBK_RHO_MAX_X_Y_R>(O); break;
+    }
+}
+
+void ComputeSigmaR::UseRuntimeIntegrands(){
+    ILqgunsub_integrand = integrand_ILqgunsub;
+    ITqgunsub_integrand = integrand_ITqgunsub;
+    ILqgunsub_batch = integrand_ILqgunsub_batch;
+    ITqgunsub_batch = integrand_ITqgunsub_batch;
+    LTqgunsub_integrand = integrand_LTqgunsub;
+    LTqgunsub_batch = integrand_LTqgunsub_batch;
+    ILqgsub_integrand = integrand_ILqgsub;
+    ITqgsub_integrand = integrand_ITqgsub;
+    ILqgunsub_subterm = integrand_qgunsub_subterm_t<RuntimeScheme, 0>;
+    ITqgunsub_subterm = integrand_qgunsub_subterm_t<RuntimeScheme, 1>;
+    LTqgunsub_subterm = integrand_qgunsub_subterm_t<RuntimeScheme, 2>;
+    ILqgunsub_subterm_z1 = integrand_qgunsub_subterm_z1_t<RuntimeScheme, 0>;
+    ITqgunsub_subterm_z1 = integrand_qgunsub_subterm_z1_t<RuntimeScheme, 1>;
+    LTqgunsub_subterm_z1 = integrand_qgunsub_subterm_z1_t<RuntimeScheme, 2>;
+}
+
+void ComputeSigmaR::SetSchemeIntegrands(){
+    switch (nlodis_config::RC_DIS){
+        case nlodis_config::DIS_RC_FIXED: SelectRhoIntegrands<nlodis_config::DIS_RC_FIXED>(this); break;
+        case nlodis_config::DIS_RC_PARENT: SelectRhoIntegrands<nlodis_config::DIS_RC_PARENT>(this); break;
+        case nlodis_config::DIS_RC_SMALLEST: SelectRhoIntegrands<nlodis_config::DIS_RC_SMALLEST>(this); break;
+        case nlodis_config::DIS_RC_GUILLAUME: SelectRhoIntegrands<nlodis_config::DIS_RC_GUILLAUME>(this); break;
+        default:
+            UseRuntimeIntegrands();
+            return;
+    }
+    cout << "# Using scheme specialized qg integrands" << endl;
+}
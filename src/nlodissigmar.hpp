@@ -4,6 +4,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <cmath>
 #include <Minuit2/FCNBase.h>
 #include <Minuit2/MnUserParameterState.h>
 
@@ -16,8 +18,11 @@
 #include "dipole.hpp"
 #include "solver.hpp"
 #include "nlodis_config.hpp"
+#include "dipoleevaluator.hpp"
+#include "massinterpolation.hpp"
 
 #include "cuba-4.2.h"
+#include "vegasgrid.hpp"
 #include "data.hpp"
 
 #define PARALLEL_CHISQR
@@ -28,6 +33,26 @@ using namespace std;
 
 static inline double Sq(double x){return x*x;}
 
+// Cuba integrand evaluating *nvec points per call, x[i*ndim+k] and f[i*ncomp+j]
+typedef int (*batch_integrand_t)(const int *ndim, const double x[], const int *ncomp,
+    double f[], void *userdata, const int *nvec, const int *core);
+
+// Integration method ("vegas", "suave", "divonne", "cuhre" or "qmc") and accuracy goals of a term
+struct IntegratorPolicy
+{
+    string method;
+    double epsrel;
+    int maxeval;
+    double epsabs;  // Converged if the error is below epsabs or epsrel |integral|
+};
+
+// Scheme of a massless qg term in Structf_qg_variants
+struct QGSchemeVariant
+{
+    bool sub;                                   // qg_sub, or qg_unsub
+    nlodis_config::RunningCouplingDIS rc;       // Coupling of the qg term, cf. RC_DIS
+};
+
 //namespace sigmar_config{extern double maxy;}
 
 class NLODISFitter : public FCNBase
@@ -48,18 +73,31 @@ public:
     void UseImprovedZ2Bound(bool b) { useImprovedZ2Bound = b;}
     void UseConsistentlyBoundLoopTerm(bool b) { useBoundLoop = b;}
     void SetCubaMethod(string s) { cubaMethod = s; }
+    // Integrator of one term, see ComputeSigmaR::Policy
+    // Exits if term is not one of ComputeSigmaR::IsPolicyTerm
+    void SetTermPolicy(string term, IntegratorPolicy p);
 
 
 private:
 
     bool computeNLO, UseSub, UseSigma3, useImprovedZ2Bound, useBoundLoop;
     string cubaMethod;
+    std::map<string, IntegratorPolicy> termPolicies;
     MnUserParameters parameters;
     vector<Data*> datasets;
 
+    // Charm mass table of the last chi^2 evaluation (nlodis_config::MASS_TABLE)
+    mutable MassInterpolationTable masstable;
+    mutable vector<double> masstable_par;       // Parameters of the table, mass_charm set to 0
+    mutable vector<double> masstable_structf;   // F = {FL, FT} without charm per unique (Q^2, x)
+    mutable vector<double> masstable_structf_err;   // and their integration errors
+
 };
 
 
+struct Userdata;
+struct MultiXUserdata;
+
 class ComputeSigmaR
 {
 public:
@@ -78,6 +116,7 @@ public:
 
 
     ComputeSigmaR(AmplitudeLib *ObjectPointer);
+    ComputeSigmaR(DipoleAmplitudeView *ViewPointer);    // Use the solver's Dipole directly, no copy
 
     double SigmarLO ( double Q , double xbj, double y) ;
     double SigmarLOmass ( double Q , double xbj, double y, bool charm=false) ;
@@ -91,6 +130,21 @@ public:
     double SigmarNLOunsubRisto ( double Q , double xbj, double y) ;
     double SigmarNLOsubRisto ( double Q , double xbj, double y) ;
 
+    // sigma_r = F2 - y^2/(1+(1-y)^2) FL from F = {FL, FT}
+    static double SigmarFromStructf ( const double F[2], double y) ;
+
+    // Structure functions F = {FL, FT} of the Sigmar functions above. The IC term
+    // Structf_IC(Q) of the unsub scheme only depends on Q and can be given in Fic,
+    // it is not used by the fused integration of Structf_NLOunsub.
+    void Structf_LO ( double Q , double xbj, double F[2]) ;
+    void Structf_IC ( double Q , double F[2], double mf=0) ;
+    void Structf_NLOunsub ( double Q , double xbj, double F[2], const double* Fic=NULL) ;
+    void Structf_NLOunsub_massive ( double Q , double xbj, double mf, double F[2], const double* Fic=NULL) ;
+    void Structf_NLOunsub_UniformZ2Bound ( double Q , double xbj, double F[2], const double* Fic=NULL) ;
+    void Structf_NLOunsub_sigma3 ( double Q , double xbj, double F[2]) ;
+    void Structf_NLOsub ( double Q , double xbj, double F[2]) ;
+    void Structf_NLOsub_UniformZ2Bound ( double Q , double xbj, double F[2]) ;
+
     double Structf_LLO ( double Q , double xbj) ;
     double Structf_TLO ( double Q , double xbj) ;
     double Structf_LNLOdip ( double Q , double xbj) ;
@@ -113,6 +167,31 @@ public:
     double Structf_LNLOqg_unsub_massive ( double Q , double xbj, double mf) ;
     double Structf_TNLOqg_unsub_massive ( double Q , double xbj, double mf) ;
 
+    // L and T from one integration: F = {FL, FT} and F = {FLic, FTic, FLdip, FTdip}, IC at icX0
+    void Structf_LTNLOqg_unsub ( double Q , double xbj, double F[2]) ;
+    void Structf_LTICdip ( double Q , double xbj, double F[4]) ;
+
+    // Several xbj at one Q in one integration per term, the xbj independent parts of the
+    // integrands are evaluated once per sample.
+    // F[4i+k] = {FL_LO, FT_LO, FL_dip, FT_dip} and F[2i+k] = {FL_qg, FT_qg} of xbj[i]
+    void Structf_LTLOdip_multix ( double Q , const std::vector<double>& xbj, std::vector<double>& F) ;
+    void Structf_LTNLOqg_unsub_multix ( double Q , const std::vector<double>& xbj, std::vector<double>& F) ;
+    // Unsub scheme FL, FT at each xbj, cf. Structf_NLOunsub
+    void Structf_NLOunsub_multix ( double Q , const std::vector<double>& xbj, std::vector<double>& FL, std::vector<double>& FT) ;
+
+    // The massless qg term of FL (pol=0) or FT (pol=1) in several schemes integrated on the same
+    // samples: F[0] is the first variant and F[k] the difference of variant k to it. As the
+    // variants are correlated, the errors Ferr of the differences are much smaller than those of
+    // independent integrations. The variants share the z2min, rapidity and rho prescriptions.
+    void Structf_qg_variants ( double Q , double xbj, int pol, const std::vector<QGSchemeVariant>& variants,
+        std::vector<double>& F, std::vector<double>& Ferr) ;
+
+    // Several quark masses at one (Q, xbj), the terms with the same number of integration variables
+    // are integrated over shared samples. FL[i], FT[i] of masses[i] (charm, bottom, or a mass scan):
+    // NLO unsub as Structf_NLOunsub_massive, with the IC term at icX0 if withIC, or LO at xbj if !nlo
+    void Structf_massive_multimass ( double Q , double xbj, const std::vector<double>& masses,
+        std::vector<double>& FL, std::vector<double>& FT, bool nlo=true, bool withIC=true) ;
+
     double Structf_LFULLNLOunsub ( double Q , double xbj) ; // no dipole term in these 4 for now.
     double Structf_TFULLNLOunsub ( double Q , double xbj) ;
     double Structf_LFULLNLOsub ( double Q , double xbj) ;
@@ -124,19 +203,22 @@ public:
     void SetX0(double x0_){ icX0 = x0_; }
     void SetX0_BK(double x0_){ icX0_bk = x0_; }
     void SetQ0Sqr(double q0_){ icQ0sqr = q0_; }
-    void SetY0(double y0_){ icY0 = y0_; }
+    void SetY0(double y0_){ icY0 = y0_; exp_icY0 = std::exp(-y0_); }
+    // Tabulated dipole used in Sr and SrY if set, must be built with the same x0_bk and y0
+    void SetDipoleEvaluator(DipoleEvaluator* ev){ FastDipolePointer = ev; }
 
     void SetRunningCoupling(CmptrMemFn p){AlphabarPTR = p;} // function pointer setter
-    void SetRunningCoupling_QG(CmptrMemFn_void p){Alphabar_QG_PTR = p;} // function pointer setter
+    void SetRunningCoupling_QG(CmptrMemFn_void p){Alphabar_QG_PTR = p; UseRuntimeIntegrands();} // function pointer setter
 
     void SetImprovedZ2Bound(z2funpointer p){z2limit_PTR = p;} // function pointer setter
     void SetEvolutionX_LO(xrapidity_y_eta_funpointer p){Xrpdty_LO_PTR = p;}
     void SetEvolutionX_LO_z2scheme(xrapidity_funpointer p){Xrpdty_LO_projectileY_z2min_PTR = p;}
     void SetEvolutionX_DIP(xrapidity_y_eta_funpointer p){Xrpdty_DIP_PTR = p;}
-    void SetEvolutionX_NLO(xrapidity_NLO_funpointer p){Xrpdty_NLO_PTR = p;}
+    void SetEvolutionX_NLO(xrapidity_NLO_funpointer p){Xrpdty_NLO_PTR = p; UseRuntimeIntegrands();}
 
     void SetSigma3BKKernel(bkkernel_funpointer p){K_kernel_PTR = p;} // function pointer setter
     void SetSubTermKernel(nlodis_config::SubSchemeTermKernel sstk){
+        UseRuntimeIntegrands();
         if (sstk == nlodis_config::SUBTERM_LOBK_Z2TOZERO){
             ILNLOqg_subterm_PTR = &ComputeSigmaR::ILNLOqg_subterm_lobk_z2tozero;
             ITNLOqg_subterm_PTR = &ComputeSigmaR::ITNLOqg_subterm_lobk_z2tozero;
@@ -155,6 +237,7 @@ public:
         }
     }
     void SetTRBKRhoPrescription(nlodis_config::TargetRapidityBKRhoPresc rhopresc){
+        UseRuntimeIntegrands();
         if (rhopresc == nlodis_config::TRBK_RHO_QQ0){
 	        rho_PTR = &ComputeSigmaR::rho_rapidity_shift_QQ0;
 	        cout << "# TRBK RHO is TRBK_RHO_QQ0" << endl; }
@@ -274,16 +357,53 @@ public:
         
         // trbk rho prescription
         this->SetTRBKRhoPrescription(nlodis_config::TRBK_RHO_PRESC);
+
+        // qg integrands compiled for this scheme combination
+        if (nlodis_config::SPECIALIZED_INTEGRANDS)
+            this->SetSchemeIntegrands();
     }
 
+    // The massless qg integrands either call the scheme choices through the method pointers
+    // above, or are instantiated for the combination of nlodis_config::RC_DIS, TRBK_RHO_PRESC,
+    // SUB_TERM_KERNEL and config::KINEMATICAL_CONSTRAINT (SetSchemeIntegrands).
+    // The z2 lower bound is evaluated once per point in PointContext.
+    // Setting any of the method pointers by hand switches back to the runtime dispatch.
+    void UseRuntimeIntegrands();
+    void SetSchemeIntegrands();
+
     void SetCubaMethod(string s){cubamethod = s;}
+    // Exits on an unknown term name
+    void SetTermPolicy(const string& term, const IntegratorPolicy& p);
+    // True if term is the name of a term taking an integrator policy
+    static bool IsPolicyTerm(const string& term);
+    // Integrator of the term (the name of the method calling Cuba) of dimension ndim:
+    // the policy set with SetTermPolicy, or DefaultPolicy(cubamethod, ndim)
+    IntegratorPolicy Policy(const string& term, int ndim) const;
+    // Integration tolerance of the point computed by the calling thread, 0: the policies as set.
+    // It replaces the epsrel of the policies with CUBA_EPSREL or looser.
+    static void SetPointEpsrel(double epsrel);
+    // Integration errors err = {dFL, dFT} of the structure functions computed by the calling
+    // thread since ResetIntegrationErrors, the errors of the terms added in quadrature. The
+    // multix integrations, which compute several points at once, are not included.
+    static void ResetIntegrationErrors();
+    static void IntegrationErrors(double err[2]);
+    // Forget the qg variable maps (nlodis_config::QG_VARIABLE_MAPS) chosen by the pilot
+    // integrations, to be called when the dipole or the parameters change
+    static void ResetQGVariableMaps();
+
+    // Cuba userdata with the sample invariant quantities of the kinematic point
+    Userdata PointContext(double Q, double xbj, double qMass=0);
+    MultiXUserdata MultiXContext(double Q, const std::vector<double>& xbj);
 
 	AmplitudeLib* GetDipole() { return ClassScopeDipolePointer; }
 
 //private:
     //variables
     AmplitudeLib *ClassScopeDipolePointer;
+    DipoleAmplitudeView *DipoleViewPointer;     // If not NULL, used instead of ClassScopeDipolePointer
+    DipoleEvaluator *FastDipolePointer;         // If not NULL, used instead of both of the above
     double qMass_light, alpha_scaling_C2_, icX0, icX0_bk, icY0, icQ0sqr;
+    double exp_icY0;    // exp(-icY0)
 	double qMass_charm;
     struct QMasses{
         double m_u, m_d, m_s, m_c, m_b, m_t;
@@ -300,17 +420,31 @@ public:
     bkkernel_funpointer K_kernel_PTR;
     trbk_rho_funpointer rho_PTR;
     INLOqg_subterm_fp ILNLOqg_subterm_PTR, ITNLOqg_subterm_PTR;
+    integrand_t ILqgunsub_integrand, ITqgunsub_integrand, ILqgsub_integrand, ITqgsub_integrand;
+    batch_integrand_t ILqgunsub_batch, ITqgunsub_batch;    // Used if nlodis_config::CUBA_NVEC > 1
+    integrand_t LTqgunsub_integrand;
+    batch_integrand_t LTqgunsub_batch;
+    // z2->0 subtraction terms as control variates of the unsub integrands (QG_CONTROL_VARIATE)
+    integrand_t ILqgunsub_subterm, ITqgunsub_subterm, LTqgunsub_subterm;
+    // and the same integrated over z1, in (z2, x01, x02, phi) with a QGSubtermUserdata
+    integrand_t ILqgunsub_subterm_z1, ITqgunsub_subterm_z1, LTqgunsub_subterm_z1;
     // Cuba integrators
     // old int way: static const int vegas = 1, suave = 2, divonne = 3;
     // int cubamethod;
-    string cubamethod;// Currently integrates everything with this. ->? Integrate cumbersome QG AND Bound Dipole Loop contrb. separate one?
+    string cubamethod;// Integrates everything without a policy of its own, see Policy
+    std::map<string, IntegratorPolicy> termpolicies;
 
 
     /*
     **  HELPERS & POINTERS
     */
     double Sr(double r, double x);
+    void Sr(const double* r, const double* x, double* out, int n);   // out[i] = Sr(r[i], x[i])
     double SrY(double r, double y);
+    double DipoleS(double r, double x){
+        if (DipoleViewPointer != NULL) return DipoleViewPointer->S(r, x);
+        return ClassScopeDipolePointer->S(r, x);
+    }
     double SrTripole(double x01, double x_x01, double x02, double x_x02, double x21, double x_x21);
     double P(double z);
     double heaviside_theta(double x);
@@ -352,6 +486,7 @@ public:
 
     // Target rapidity Eta shift calculator(s)
     double cov_to_eta_x(double r, double xbj, double Qsq);
+    template<class Rho> double cov_to_eta_x_t(double r, double xbj, double Qsq);
     double rho_rapidity_shift(double Qsq, double x01sq = 0, double x02sq = 0, double x21sq = 0){ return (this->*rho_PTR)(Qsq, x01sq, x02sq, x21sq); };
     double rho_no_shift_projectileY(double Qsq, double x01sq = 0, double x02sq = 0, double x21sq = 0);
     double rho_rapidity_shift_QQ0(double Qsq, double x01sq = 0, double x02sq = 0, double x21sq = 0);
@@ -406,12 +541,18 @@ public:
     double ILdip(double Q, double z1, double x01sq) ;
     double Bessel0Tripole(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
     double ILNLOqg(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
+    template<class Rho> double Bessel0Tripole_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
+    template<class Rho> double ILNLOqg_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
     double ILNLOqgRisto(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
     double ILNLOsigma3(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
 
     double LLOp(double Q, double x) ;
     double LLOpMass(double Q, double x, bool charm) ;
     double LLOp_massive(double Q, double x, double mf) ;
+    // \int dr r (1 - S(r, X(r))) W(Q, mf; r) with the photon overlaps W of photonoverlap.hpp, pol 0: L, 1: T
+    double LOp_overlap(double Q, double x, double mf, int pol) ;
+    // \int dr r (1 - S(r, X_DIP(r))) alphabar CF/Nc K(Q, mf; r) with the kernels K of dipoleloopkernel.hpp
+    double NLOdip_kernel(double Q, double x, double mf, int term) ;
     double LNLOdip(double Q, double x) ;
     double LNLOdip_z2(double Q, double x) ;
     double LNLOdip_massive_LiLogConst(double Q, double x, double mf) ;
@@ -433,6 +574,8 @@ public:
     double ITdip(double Q, double z1, double x01sq) ;
     double Bessel1Tripole(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
     double ITNLOqg(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
+    template<class Rho> double Bessel1Tripole_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
+    template<class Rho> double ITNLOqg_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
     double ITNLOqgRisto(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
     double ITNLOsigma3(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq) ;
 
@@ -453,11 +596,32 @@ public:
     double TNLOqgunsub_massive_I1(double Q, double x, double mf) ;
     double TNLOqgunsub_massive_I2(double Q, double x, double mf) ;
     double TNLOqgunsub_massive_I3(double Q, double x, double mf) ;
+
+    // Fused longitudinal and transverse
+    template<class Rho> void BesselTripoleLT_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq,
+        double& resL, double& resT) ;
+    template<class Rho> void INLOqgLT_t(double Q, double x, double z1, double z2, double x01sq, double x02sq, double x21sq,
+        double& resL, double& resT) ;
+    void LTNLOqgunsub(double Q, double x, double res[2]) ;
+    void LTICdip(double Q, double x, double res[4]) ;
 };
 
 double sumef_from_mass(double mf);
 
-void Cuba(string method, int ndim, integrand_t integrand,void *userdata, double *integral, double *error, double *prob);
+// If nlodis_config::CUBA_NVEC > 1 the points are evaluated in batches with the batch integrand,
+// or by looping over integrand if none is given. gridkey identifies the term and kinematics
+// for the Vegas grids of nlodis_config::VEGAS_WARM_GRIDS.
+void Cuba(const IntegratorPolicy& policy, int ndim, integrand_t integrand,void *userdata, double *integral, double *error, double *prob,
+    batch_integrand_t batch_integrand=NULL, CubaGridKey gridkey=CubaGridKey());
+// ncomp component integrand, integral, error and prob have ncomp elements
+void Cuba(const IntegratorPolicy& policy, int ndim, int ncomp, integrand_t integrand,void *userdata, double integral[], double error[], double prob[],
+    batch_integrand_t batch_integrand=NULL, CubaGridKey gridkey=CubaGridKey());
+// method with nlodis_config::CUBA_EPSREL and CUBA_MAXEVAL. Method "auto" is CUBA_CUBATURE_METHOD
+// with CUBA_CUBATURE_EPSREL up to CUBA_CUBATURE_MAXDIM dimensions and CUBA_MC_METHOD above.
+IntegratorPolicy DefaultPolicy(const string& method, int ndim);
+// DefaultPolicy(method, ndim)
+void Cuba(string method, int ndim, integrand_t integrand,void *userdata, double *integral, double *error, double *prob,
+    batch_integrand_t batch_integrand=NULL, CubaGridKey gridkey=CubaGridKey());
 
 int integrand_ILLOp(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) ;
 int integrand_ILLOpMass(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) ;
@@ -479,6 +643,11 @@ int integrand_ILqgunsub_massive_I3(int *ndim, const double x[], const int *ncomp
 int integrand_ILqgunsub_massive_I2_fast(int *ndim, const double x[], const int *ncomp,double *f, void *userdata) ;
 int integrand_ILqgunsub_massive_I3_fast(int *ndim, const double x[], const int *ncomp,double *f, void *userdata) ;
 
+// Batch versions, see Cuba()
+int integrand_ILLOp_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) ;
+int integrand_ILdip_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) ;
+int integrand_ILqgunsub_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) ;
+
 
 int integrand_ITLOp(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) ;
 int integrand_ITLOpMass(const int *ndim, const double x[], const int *ncomp,double *f, void *userdata) ;
@@ -499,6 +668,16 @@ int integrand_ITqgunsub_massive_I3(int *ndim, const double x[], const int *ncomp
 int integrand_ITqgunsub_massive_I2_fast(int *ndim, const double x[], const int *ncomp,double *f, void *userdata) ;
 int integrand_ITqgunsub_massive_I3_fast(int *ndim, const double x[], const int *ncomp,double *f, void *userdata) ;
 
+int integrand_ITLOp_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) ;
+int integrand_ITdip_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) ;
+int integrand_ITqgunsub_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) ;
+
+// Fused L and T, f = {L, T} and f = {L IC, T IC, L dip, T dip}
+int integrand_LTICdip(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) ;
+int integrand_LTICdip_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) ;
+int integrand_LTqgunsub(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata) ;
+int integrand_LTqgunsub_batch(const int *ndim, const double x[], const int *ncomp, double f[], void *userdata, const int *nvec, const int *core) ;
+
 string PrintVector(vector<double> v);
 
 #endif // _NLODIS_SIGMAR_H
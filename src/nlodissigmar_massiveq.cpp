@@ -8,6 +8,8 @@
 #include "nlodis_config.hpp"
 #include "nlodissigmar_massiveq.hpp"
 #include "nlodissigmar.hpp"
+#include "bessel.hpp"
+#include "massivetables.hpp"
 
 // ----------------------- HELPER FUNCTIONS ------------------------
 
@@ -63,8 +65,8 @@ double IT_V1_unsymmetric( double Q, double z, double mf, double r, double xi ) {
 
     double kappa_z = sqrt( z*(1.0-z)*Sq(Q) + Sq(mf) );
 
-    double term1 = 1.0/xi * ( 2.0*log(xi)/(1.0-xi) - (1.0+xi)/2.0 ) * ( sqrt( Sq(kappa_z) + xi/(1.0-xi) * (1.0-z) * Sq(mf)) * gsl_sf_bessel_K1( r*sqrt(Sq(kappa_z) + xi/(1.0-xi) *(1.0-z)* Sq(mf)) ) - kappa_z * gsl_sf_bessel_K1( r*kappa_z ) );
-    double term2 = -( log(xi)/Sq(1.0-xi) + z/(1.0-xi) + z/2.0 ) * (1.0-z)*Sq(mf)/sqrt( Sq(kappa_z) + xi/(1.0-xi) * (1.0-z) *Sq(mf) ) * gsl_sf_bessel_K1( r*sqrt( Sq(kappa_z) + xi/(1.0-xi) * (1.0-z) *Sq(mf) ) );
+    double term1 = 1.0/xi * ( 2.0*log(xi)/(1.0-xi) - (1.0+xi)/2.0 ) * ( sqrt( Sq(kappa_z) + xi/(1.0-xi) * (1.0-z) * Sq(mf)) * BesselK1( r*sqrt(Sq(kappa_z) + xi/(1.0-xi) *(1.0-z)* Sq(mf)) ) - kappa_z * BesselK1( r*kappa_z ) );
+    double term2 = -( log(xi)/Sq(1.0-xi) + z/(1.0-xi) + z/2.0 ) * (1.0-z)*Sq(mf)/sqrt( Sq(kappa_z) + xi/(1.0-xi) * (1.0-z) *Sq(mf) ) * BesselK1( r*sqrt( Sq(kappa_z) + xi/(1.0-xi) * (1.0-z) *Sq(mf) ) );
 
     double res = term1 + term2;
 
@@ -80,8 +82,8 @@ double IT_VMS1_unsymmetric( double Q, double z, double mf, double r, double xi )
 
     double kappa_z = sqrt( z*(1.0-z)*Sq(Q) + Sq(mf) );
 
-    double term1 = 1.0/xi * (2.0 * log(xi)/(1.0-xi) - (1.0+xi)/(2.0)) * ( gsl_sf_bessel_K0( r*sqrt( Sq(kappa_z) + xi/(1.0-xi) * (1.0-z) *Sq(mf) ) ) - gsl_sf_bessel_K0(r*kappa_z) );
-    double term2 = ( -3.0/2.0 * (1.0-z)/(1.0-xi) + (1.0-z)/2.0 ) * gsl_sf_bessel_K0( r* sqrt(Sq(kappa_z) + xi/(1.0-xi) * (1-z) *Sq(mf)) );
+    double term1 = 1.0/xi * (2.0 * log(xi)/(1.0-xi) - (1.0+xi)/(2.0)) * ( BesselK0( r*sqrt( Sq(kappa_z) + xi/(1.0-xi) * (1.0-z) *Sq(mf) ) ) - BesselK0(r*kappa_z) );
+    double term2 = ( -3.0/2.0 * (1.0-z)/(1.0-xi) + (1.0-z)/2.0 ) * BesselK0( r* sqrt(Sq(kappa_z) + xi/(1.0-xi) * (1-z) *Sq(mf)) );
 
     double res = term1 + term2;
 
@@ -101,8 +103,8 @@ double IT_V2_unsymmetric( double Q, double z, double mf, double r, double y_chi,
     double kappa_z = sqrt( z*(1.0-z)*Sq(Q) + Sq(mf) );
     double kappa_chi = sqrt( chi*(1.0-chi)*Sq(Q) + Sq(mf) );
 
-    double term1 = - 1.0/(1.0-chi) * 1.0/(u*(u+1.0)) * Sq(mf)/Sq(kappa_chi) * ( 2.0*chi + Sq(  u/(u+1.0)) * 1.0/z * (z-chi) * (1.0-2.0*chi) ) * ( sqrt(Sq(kappa_z) + u*(1.0-z)/(1.0-chi)*Sq(kappa_chi)) * gsl_sf_bessel_K1(r*sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi)*Sq(kappa_chi) )) - kappa_z *gsl_sf_bessel_K1(r* kappa_z) );
-    double term2 = -1.0/Sq(1.0-chi) * 1.0/(u+1.0) * (z-chi) * ( 1.0 - 2.0*u/(1.0+u)*(z-chi) + Sq(u/(u+1.0)) *1.0/z * Sq(z-chi) ) * Sq(mf)/sqrt( Sq(kappa_z) + u *(1.0-z)/(1.0-chi) * Sq(kappa_chi)) * gsl_sf_bessel_K1( r* sqrt( Sq(kappa_z) + u *(1.0-z)/(1.0-chi) * Sq(kappa_chi) ) );
+    double term1 = - 1.0/(1.0-chi) * 1.0/(u*(u+1.0)) * Sq(mf)/Sq(kappa_chi) * ( 2.0*chi + Sq(  u/(u+1.0)) * 1.0/z * (z-chi) * (1.0-2.0*chi) ) * ( sqrt(Sq(kappa_z) + u*(1.0-z)/(1.0-chi)*Sq(kappa_chi)) * BesselK1(r*sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi)*Sq(kappa_chi) )) - kappa_z *BesselK1(r* kappa_z) );
+    double term2 = -1.0/Sq(1.0-chi) * 1.0/(u+1.0) * (z-chi) * ( 1.0 - 2.0*u/(1.0+u)*(z-chi) + Sq(u/(u+1.0)) *1.0/z * Sq(z-chi) ) * Sq(mf)/sqrt( Sq(kappa_z) + u *(1.0-z)/(1.0-chi) * Sq(kappa_chi)) * BesselK1( r* sqrt( Sq(kappa_z) + u *(1.0-z)/(1.0-chi) * Sq(kappa_chi) ) );
 
     double jacobian = z / Sq(y_u);
 
@@ -123,8 +125,8 @@ double IT_VMS2_unsymmetric( double Q, double z, double mf, double r, double y_ch
     double kappa_z = sqrt( z*(1.0-z)*Sq(Q) + Sq(mf) );
     double kappa_chi = sqrt( chi*(1.0-chi)*Sq(Q) + Sq(mf) );
 
-    double term1 = 1.0/(1.0-chi) * 1.0/Sq(u+1.0) * (-z - u/(1.0+u) * (z + u*chi)/z * (chi-(1.0-z))) * gsl_sf_bessel_K0(r * sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi) *Sq(kappa_chi) ));
-    double term2 = 1.0/(u+1.0)/Sq(u+1.0) * ( Sq(kappa_z)/Sq(kappa_chi) * (1.0 + u * chi*(1.0-chi) / ( z*(1.0-z) )) - Sq(mf)/Sq(kappa_chi) * chi/(1.0-chi) * (2.0 *Sq(1.0+u)/u + u/(z*(1.0-z)) *Sq(z-chi) ) ) * ( gsl_sf_bessel_K0( r *sqrt( Sq(kappa_z) + u* (1.0-z)/(1.0-chi) *Sq(kappa_chi)) ) - gsl_sf_bessel_K0(r* kappa_z) );
+    double term1 = 1.0/(1.0-chi) * 1.0/Sq(u+1.0) * (-z - u/(1.0+u) * (z + u*chi)/z * (chi-(1.0-z))) * BesselK0(r * sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi) *Sq(kappa_chi) ));
+    double term2 = 1.0/(u+1.0)/Sq(u+1.0) * ( Sq(kappa_z)/Sq(kappa_chi) * (1.0 + u * chi*(1.0-chi) / ( z*(1.0-z) )) - Sq(mf)/Sq(kappa_chi) * chi/(1.0-chi) * (2.0 *Sq(1.0+u)/u + u/(z*(1.0-z)) *Sq(z-chi) ) ) * ( BesselK0( r *sqrt( Sq(kappa_z) + u* (1.0-z)/(1.0-chi) *Sq(kappa_chi)) ) - BesselK0(r* kappa_z) );
 
     double jacobian = z / Sq(y_u);
 
@@ -146,8 +148,8 @@ double IT_N_unsymmetric( double Q, double z, double mf, double r, double y_chi,
     double kappa_z = sqrt( z*(1.0-z)*Sq(Q) + Sq(mf) );
     double kappa_chi = sqrt( chi*(1.0-chi)*Sq(Q) + Sq(mf) );
 
-    double term1 = 2.0*(1.0-z)/z * 1.0/Sq(u+1.0)/(u+1.0) * ( (2.0+u)*u*z + Sq(u)*chi ) * sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi) * Sq(kappa_chi) ) * gsl_sf_bessel_K1( r* sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi) *Sq(kappa_chi) ) );
-    double term2 = 2.0*(1.0-z)/z * 1.0/Sq(u+1.0)/(u+1.0) * Sq(mf)/Sq(kappa_chi) * ( z/(1.0-z) + chi/(1.0-chi) * (u-2.0*z-2.0*u*chi) ) * ( sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi)*Sq(kappa_chi)) * gsl_sf_bessel_K1( r * sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi) *Sq(kappa_chi) ) ) - kappa_z * gsl_sf_bessel_K1( r* kappa_z ) );
+    double term1 = 2.0*(1.0-z)/z * 1.0/Sq(u+1.0)/(u+1.0) * ( (2.0+u)*u*z + Sq(u)*chi ) * sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi) * Sq(kappa_chi) ) * BesselK1( r* sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi) *Sq(kappa_chi) ) );
+    double term2 = 2.0*(1.0-z)/z * 1.0/Sq(u+1.0)/(u+1.0) * Sq(mf)/Sq(kappa_chi) * ( z/(1.0-z) + chi/(1.0-chi) * (u-2.0*z-2.0*u*chi) ) * ( sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi)*Sq(kappa_chi)) * BesselK1( r * sqrt( Sq(kappa_z) + u*(1.0-z)/(1.0-chi) *Sq(kappa_chi) ) ) - kappa_z * BesselK1( r* kappa_z ) );
 
     double jacobian = z / Sq(y_u);
 
@@ -262,11 +264,26 @@ double G_integrand_simplified(int a, int b, double Qbar, double mf, double x2, d
 
     double value = 1.0/pow( y, 0.5*(2.0-a+b) ) * pow( 2.0, a+b-1.0 ) * pow(omega, b-1.0) 
                     * pow(( y*lambda * Sq(mf) + Sq(Qbar) + Sq(mf) ) / ( y*Sq(x3) + omega*Sq(x2) ), 0.5*(a+b-2.0) )
-                    * gsl_sf_bessel_Kn( a+b-2, sqrt(1.0/y * ( y*lambda * Sq(mf) + Sq(Qbar) + Sq(mf) ) * ( y*Sq(x3) + omega*Sq(x2) )) ) ;
+                    * BesselKn( a+b-2, sqrt(1.0/y * ( y*lambda * Sq(mf) + Sq(Qbar) + Sq(mf) ) * ( y*Sq(x3) + omega*Sq(x2) )) ) ;
 
     return value;
 }
 
+double G_y(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda, double y) {
+    // G_integrand_simplified at y = y_t of the _fast integrands. With PERF_MODE == MASSIVE_TABULATED_G
+    // the integral over y is taken from the tables, and the integrands have no y_t dimensions.
+    if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_TABULATED_G)
+        return G_integrated(a, b, Qbar, mf, x2, x3, omega, lambda);
+    return G_integrand_simplified(a, b, Qbar, mf, x2, x3, omega, lambda, y);
+}
+
+double G_bar_y(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda, double y) {
+    // As G_y for the difference G(lambda) - G(lambda=0)
+    if (nlodis_config::PERF_MODE == nlodis_config::MASSIVE_TABULATED_G)
+        return G_bar_integrated(a, b, Qbar, mf, x2, x3, omega, lambda);
+    return G_integrand_simplified(a, b, Qbar, mf, x2, x3, omega, lambda, y) - G_integrand_simplified(a, b, Qbar, mf, x2, x3, omega, 0.0, y);
+}
+
 double G_qg(int a, int b, double y_u, double y_t, double Qbar, double mf, double x2, double x3, double omega, double lambda) {
     // Functions G^(a;b)_(x) that appear in the qqg-part. Un-integrated form.
 
@@ -329,9 +346,9 @@ double IT_dipole_jk_I1(double Q, double mf, double z1, double z2, double x01sq,
     double x3_k = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
     double term_j = 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2)) * ( 1.0-2.0*z1*(1.0-z1) ) * ( Sq(Qbar_j) + Sq(mf) ) / Sq(x2_j) 
-                    * ( - exp( -Sq(x2_j) / ( x01sq *exp(M_EULER) ) ) * Sq(gsl_sf_bessel_K1( sqrt( x01sq * ( Sq(Qbar_j) + Sq(mf) ) ) ) ));
+                    * ( - exp( -Sq(x2_j) / ( x01sq *exp(M_EULER) ) ) * Sq(BesselK1( sqrt( x01sq * ( Sq(Qbar_j) + Sq(mf) ) ) ) ));
     double term_k = 1.0/Sq(z1+z2) * (2.0*z1*(z1+z2)+Sq(z2)) * ( 1.0-2.0*z0*(1.0-z0) ) * ( Sq(Qbar_k) + Sq(mf) ) / Sq(x2_k) 
-                    * ( - exp( -Sq(x2_k) / ( x01sq *exp(M_EULER) ) ) * Sq(gsl_sf_bessel_K1( sqrt( x01sq * ( Sq(Qbar_k) + Sq(mf) ) ) ) ));
+                    * ( - exp( -Sq(x2_k) / ( x01sq *exp(M_EULER) ) ) * Sq(BesselK1( sqrt( x01sq * ( Sq(Qbar_k) + Sq(mf) ) ) ) ));
    
     double res = term_j + term_k;
 
@@ -360,9 +377,9 @@ double IT_tripole_jk_I1(double Q, double mf, double z1, double z2, double x01sq,
     double x3_k = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
     double term_j = 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2)) * ( 1.0-2.0*z1*(1.0-z1) ) * ( Sq(Qbar_j) + Sq(mf) ) / Sq(x2_j) 
-                    * Sq(x3_j) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) * Sq( gsl_sf_bessel_K1( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) ) ) ;
+                    * Sq(x3_j) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) * Sq( BesselK1( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) ) ) ;
     double term_k = 1.0/Sq(z1+z2) * (2.0*z1*(z1+z2)+Sq(z2)) * ( 1.0-2.0*z0*(1.0-z0) ) * ( Sq(Qbar_k) + Sq(mf) ) / Sq(x2_k) 
-                    * Sq(x3_k) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) * Sq( gsl_sf_bessel_K1( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) ) ) ;
+                    * Sq(x3_k) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) * Sq( BesselK1( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) ) ) ;
    
     double res = term_j + term_k;
 
@@ -390,21 +407,21 @@ double IT_tripole_jk_I2_fast(double Q, double mf, double z1, double z2, double x
 
 
 
-    double int_22_bar_j = G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t) - G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t);
-    double int_22_bar_k = G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t) - G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t);
+    double int_22_bar_j = G_bar_y( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
+    double int_22_bar_k = G_bar_y( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
 
 
     // double int_22_j = 1.0/y_t * 8.0/omega_j * ( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t * ( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t * ( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // double int_22_k = 1.0/y_t * 8.0/omega_k * ( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t * ( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t * ( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
 
     double term_j = 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2)) * ( 1.0-2.0*z1*(1.0-z1) ) 
                     * int_22_bar_j * Sq(x3_j)/8.0 * sqrt( ( Sq(Qbar_j) + Sq(mf) ) / (Sq(x3_j) + omega_j * Sq(x2_j) ) )
-                    * gsl_sf_bessel_K1( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) )  ;
+                    * BesselK1( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) )  ;
     double term_k = 1.0/Sq(z1+z2) * (2.0*z1*(z1+z2)+Sq(z2)) * ( 1.0-2.0*z0*(1.0-z0) ) 
                     * int_22_bar_k * Sq(x3_k)/8.0 * sqrt( ( Sq(Qbar_k) + Sq(mf) ) / (Sq(x3_k) + omega_k * Sq(x2_k) ) )
-                    * gsl_sf_bessel_K1( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) )  ;
+                    * BesselK1( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) )  ;
 
     double res = term_j + term_k;
 
@@ -433,20 +450,20 @@ double IT_tripole_jk_I3_fast(double Q, double mf, double z1, double z2, double x
     double x3_k = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
 
-    double int_22_bar_j1 = G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1) - G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t1);
-    double int_22_bar_k1 = G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1) - G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t1);
-    double int_22_bar_j2 = G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2) - G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t2);
-    double int_22_bar_k2 = G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2) - G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t2);
+    double int_22_bar_j1 = G_bar_y( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
+    double int_22_bar_k1 = G_bar_y( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
+    double int_22_bar_j2 = G_bar_y( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2);
+    double int_22_bar_k2 = G_bar_y( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
 
 
     // double int_22_j1 = 1.0/y_t1 * 8.0/omega_j * ( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t1 * ( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t1 * ( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // double int_22_k1 = 1.0/y_t1 * 8.0/omega_k * ( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t1 * ( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t1 * ( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
     // double int_22_j2 = 1.0/y_t2 * 8.0/omega_j * ( y_t2 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t2 * ( y_t2* lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t2 * ( y_t2* lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // double int_22_k2 = 1.0/y_t2 * 8.0/omega_k * ( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t2 * ( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t2 * ( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
 
 
     double term_j = 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2)) * ( 1.0-2.0*z1*(1.0-z1) ) 
@@ -480,9 +497,9 @@ double IT_dipole_jkm_I1(double Q, double mf, double z1, double z2, double x01sq,
     double x3_k = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
     double term_j = 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2)) / Sq(x2_j) 
-                    * ( - exp( -Sq(x2_j) / ( x01sq *exp(M_EULER) ) ) * Sq(gsl_sf_bessel_K0( sqrt( x01sq * ( Sq(Qbar_j) + Sq(mf) ) ) ) ));
+                    * ( - exp( -Sq(x2_j) / ( x01sq *exp(M_EULER) ) ) * Sq(BesselK0( sqrt( x01sq * ( Sq(Qbar_j) + Sq(mf) ) ) ) ));
     double term_k = 1.0/Sq(z1+z2) * (2.0*z1*(z1+z2)+Sq(z2)) / Sq(x2_k) 
-                    * ( - exp( -Sq(x2_k) / ( x01sq *exp(M_EULER) ) ) * Sq(gsl_sf_bessel_K0( sqrt( x01sq * ( Sq(Qbar_k) + Sq(mf) ) ) ) ));
+                    * ( - exp( -Sq(x2_k) / ( x01sq *exp(M_EULER) ) ) * Sq(BesselK0( sqrt( x01sq * ( Sq(Qbar_k) + Sq(mf) ) ) ) ));
    
     double res = Sq(mf) * (term_j + term_k);
 
@@ -509,9 +526,9 @@ double IT_tripole_jkm_I1(double Q, double mf, double z1, double z2, double x01sq
     double x3_k = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
     double term_j = 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2)) / Sq(x2_j) 
-                    * Sq( gsl_sf_bessel_K0( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) ) );
+                    * Sq( BesselK0( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) ) );
     double term_k = 1.0/Sq(z1+z2) * (2.0*z1*(z1+z2)+Sq(z2)) / Sq(x2_k) 
-                    * Sq( gsl_sf_bessel_K0( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) ) );
+                    * Sq( BesselK0( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) ) );
    
     double res = Sq(mf) * (term_j + term_k);
 
@@ -539,20 +556,20 @@ double IT_tripole_jkm_I2_fast(double Q, double mf, double z1, double z2, double
     double x3_k = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
 
-    double int_12_bar_j = G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t) - G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t);
-    double int_12_bar_k = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t) - G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t);
+    double int_12_bar_j = G_bar_y( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
+    double int_12_bar_k = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
 
     // double int_12_j = 1.0/(y_t*sqrt(y_t)) * 8.0/omega_j * sqrt(( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) ))
-    //                   * gsl_sf_bessel_K1( sqrt( 1.0/y_t * ( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    //                   * BesselK1( sqrt( 1.0/y_t * ( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // double int_12_k = 1.0/(y_t*sqrt(y_t)) * 8.0/omega_k * sqrt(( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) ))
-    //                   * gsl_sf_bessel_K1( sqrt( 1.0/y_t * ( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    //                   * BesselK1( sqrt( 1.0/y_t * ( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
 
 
 
     double term_j = 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2))
-                    * int_12_bar_j/4.0 * gsl_sf_bessel_K0( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) )  ;
+                    * int_12_bar_j/4.0 * BesselK0( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) )  ;
     double term_k = 1.0/Sq(z1+z2) * (2.0*z1*(z1+z2)+Sq(z2))
-                    * int_12_bar_k/4.0 * gsl_sf_bessel_K0( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) )  ;
+                    * int_12_bar_k/4.0 * BesselK0( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) )  ;
 
     double res = Sq(mf) * (term_j + term_k);
 
@@ -579,19 +596,19 @@ double IT_tripole_jkm_I3_fast(double Q, double mf, double z1, double z2, double
     double x3_k = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
 
-    double int_12_bar_j1 = G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1) - G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t1);
-    double int_12_bar_k1 = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1) - G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t1);
-    double int_12_bar_j2 = G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2) - G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t2);
-    double int_12_bar_k2 = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2) - G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t2);
+    double int_12_bar_j1 = G_bar_y( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
+    double int_12_bar_k1 = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
+    double int_12_bar_j2 = G_bar_y( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2);
+    double int_12_bar_k2 = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
 
     // double int_12_j1 = 1.0/(y_t1*sqrt(y_t1)) * 8.0/omega_j * sqrt(( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) ))
-    //                   * gsl_sf_bessel_K1( sqrt( 1.0/y_t1 * ( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    //                   * BesselK1( sqrt( 1.0/y_t1 * ( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // double int_12_k1 = 1.0/(y_t1*sqrt(y_t1)) * 8.0/omega_k * sqrt(( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) ))
-    //                   * gsl_sf_bessel_K1( sqrt( 1.0/y_t1 * ( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    //                   * BesselK1( sqrt( 1.0/y_t1 * ( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
     // double int_12_j2 = 1.0/(y_t2*sqrt(y_t2)) * 8.0/omega_j * sqrt(( y_t2 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) ))
-    //                   * gsl_sf_bessel_K1( sqrt( 1.0/y_t2 * ( y_t2 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    //                   * BesselK1( sqrt( 1.0/y_t2 * ( y_t2 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // double int_12_k2 = 1.0/(y_t2*sqrt(y_t2)) * 8.0/omega_k * sqrt(( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) ))
-    //                   * gsl_sf_bessel_K1( sqrt( 1.0/y_t2 * ( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    //                   * BesselK1( sqrt( 1.0/y_t2 * ( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
 
 
 
@@ -635,14 +652,14 @@ double IT_tripole_F_I1(double Q, double mf, double z1, double z2, double x01sq,
     double x3j_x3k = z0/(z0+z2)*x02sq + z1/(z1+z2)*x21sq - ( 1.0 + z0*z1/(z0+z2)/(z1+z2) ) * x20x21;
 
     double G22_sing_j = 1.0/Sq(x2_j) * sqrt( ( Sq(Qbar_j) + Sq(mf) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double G22_sing_k = 1.0/Sq(x2_k) * sqrt( ( Sq(Qbar_k) + Sq(mf) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double H_j = 4.0 * sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double H_k = 4.0 * sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double term_1 = 4.0/(z0+z2)/(z1+z2) * ( z2*Sq(z0-z1) * ( x2j_x3j * x2k_x3k - x2k_x3j * x2j_x3k ) 
                     - ( z1*(z0+z2) + z0*(z1+z2) )*(z0*(z0+z2)+z1*(z1+z2)) * x20x21 * x3j_x3k ) *
@@ -687,25 +704,25 @@ double IT_tripole_F_I2_fast(double Q, double mf, double z1, double z2, double x0
 
 
 
-    double int_22_bar_j = G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t) - G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t);
-    double int_22_bar_k = G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t) - G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t);
+    double int_22_bar_j = G_bar_y( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
+    double int_22_bar_k = G_bar_y( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
 
     // double int_22_j = 1.0/y_t * 8.0/omega_j * ( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t * ( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t * ( y_t * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // double int_22_k = 1.0/y_t * 8.0/omega_k * ( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t * ( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t * ( y_t * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
 
 
 
     double G22_sing_j = 1.0/Sq(x2_j) * sqrt( ( Sq(Qbar_j) + Sq(mf) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double G22_sing_k = 1.0/Sq(x2_k) * sqrt( ( Sq(Qbar_k) + Sq(mf) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double H_j = 4.0 * sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double H_k = 4.0 * sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double term_1 = 1.0/(4.0*(z0+z2)*(z1+z2)) * (z2*Sq(z0-z1)* ( x2j_x3j * x2k_x3k - x2k_x3j * x2j_x3k ) 
                     - (z1*(z0+z2)+z0*(z1+z2))* (z0*(z0+z2)+z1*(z1+z2))*x20x21 * x3j_x3k  )
@@ -749,17 +766,17 @@ double IT_tripole_F_I3_fast(double Q, double mf, double z1, double z2, double x0
     double x3j_x3k = z0/(z0+z2)*x02sq + z1/(z1+z2)*x21sq - ( 1.0 + z0*z1/(z0+z2)/(z1+z2) ) * x20x21;
 
 
-    double int_22_bar_j1 = G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1) - G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t1);
-    double int_22_bar_k2 = G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2) - G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t2);
+    double int_22_bar_j1 = G_bar_y( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
+    double int_22_bar_k2 = G_bar_y( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
 
     // double int_22_j1 = 1.0/y_t1 * 8.0/omega_j * ( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t1 * ( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t1 * ( y_t1 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t1 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // // double int_22_k1 = 1.0/y_t1 * 8.0/omega_k * ( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) )
-    // //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t1 * ( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    // //                   * BesselKn(2, sqrt( 1.0/y_t1 * ( y_t1 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t1 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
     // // double int_22_j2 = 1.0/y_t2 * 8.0/omega_j * ( y_t2 * lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) / ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) )
-    // //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t2 * ( y_t2* lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
+    // //                   * BesselKn(2, sqrt( 1.0/y_t2 * ( y_t2* lambda_j * Sq(mf) + Sq(Qbar_j) + Sq(mf) ) * ( y_t2 * Sq(x3_j) + omega_j * Sq(x2_j) ) ));
     // double int_22_k2 = 1.0/y_t2 * 8.0/omega_k * ( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) / ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) )
-    //                   * gsl_sf_bessel_Kn(2, sqrt( 1.0/y_t2 * ( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
+    //                   * BesselKn(2, sqrt( 1.0/y_t2 * ( y_t2 * lambda_k * Sq(mf) + Sq(Qbar_k) + Sq(mf) ) * ( y_t2 * Sq(x3_k) + omega_k * Sq(x2_k) ) ));
 
 
     double res = 0.5 * int_22_bar_j1 * int_22_bar_k2
@@ -796,18 +813,18 @@ double IT_tripole_Fm_I1(double Q, double mf, double z1, double z2, double x01sq,
     // double x2k_x3j = x21sq - z0/(z0+z2) * x20x21 ;
     // double x3j_x3k = z0/(z0+z2)*x02sq + z1/(z1+z2)*x21sq - ( 1.0 + z0*z1/(z0+z2)/(z1+z2) ) * x20x21;
 
-    double G12_sing_j = 1.0/Sq(x2_j) * gsl_sf_bessel_K0( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
-    double G12_sing_k = 1.0/Sq(x2_k) * gsl_sf_bessel_K0( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+    double G12_sing_j = 1.0/Sq(x2_j) * BesselK0( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+    double G12_sing_k = 1.0/Sq(x2_k) * BesselK0( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     // double G22_sing_j = 1.0/Sq(x2_j) * sqrt( ( Sq(Qbar_j) + Sq(mf) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-    //                     * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+    //                     * BesselK1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     // double G22_sing_k = 1.0/Sq(x2_k) * sqrt( ( Sq(Qbar_k) + Sq(mf) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-    //                     * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+    //                     * BesselK1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     // double H_j = 4.0 * sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-    //             * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+    //             * BesselK1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     // double H_k = 4.0 * sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-    //             * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+    //             * BesselK1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
 
 
@@ -845,31 +862,31 @@ double IT_tripole_Fm_I2_fast(double Q, double mf, double z1, double z2, double x
     double x3j_x3k = z0/(z0+z2)*x02sq + z1/(z1+z2)*x21sq - ( 1.0 + z0*z1/(z0+z2)/(z1+z2) ) * x20x21;
 
 
-    double int_12_bar_j = G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t) - G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t);
-    double int_12_bar_k = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t) - G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t);
+    double int_12_bar_j = G_bar_y( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
+    double int_12_bar_k = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
 
-    double int_22_bar_j = G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t) - G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t);
-    double int_22_bar_k = G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t) - G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t);
+    double int_22_bar_j = G_bar_y( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
+    double int_22_bar_k = G_bar_y( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
 
 
-    double int_21_j = G_integrand_simplified( 2, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
-    double int_21_k = G_integrand_simplified( 2, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
+    double int_21_j = G_y( 2, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
+    double int_21_k = G_y( 2, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
 
-    double int_11_j = G_integrand_simplified( 1, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
-    double int_11_k = G_integrand_simplified( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
+    double int_11_j = G_y( 1, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t);
+    double int_11_k = G_y( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
 
-    double G12_sing_j = 1.0/Sq(x2_j) * gsl_sf_bessel_K0( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
-    double G12_sing_k = 1.0/Sq(x2_k) * gsl_sf_bessel_K0( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+    double G12_sing_j = 1.0/Sq(x2_j) * BesselK0( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+    double G12_sing_k = 1.0/Sq(x2_k) * BesselK0( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double G22_sing_j = 1.0/Sq(x2_j) * sqrt( ( Sq(Qbar_j) + Sq(mf) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double G22_sing_k = 1.0/Sq(x2_k) * sqrt( ( Sq(Qbar_k) + Sq(mf) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double H_j = 4.0 * sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double H_k = 4.0 * sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double term_1j = -z0*z1*Sq(z2)/(16.0*(z0+z2)*Sq(z0+z2)) * x2j_x3j * int_21_j * 8.0 * G12_sing_j;
     double term_1k =  z0*z1*Sq(z2)/(16.0*(z1+z2)*Sq(z1+z2)) * x2k_x3k * int_21_k * 8.0 * G12_sing_k;
@@ -916,26 +933,26 @@ double IT_tripole_Fm_I3_fast(double Q, double mf, double z1, double z2, double x
     double x3j_x3k = z0/(z0+z2)*x02sq + z1/(z1+z2)*x21sq - ( 1.0 + z0*z1/(z0+z2)/(z1+z2) ) * x20x21;
 
 
-    double int_12_bar_j1 = G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1) - G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t1);
-    double int_12_bar_k1 = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1) - G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t1);
-    double int_12_bar_j2 = G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2) - G_integrand_simplified( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t2);
-    double int_12_bar_k2 = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2) - G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t2);
+    double int_12_bar_j1 = G_bar_y( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
+    double int_12_bar_k1 = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
+    double int_12_bar_j2 = G_bar_y( 1, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2);
+    double int_12_bar_k2 = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
 
-    double int_22_bar_j1 = G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1) - G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t1);
-    double int_22_bar_k1 = G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1) - G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t1);
-    double int_22_bar_j2 = G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2) - G_integrand_simplified( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, 0.0, y_t2);
-    double int_22_bar_k2 = G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2) - G_integrand_simplified( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t2);
+    double int_22_bar_j1 = G_bar_y( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
+    double int_22_bar_k1 = G_bar_y( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
+    double int_22_bar_j2 = G_bar_y( 2, 2, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2);
+    double int_22_bar_k2 = G_bar_y( 2, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
 
 
-    double int_21_j1 = G_integrand_simplified( 2, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
-    double int_21_k1 = G_integrand_simplified( 2, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
-    double int_21_j2 = G_integrand_simplified( 2, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2);
-    double int_21_k2 = G_integrand_simplified( 2, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
+    double int_21_j1 = G_y( 2, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
+    double int_21_k1 = G_y( 2, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
+    double int_21_j2 = G_y( 2, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2);
+    double int_21_k2 = G_y( 2, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
 
-    double int_11_j1 = G_integrand_simplified( 1, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
-    double int_11_k1 = G_integrand_simplified( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
-    double int_11_j2 = G_integrand_simplified( 1, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2);
-    double int_11_k2 = G_integrand_simplified( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
+    double int_11_j1 = G_y( 1, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t1);
+    double int_11_k1 = G_y( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
+    double int_11_j2 = G_y( 1, 1, Qbar_j, mf, x2_j, x3_j, omega_j, lambda_j, y_t2);
+    double int_11_k2 = G_y( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
 
 
 
@@ -985,8 +1002,8 @@ double ILdip_massive_LiLogConst(double Q, double z1, double x01sq, double mf) {
         // cout << bessel_inner_fun << " " << Q << " " << z1 << " " << x01sq << endl;
         dip_res = 0;
     }else{
-        dip_res = 4.0*Sq(Q)*Sq(z1)*Sq(1.0-z1)*Sq(gsl_sf_bessel_K0( bessel_inner_fun )) * 
-        ( 5.0/2.0 - Sq(M_PI)/3.0 + Sq(log( z1/(1.0-z1) )) + OmegaL_V(Q,z1,mf) + L_dip(Q,z1,mf) );
+        dip_res = 4.0*Sq(Q)*Sq(z1)*Sq(1.0-z1)*Sq(BesselK0( bessel_inner_fun )) * 
+        ( 5.0/2.0 - Sq(M_PI)/3.0 + Sq(log( z1/(1.0-z1) )) + LdipOmegaL(Q,z1,mf) );
     }   
 
     return dip_res;
@@ -1005,9 +1022,9 @@ double ILdip_massive_Iab(double Q, double z1, double x01sq, double mf, double xi
         // cout << bessel_inner_fun << " " << Q << " " << z1 << " " << x01sq << endl;
         Iab_integrand = 0;
     }else{
-        Iab_integrand = gsl_sf_bessel_K0( bessel_inner_fun ) * 1.0/xi * ( -2.0*log(xi)/(1.0-xi) + (1.0+xi)/2.0 ) *
-                        (2.0*gsl_sf_bessel_K0( bessel_inner_fun ) - gsl_sf_bessel_K0( sqrt( Sq(kappa_z) + (1.0-z1)*xi/(1.0-xi) *Sq(mf) ) * x01 ) 
-                        - gsl_sf_bessel_K0( sqrt( Sq(kappa_z) + z1*xi/(1.0-xi) *Sq(mf) ) * x01 )  );
+        Iab_integrand = BesselK0( bessel_inner_fun ) * 1.0/xi * ( -2.0*log(xi)/(1.0-xi) + (1.0+xi)/2.0 ) *
+                        (2.0*BesselK0( bessel_inner_fun ) - BesselK0( sqrt( Sq(kappa_z) + (1.0-z1)*xi/(1.0-xi) *Sq(mf) ) * x01 ) 
+                        - BesselK0( sqrt( Sq(kappa_z) + z1*xi/(1.0-xi) *Sq(mf) ) * x01 )  );
     }   
 
     double dip_res = front_factor * Iab_integrand;
@@ -1031,10 +1048,10 @@ double ILdip_massive_Icd(double Q, double z1, double x01sq, double mf, double xi
         double CLm2 = Sq(1.0-z1)*(1.0-xi)/(z1) * ( -Sq(xi) + x*(1.0-xi)*( 1.0+(1.0-xi)*(1.0+(1.0-z1)*xi/(z1)) ) / (x*(1.0-xi)+xi/(z1)) );; // C^L_m(1-z,x,xi)
         double kappa1 = xi*Sq(mf)/( (1.0-xi)*(1.0-x)*( x*(1.0-xi)+xi/(1.0-z1) ) ) * ( xi*(1.0-x) + x*(1.0-z1*(1.0-xi)/(1.0-z1)) ); // kappa(z,x,xi)
         double kappa2 = xi*Sq(mf)/( (1.0-xi)*(1.0-x)*( x*(1.0-xi)+xi/(z1) ) ) * ( xi*(1.0-x) + x*(1.0-(1.0-z1)*(1.0-xi)/(z1)) );; // kappa(1-z,x,xi)
-        Icd_integrand = gsl_sf_bessel_K0( bessel_inner_fun ) * Sq(mf)*
-                     ( (gsl_sf_bessel_K0( bessel_inner_fun ) - gsl_sf_bessel_K0( x01*sqrt( Sq(kappa_z)/(1.0-x) + kappa1 ) ) ) *
+        Icd_integrand = BesselK0( bessel_inner_fun ) * Sq(mf)*
+                     ( (BesselK0( bessel_inner_fun ) - BesselK0( x01*sqrt( Sq(kappa_z)/(1.0-x) + kappa1 ) ) ) *
                         CLm1 / ( (1.0-xi)*(1.0-x)*( x*(1.0-xi)+xi/(1.0-z1) ) * ( x/(1.0-x)*Sq(kappa_z) + kappa1 ) ) +
-                        (gsl_sf_bessel_K0( bessel_inner_fun ) - gsl_sf_bessel_K0( x01*sqrt( Sq(kappa_z)/(1.0-x) + kappa2 ) ) ) *
+                        (BesselK0( bessel_inner_fun ) - BesselK0( x01*sqrt( Sq(kappa_z)/(1.0-x) + kappa2 ) ) ) *
                         CLm2 / ( (1.0-xi)*(1.0-x)*( x*(1.0-xi)+xi/(z1) ) * ( x/(1.0-x)*Sq(kappa_z) + kappa2 ) ));
     }   
 
@@ -1067,7 +1084,7 @@ double ILNLOqg_massive_dipole_part_symm(double Q, double mf, double z1, double z
         // cout << bessel_inner_fun << " " << Q << " " << z1 << " " << x01sq << endl;
         res = 0;
     }else{
-        res = -front_factor * 2.0 * Sq(z1) * ( 2.0*z0*(z0+z2) + Sq(z2) ) * facExp/ x02sq * Sq(gsl_sf_bessel_K0( bessel_inner_fun )) ;
+        res = -front_factor * 2.0 * Sq(z1) * ( 2.0*z0*(z0+z2) + Sq(z2) ) * facExp/ x02sq * Sq(BesselK0( bessel_inner_fun )) ;
     }
     return res;
 }
@@ -1108,7 +1125,7 @@ double ILNLOqg_massive_dipole_part(double Q, double mf, double z1, double z2, do
         // cout << bessel_inner_fun << " " << Q << " " << z1 << " " << x01sq << endl;
         res1 = 0;
     }else{
-        res1 = -front_factor * Sq(z1) * ( 2.0*z0*(z0+z2) + Sq(z2) ) * facExp1/ x02sq * Sq(gsl_sf_bessel_K0( bessel_inner_fun_k )) ;
+        res1 = -front_factor * Sq(z1) * ( 2.0*z0*(z0+z2) + Sq(z2) ) * facExp1/ x02sq * Sq(BesselK0( bessel_inner_fun_k )) ;
     }
 
 
@@ -1116,7 +1133,7 @@ double ILNLOqg_massive_dipole_part(double Q, double mf, double z1, double z2, do
         // cout << bessel_inner_fun << " " << Q << " " << z1 << " " << x01sq << endl;
         res2 = 0;
     }else{
-        res2 = -front_factor * Sq(z0) * ( 2.0*z1*(z1+z2) + Sq(z2) ) * facExp2/ x21sq * Sq(gsl_sf_bessel_K0( bessel_inner_fun_l )) ;
+        res2 = -front_factor * Sq(z0) * ( 2.0*z1*(z1+z2) + Sq(z2) ) * facExp2/ x21sq * Sq(BesselK0( bessel_inner_fun_l )) ;
     }
 
     double res = res1 + res2;
@@ -1327,9 +1344,9 @@ double ILNLOqg_massive_tripole_part_I1(double Q, double mf, double z1, double z2
     double x3_l = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
 
-    double term_k = 1.0/x02sq * Sq(z1) * ( 2.0*z0*(z0+z2) +Sq(z2) ) * Sq( gsl_sf_bessel_K0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq ) )  );
-    double term_l = 1.0/x21sq * Sq(z0) * ( 2.0*z1*(z1+z2) +Sq(z2) ) * Sq( gsl_sf_bessel_K0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq ) )  );
-    double term_kl = -2.0 * z0 *z1 * ( z0*(1.0-z0) + z1*(1.0-z1) ) * x20x21 / (x02sq * x21sq) * gsl_sf_bessel_K0( sqrt( Sq(Qbar_k) + Sq(mf)) * sqrt(Sq(x3_k) + omega_k * x02sq) ) * gsl_sf_bessel_K0( sqrt( Sq(Qbar_l) + Sq(mf)) * sqrt(Sq(x3_l) + omega_l * x21sq) );
+    double term_k = 1.0/x02sq * Sq(z1) * ( 2.0*z0*(z0+z2) +Sq(z2) ) * Sq( BesselK0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq ) )  );
+    double term_l = 1.0/x21sq * Sq(z0) * ( 2.0*z1*(z1+z2) +Sq(z2) ) * Sq( BesselK0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq ) )  );
+    double term_kl = -2.0 * z0 *z1 * ( z0*(1.0-z0) + z1*(1.0-z1) ) * x20x21 / (x02sq * x21sq) * BesselK0( sqrt( Sq(Qbar_k) + Sq(mf)) * sqrt(Sq(x3_k) + omega_k * x02sq) ) * BesselK0( sqrt( Sq(Qbar_l) + Sq(mf)) * sqrt(Sq(x3_l) + omega_l * x21sq) );
 
 
     double res = front_factor * ( term_k + term_l + term_kl );
@@ -1358,8 +1375,8 @@ double ILNLOqg_massive_dipole_part_I1(double Q, double mf, double z1, double z2,
 
 
 
-    double term_k = -1.0/x02sq * Sq(z1) * ( 2.0*z0*(z0+z2) +Sq(z2) ) * exp( -x02sq / x01sq / exp(M_EULER) ) * Sq( gsl_sf_bessel_K0( sqrt( Sq(Qbar_k) + Sq(mf) ) * sqrt(x01sq) )  );
-    double term_l = -1.0/x21sq * Sq(z0) * ( 2.0*z1*(z1+z2) +Sq(z2) ) * exp( -x21sq / x01sq / exp(M_EULER) ) * Sq( gsl_sf_bessel_K0( sqrt( Sq(Qbar_l) + Sq(mf) ) * sqrt(x01sq) )  );
+    double term_k = -1.0/x02sq * Sq(z1) * ( 2.0*z0*(z0+z2) +Sq(z2) ) * exp( -x02sq / x01sq / exp(M_EULER) ) * Sq( BesselK0( sqrt( Sq(Qbar_k) + Sq(mf) ) * sqrt(x01sq) )  );
+    double term_l = -1.0/x21sq * Sq(z0) * ( 2.0*z1*(z1+z2) +Sq(z2) ) * exp( -x21sq / x01sq / exp(M_EULER) ) * Sq( BesselK0( sqrt( Sq(Qbar_l) + Sq(mf) ) * sqrt(x01sq) )  );
 
     double res = front_factor * ( term_k + term_l );
     return res;
@@ -1388,18 +1405,18 @@ double ILNLOqg_massive_tripole_part_I2_fast(double Q, double mf, double z1, doub
     double x3_l = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
 
-    double int_12_bar_k = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t)-G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t);
-    double int_12_bar_l = G_integrand_simplified( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t)-G_integrand_simplified( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, 0.0, y_t);
+    double int_12_bar_k = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t);
+    double int_12_bar_l = G_bar_y( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t);
 
 
 
     double term_k = Sq(z1) * ( 2.0*z0*(z0+z2) +Sq(z2) ) * 1.0/(4.0) * int_12_bar_k
-                    * gsl_sf_bessel_K0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq )   );
+                    * BesselK0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq )   );
     double term_l = Sq(z0) * ( 2.0*z1*(z1+z2) +Sq(z2) ) * 1.0/(4.0) * int_12_bar_l 
-                    * gsl_sf_bessel_K0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq )   );
+                    * BesselK0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq )   );
     double term_kl = -1.0/4.0 * z0*z1 * ( z0*(1.0-z0) + z1*(1.0-z1) ) * x20x21  * (
-        1.0/( x21sq ) * int_12_bar_k * gsl_sf_bessel_K0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq ))
-        + 1.0/( x02sq ) * int_12_bar_l * gsl_sf_bessel_K0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq ))
+        1.0/( x21sq ) * int_12_bar_k * BesselK0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq ))
+        + 1.0/( x02sq ) * int_12_bar_l * BesselK0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq ))
     );
 
     double res = front_factor * ( term_k + term_l + term_kl );
@@ -1427,16 +1444,16 @@ double ILNLOqg_massive_tripole_part_I3_fast(double Q, double mf, double z1, doub
     double x3_k = sqrt( Sq(z0) / Sq(z0+z2) * x02sq + x21sq - 2.0 * z0/(z0+z2) *x20x21 );
     double x3_l = sqrt( Sq(z1) / Sq(z1+z2) * x21sq + x02sq - 2.0 * z1/(z1+z2) *x20x21 );
 
-    double int_12_bar_k1 = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1)-G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t1);
-    double int_12_bar_l1 = G_integrand_simplified( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t1)-G_integrand_simplified( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, 0.0, y_t1);
-    double int_12_bar_k2 = G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2)-G_integrand_simplified( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, 0.0, y_t2);
-    double int_12_bar_l2 = G_integrand_simplified( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t2)-G_integrand_simplified( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, 0.0, y_t2);
+    double int_12_bar_k1 = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
+    double int_12_bar_l1 = G_bar_y( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t1);
+    double int_12_bar_k2 = G_bar_y( 1, 2, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
+    double int_12_bar_l2 = G_bar_y( 1, 2, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t2);
 
 
-    double int_11_k1 = G_integrand_simplified( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
-    double int_11_l1 = G_integrand_simplified( 1, 1, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t1);
-    double int_11_k2 = G_integrand_simplified( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
-    double int_11_l2 = G_integrand_simplified( 1, 1, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t2);
+    double int_11_k1 = G_y( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t1);
+    double int_11_l1 = G_y( 1, 1, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t1);
+    double int_11_k2 = G_y( 1, 1, Qbar_k, mf, x2_k, x3_k, omega_k, lambda_k, y_t2);
+    double int_11_l2 = G_y( 1, 1, Qbar_l, mf, x2_l, x3_l, omega_l, lambda_l, y_t2);
 
 
 
@@ -1465,8 +1482,8 @@ double ITdip_massive_0(double Q, double z1, double x01sq, double mf) {
 
     double kappa_z = sqrt( z1*(1.0-z1)*Sq(Q) + Sq(mf) );
 
-    double term1 = Sq( kappa_z * gsl_sf_bessel_K1( x01 *kappa_z ) ) * ( ( Sq(z1) + Sq(1.0-z1) ) * ( 5.0/2.0 - Sq(M_PI)/3.0 + Sq( log(z1/(1.0-z1)) ) + OmegaT_V_unsymmetric(Q, z1, mf) + OmegaT_V_unsymmetric(Q, 1.0-z1, mf) + L_dip(Q,z1,mf)  ) + (2.0*z1-1.0)/2.0 * (OmegaT_N_unsymmetric(Q, z1, mf)-OmegaT_N_unsymmetric(Q, 1.0-z1, mf) ) );
-    double term2 = Sq( mf * gsl_sf_bessel_K0( x01 *kappa_z ) ) * ( 3.0 -Sq(M_PI)/3.0 + Sq(log(z1/(1.0-z1))) + OmegaT_V_unsymmetric(Q, z1, mf) + OmegaT_V_unsymmetric(Q, 1.0-z1, mf) + L_dip( Q, z1, mf )  );
+    double term1 = Sq( kappa_z * BesselK1( x01 *kappa_z ) ) * ( ( Sq(z1) + Sq(1.0-z1) ) * ( 5.0/2.0 - Sq(M_PI)/3.0 + Sq( log(z1/(1.0-z1)) ) + LdipOmegaT_V(Q, z1, mf) ) + (2.0*z1-1.0)/2.0 * OmegaT_N(Q, z1, mf) );
+    double term2 = Sq( mf * BesselK0( x01 *kappa_z ) ) * ( 3.0 -Sq(M_PI)/3.0 + Sq(log(z1/(1.0-z1))) + LdipOmegaT_V(Q, z1, mf) );
 
     double res= term1 + term2;
 
@@ -1482,8 +1499,8 @@ double ITdip_massive_1(double Q, double z1, double x01sq, double mf, double xi)
 
     double kappa_z = sqrt( z1*(1.0-z1)*Sq(Q) + Sq(mf) );
 
-    double term1 = kappa_z * gsl_sf_bessel_K1( x01 * kappa_z) * ( Sq(z1) + Sq(1.0-z1) ) * (IT_V1_unsymmetric(Q, z1, mf, x01, xi) + IT_V1_unsymmetric(Q, 1.0-z1, mf, x01, xi) );
-    double term2 = Sq(mf) * gsl_sf_bessel_K0( x01 * kappa_z ) * (IT_VMS1_unsymmetric(Q, z1, mf, x01, xi) + IT_VMS1_unsymmetric(Q, 1.0-z1, mf, x01, xi) );
+    double term1 = kappa_z * BesselK1( x01 * kappa_z) * ( Sq(z1) + Sq(1.0-z1) ) * (IT_V1_unsymmetric(Q, z1, mf, x01, xi) + IT_V1_unsymmetric(Q, 1.0-z1, mf, x01, xi) );
+    double term2 = Sq(mf) * BesselK0( x01 * kappa_z ) * (IT_VMS1_unsymmetric(Q, z1, mf, x01, xi) + IT_VMS1_unsymmetric(Q, 1.0-z1, mf, x01, xi) );
 
     double res= term1 + term2;
 
@@ -1499,10 +1516,10 @@ double ITdip_massive_2(double Q, double z1, double x01sq, double mf, double y_ch
 
     double kappa_z = sqrt( z1*(1.0-z1)*Sq(Q) + Sq(mf) );
 
-    double term1 = kappa_z * gsl_sf_bessel_K1( x01 * kappa_z) * ( 
+    double term1 = kappa_z * BesselK1( x01 * kappa_z) * ( 
         ( Sq(z1) + Sq(1.0-z1) ) * (IT_V2_unsymmetric(Q, z1, mf, x01, y_chi, y_u) + IT_V2_unsymmetric(Q, 1.0-z1, mf, x01, y_chi, y_u) )   
         +  (2.0*z1-1.0)/2.0 * (IT_N_unsymmetric(Q, z1, mf, x01, y_chi, y_u) - IT_N_unsymmetric(Q, 1.0-z1, mf, x01, y_chi, y_u) ) );
-    double term2 = Sq(mf) * gsl_sf_bessel_K0( x01 * kappa_z ) * (IT_VMS2_unsymmetric(Q, z1, mf, x01, y_chi, y_u) + IT_VMS2_unsymmetric(Q, 1.0-z1, mf, x01, y_chi, y_u) );
+    double term2 = Sq(mf) * BesselK0( x01 * kappa_z ) * (IT_VMS2_unsymmetric(Q, z1, mf, x01, y_chi, y_u) + IT_VMS2_unsymmetric(Q, 1.0-z1, mf, x01, y_chi, y_u) );
 
     double res= term1 + term2;
 
@@ -1588,11 +1605,11 @@ double IT_tripole_jk_I2(double Q, double mf, double z1, double z2, double x01sq,
     double term_j = 1.0/(Sq(y_u) * u * omega_j * Sq(t_j)  )
                     * 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2)) * ( 1.0-2.0*z1*(1.0-z1) ) 
                     * g_bar_j * Sq(x3_j)/8.0 * sqrt( ( Sq(Qbar_j) + Sq(mf) ) / (Sq(x3_j) + omega_j * Sq(x2_j) ) )
-                    * gsl_sf_bessel_K1( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) )  ;
+                    * BesselK1( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) )  ;
     double term_k = 1.0/(Sq(y_u) * u * omega_k * Sq(t_k)  )
                     * 1.0/Sq(z1+z2) * (2.0*z1*(z1+z2)+Sq(z2)) * ( 1.0-2.0*z0*(1.0-z0) ) 
                     * g_bar_k * Sq(x3_k)/8.0 * sqrt( ( Sq(Qbar_k) + Sq(mf) ) / (Sq(x3_k) + omega_k * Sq(x2_k) ) )
-                    * gsl_sf_bessel_K1( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) )  ;
+                    * BesselK1( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) )  ;
 
     double res = term_j + term_k;
 
@@ -1678,10 +1695,10 @@ double IT_tripole_jkm_I2(double Q, double mf, double z1, double z2, double x01sq
 
     double term_j = 1.0/(Sq(y_u) * omega_j * Sq(t_j)  )
                     * 1.0/Sq(z0+z2) * (2.0*z0*(z0+z2)+Sq(z2))
-                    * g_bar_j/4.0 * gsl_sf_bessel_K0( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) )  ;
+                    * g_bar_j/4.0 * BesselK0( sqrt( Sq(x3_j) + omega_j * Sq(x2_j) ) * sqrt( Sq(Qbar_j) + Sq(mf) ) )  ;
     double term_k = 1.0/(Sq(y_u) * omega_k * Sq(t_k)  )
                     * 1.0/Sq(z1+z2) * (2.0*z1*(z1+z2)+Sq(z2))
-                    * g_bar_k/4.0 * gsl_sf_bessel_K0( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) )  ;
+                    * g_bar_k/4.0 * BesselK0( sqrt( Sq(x3_k) + omega_k * Sq(x2_k) ) * sqrt( Sq(Qbar_k) + Sq(mf) ) )  ;
 
     double res = Sq(mf) * (term_j + term_k);
 
@@ -1769,14 +1786,14 @@ double IT_tripole_F_I2(double Q, double mf, double z1, double z2, double x01sq,
 
 
     double G22_sing_j = 1.0/Sq(x2_j) * sqrt( ( Sq(Qbar_j) + Sq(mf) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double G22_sing_k = 1.0/Sq(x2_k) * sqrt( ( Sq(Qbar_k) + Sq(mf) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double H_j = 4.0 * sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double H_k = 4.0 * sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double term_1 = 1.0/(4.0*(z0+z2)*(z1+z2)) * (z2*Sq(z0-z1)* ( x2j_x3j * x2k_x3k - x2k_x3j * x2j_x3k ) 
                     - (z1*(z0+z2)+z0*(z1+z2))* (z0*(z0+z2)+z1*(z1+z2))*x20x21 * x3j_x3k  )
@@ -1877,18 +1894,18 @@ double IT_tripole_Fm_I2(double Q, double mf, double z1, double z2, double x01sq,
     double g_j = exp( -u * (Sq(Qbar_j)+Sq(mf)) - Sq(x3_j)/(4.0*u) ) * exp( -x02sq/(4.0*t_j) ) * exp(-t_j*omega_j*lambda_j*Sq(mf));
     double g_k = exp( -u * (Sq(Qbar_k)+Sq(mf)) - Sq(x3_k)/(4.0*u) ) * exp( -x21sq/(4.0*t_k) ) * exp(-t_k*omega_k*lambda_k*Sq(mf));
 
-    double G12_sing_j = 1.0/Sq(x2_j) * gsl_sf_bessel_K0( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
-    double G12_sing_k = 1.0/Sq(x2_k) * gsl_sf_bessel_K0( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+    double G12_sing_j = 1.0/Sq(x2_j) * BesselK0( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+    double G12_sing_k = 1.0/Sq(x2_k) * BesselK0( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double G22_sing_j = 1.0/Sq(x2_j) * sqrt( ( Sq(Qbar_j) + Sq(mf) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_j) + Sq(mf) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double G22_sing_k = 1.0/Sq(x2_k) * sqrt( ( Sq(Qbar_k) + Sq(mf) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                        * gsl_sf_bessel_K1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                        * BesselK1( sqrt(( Sq(Qbar_k) + Sq(mf) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double H_j = 4.0 * sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) / ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_j) + Sq(mf) * (1.0+lambda_j) ) * ( Sq(x3_j) + omega_j * Sq(x2_j) ) ) );
     double H_k = 4.0 * sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) / ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) 
-                * gsl_sf_bessel_K1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
+                * BesselK1( sqrt( ( Sq(Qbar_k) + Sq(mf) * (1.0+lambda_k) ) * ( Sq(x3_k) + omega_k * Sq(x2_k) ) ) );
 
     double term_1j = -z0*z1*Sq(z2)/(16.0*(z0+z2)*Sq(z0+z2)) * x2j_x3j * u/(Sq(y_u)*omega_j*Sq(u)*t_j) * g_j * 8.0 * G12_sing_j;
     double term_1k =  z0*z1*Sq(z2)/(16.0*(z1+z2)*Sq(z1+z2)) * x2k_x3k * u/(Sq(y_u)*omega_k*Sq(u)*t_k) * g_k * 8.0 * G12_sing_k;
@@ -2012,12 +2029,12 @@ double ILNLOqg_massive_tripole_part_I2(double Q, double mf, double z1, double z2
 
 
     double term_k = Sq(z1) * ( 2.0*z0*(z0+z2) +Sq(z2) ) * 1.0/(4.0*Sq(t_k)) * 1/(omega_k*Sq(y_u)) * g_bar_k 
-                    * gsl_sf_bessel_K0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq )   );
+                    * BesselK0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq )   );
     double term_l = Sq(z0) * ( 2.0*z1*(z1+z2) +Sq(z2) ) * 1.0/(4.0*Sq(t_l)) * 1/(omega_l*Sq(y_u))* g_bar_l 
-                    * gsl_sf_bessel_K0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq )   );
+                    * BesselK0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq )   );
     double term_kl = -1.0/4.0 * z0*z1 * ( z0*(1.0-z0) + z1*(1.0-z1) ) * x20x21 / Sq(y_u) * (
-        1.0/( x21sq * Sq(t_k) * omega_k ) * g_bar_k * gsl_sf_bessel_K0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq ))
-        + 1.0/( x02sq * Sq(t_l) * omega_l ) * g_bar_l * gsl_sf_bessel_K0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq ))
+        1.0/( x21sq * Sq(t_k) * omega_k ) * g_bar_k * BesselK0( sqrt( Sq(Qbar_l) + Sq(mf) ) *sqrt( Sq(x3_l) + omega_l * x21sq ))
+        + 1.0/( x02sq * Sq(t_l) * omega_l ) * g_bar_l * BesselK0( sqrt( Sq(Qbar_k) + Sq(mf) ) *sqrt( Sq(x3_k) + omega_k * x02sq ))
     );
 
     double res = front_factor * ( term_k + term_l + term_kl );
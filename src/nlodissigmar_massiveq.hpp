@@ -38,6 +38,8 @@ double IT_tripole_Fm_I3_fast( double Q, double mf, double z1, double z2, double
 double G_qg_int(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda);
 double G_qg(int a, int b, double y_u, double y_t, double Qbar, double mf, double x2, double x3, double omega, double lambda);
 double G_integrand_simplified(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda, double y);
+double G_y(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda, double y);
+double G_bar_y(int a, int b, double Qbar, double mf, double x2, double x3, double omega, double lambda, double y);
 
 
 // ---------------- LONGITUDINAL INTEGRANDS ------------------------
@@ -0,0 +1,153 @@
+/*
+ * LCPT NLO DIS fitter
+ * Tabulated photon wavefunction overlaps of the LO structure functions
+ */
+
+#include <cmath>
+#include <vector>
+#include <random>
+#include <iostream>
+#include <algorithm>
+#include "photonoverlap.hpp"
+#include "quadrature.hpp"
+#include "bessel.hpp"
+#include "lagrangegrid.hpp"
+
+using std::cout; using std::endl;
+
+namespace
+{
+    inline double Sq(double x) { return x*x; }
+
+    // Grids in u = ln(Q r) and s = ln(mf/Q)
+    const double OVERLAP_MINU = -18;
+    const double OVERLAP_MAXU = 11;
+    const double OVERLAP_MINS = -12;
+    const double OVERLAP_MAXS = 4;
+    const double MASSLESS_STEP = 0.05;
+    const double MASSIVE_STEP = 0.1;
+    // Maximum relative error of the tables, a table which exceeds it at half the step is not used
+    const double OVERLAP_TOLERANCE = 1e-5;
+    // Quark momentum fractions below ZMIN/(1 + (Q r)^2) contribute less than ~ZMIN relative to W
+    const double ZMIN = 1e-10;
+
+    // Tables 0: L, 1: T
+    LagrangeGrid massless_tables[2];
+    LagrangeGrid massive_tables[2];
+    bool massless_valid[2] = { false, false };  // Within OVERLAP_TOLERANCE
+    bool massive_valid[2] = { false, false };
+    bool tables_built = false;
+
+    // W(Q, mf; r) e^(2 mf r)/Q^2 as a function of qr = Q r and mu = mf/Q, integrated
+    // over z < 1/2 in ln z with a composite Gauss-Legendre rule of panels of the given width
+    double OverlapScaled(int pol, double qr, double mu, int order=8, double width=1.0)
+    {
+        const double tmin = std::log(ZMIN/(1.0 + Sq(qr)));
+        const double tmax = std::log(0.5);
+        std::vector<double> nodes, weights;
+        GaussLegendreNodes(order, tmin, tmax, nodes, weights, std::max(1, static_cast<int>(std::ceil((tmax-tmin)/width))));
+
+        double sum = 0;
+        for (size_t i=0; i<nodes.size(); i++)
+        {
+            const double z = std::exp(nodes[i]);
+            const double epsq = z*(1.0-z) + Sq(mu);
+            const double x = std::sqrt(epsq)*qr;
+            const double damping = std::exp(-2.0*(x - mu*qr));
+            double v;
+            if (pol == 0)
+                v = 4.0*Sq(z*(1.0-z)*FastBesselK0_scaled(x));
+            else
+                v = (Sq(z) + Sq(1.0-z))*epsq*Sq(FastBesselK1_scaled(x)) + Sq(mu*FastBesselK0_scaled(x));
+            sum += weights[i]*z*v*damping;
+        }
+        return 2.0*sum;
+    }
+
+    void FillTable(LagrangeGrid& grid, int pol, bool massive, double step)
+    {
+        const double minc[2] = { OVERLAP_MINU, OVERLAP_MINS };
+        const double maxc[2] = { OVERLAP_MAXU, OVERLAP_MAXS };
+        grid.Init(massive ? 2 : 1, minc, maxc, step);
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (int i=0; i<grid.Size(); i++)
+        {
+            double c[2];
+            grid.Node(i, c);
+            grid[i] = std::log(OverlapScaled(pol, std::exp(c[0]), massive ? std::exp(c[1]) : 0));
+        }
+    }
+
+    // Maximum relative error at random points inside the grid, compared to a
+    // z quadrature with 4 times more nodes
+    double TableError(const LagrangeGrid& grid, int pol, bool massive)
+    {
+        std::mt19937 gen(pol+1);
+        std::uniform_real_distribution<double> rnd(0, 1);
+        double maxerr = 0;
+        for (int i=0; i<1000; i++)
+        {
+            double c[2] = { OVERLAP_MINU + (OVERLAP_MAXU - OVERLAP_MINU)*rnd(gen),
+                OVERLAP_MINS + (OVERLAP_MAXS - OVERLAP_MINS)*rnd(gen) };
+            double ref = OverlapScaled(pol, std::exp(c[0]), massive ? std::exp(c[1]) : 0, 16, 0.5);
+            maxerr = std::max(maxerr, std::abs(std::exp(grid.Interpolate(c))/ref - 1.0));
+        }
+        return maxerr;
+    }
+
+    // Fill the table, with half the step if the error exceeds OVERLAP_TOLERANCE. Returns
+    // false if the table is not within the tolerance
+    bool BuildTable(LagrangeGrid& grid, int pol, bool massive)
+    {
+        const char* pols[2] = { "L", "T" };
+        const double step = massive ? MASSIVE_STEP : MASSLESS_STEP;
+        FillTable(grid, pol, massive, step);
+        double err = TableError(grid, pol, massive);
+        if (err > OVERLAP_TOLERANCE)
+        {
+            FillTable(grid, pol, massive, 0.5*step);
+            err = TableError(grid, pol, massive);
+        }
+        cout << "# Tabulated photon overlap W_" << pols[pol] << " (" << (massive ? "massive" : "massless") << "): "
+            << grid.Size() << " points, step " << grid.Step() << ", max relative error " << err << endl;
+        if (err > OVERLAP_TOLERANCE)
+        {
+            std::cerr << "# Table of W_" << pols[pol] << " (" << (massive ? "massive" : "massless") << ") exceeds the tolerance "
+                << OVERLAP_TOLERANCE << ", it is integrated directly" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool BuildTables()
+    {
+        for (int pol=0; pol<2; pol++)
+        {
+            massless_valid[pol] = BuildTable(massless_tables[pol], pol, false);
+            massive_valid[pol] = BuildTable(massive_tables[pol], pol, true);
+        }
+        tables_built = true;
+        return true;
+    }
+}
+
+void InitPhotonOverlapTables()
+{
+    // Function-local statics are built once, also when called from several threads
+    static const bool built = BuildTables();
+    (void)built;
+}
+
+double PhotonOverlap(int pol, double Q, double mf, double r)
+{
+    const double qr = Q*r;
+    const double c[2] = { std::log(qr), mf > 0 ? std::log(mf/Q) : OVERLAP_MINS };
+    double w;
+    if (!tables_built || !(mf > 0 ? massive_valid[pol] : massless_valid[pol])
+        || c[0] < OVERLAP_MINU || c[0] > OVERLAP_MAXU
+        || (mf > 0 && (c[1] < OVERLAP_MINS || c[1] > OVERLAP_MAXS)))
+        w = OverlapScaled(pol, qr, mf/Q);
+    else
+        w = std::exp((mf > 0 ? massive_tables[pol] : massless_tables[pol]).Interpolate(c));
+    return Sq(Q)*w*std::exp(-2.0*mf*r);
+}
@@ -0,0 +1,33 @@
+/*
+ * LCPT NLO DIS fitter
+ * Tabulated photon wavefunction overlaps of the LO structure functions
+ */
+
+#ifndef _PHOTON_OVERLAP_HPP
+#define _PHOTON_OVERLAP_HPP
+
+/*
+ * The z1 integrals of the LO photon wavefunction overlaps (ILLO, ITLO and the
+ * massive integrand_ILLOpMass, integrand_ITLOpMass)
+ *   W_L(Q, mf; r) = \int_0^1 dz 4 Q^2 z^2 (1-z)^2 K_0^2(eps r)
+ *   W_T(Q, mf; r) = \int_0^1 dz [ (z^2 + (1-z)^2) eps^2 K_1^2(eps r) + mf^2 K_0^2(eps r) ],
+ *   eps^2 = z(1-z) Q^2 + mf^2,
+ * which do not depend on the dipole, so that the LO structure functions are the
+ * 1D integrals F ~ \int dr r N(r, X(r)) W(Q, mf; r), see ComputeSigmaR::LOp_overlap.
+ *
+ * W/Q^2 depends on Q r and mf/Q only, and is tabulated in ln(Q r) for massless quarks
+ * and in ln(Q r), ln(mf/Q) for massive ones. The logarithm of W e^(2 mf r)/Q^2 is
+ * interpolated with 4-point Lagrange polynomials in each variable, and the z integral
+ * at the nodes is done with a composite Gauss-Legendre rule in ln z. Outside the tables
+ * W is integrated directly. The tables are built once per process by
+ * InitPhotonOverlapTables, which reports the maximum relative error at random points.
+ * A table with an error above the tolerance is rebuilt with half the step, and if it
+ * still exceeds it, W is integrated directly instead.
+ */
+
+void InitPhotonOverlapTables();
+
+// W_L (pol = 0) or W_T (pol = 1) at dipole size r
+double PhotonOverlap(int pol, double Q, double mf, double r);
+
+#endif
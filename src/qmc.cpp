@@ -0,0 +1,215 @@
+/*
+ * LCPT NLO DIS fitter
+ * Randomized quasi-Monte Carlo integration over the unit hypercube
+ */
+
+#include <cmath>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "qmc.hpp"
+#include "nlodis_config.hpp"
+
+using std::cerr; using std::endl;
+
+namespace
+{
+    const int BITS = 32;
+    // Points per randomization in the first round, and per parallel block
+    const int MINPOINTS = 1024;
+    const int BLOCK = 256;
+    const unsigned int SEED = 1;
+
+    // Primitive polynomials (degree s, coefficients a) and initial direction numbers m
+    // of the Sobol dimensions 2..QMC_MAXDIM (Joe and Kuo 2008), the first is van der Corput
+    struct DirectionNumbers
+    {
+        int s, a;
+        uint32_t m[5];
+    };
+    const DirectionNumbers SOBOL_DIRECTIONS[QMC_MAXDIM-1] = {
+        {1, 0, {1}},
+        {2, 1, {1, 3}},
+        {3, 1, {1, 3, 1}},
+        {3, 2, {1, 1, 1}},
+        {4, 1, {1, 1, 3, 3}},
+        {4, 4, {1, 3, 5, 13}},
+        {5, 2, {1, 1, 5, 5, 17}},
+        {5, 4, {1, 1, 5, 5, 5}},
+        {5, 7, {1, 1, 7, 11, 19}},
+        {5, 11, {1, 1, 5, 1, 1}},
+        {5, 13, {1, 1, 1, 3, 11}}
+    };
+
+    // Generating matrix of dimension d, column k is the 32 bit binary fraction v[k]
+    void SobolMatrix(int d, uint32_t v[BITS])
+    {
+        if (d == 0)
+        {
+            for (int k=0; k<BITS; k++)
+                v[k] = 1u << (BITS-1-k);
+            return;
+        }
+        const DirectionNumbers& dn = SOBOL_DIRECTIONS[d-1];
+        for (int k=0; k<dn.s; k++)
+            v[k] = dn.m[k] << (BITS-1-k);
+        for (int k=dn.s; k<BITS; k++)
+        {
+            v[k] = v[k-dn.s] ^ (v[k-dn.s] >> dn.s);
+            for (int j=1; j<dn.s; j++)
+                if ((dn.a >> (dn.s-1-j)) & 1)
+                    v[k] ^= v[k-j];
+        }
+    }
+
+    inline int Parity(uint32_t x)
+    {
+        x ^= x >> 16;
+        x ^= x >> 8;
+        x ^= x >> 4;
+        x ^= x >> 2;
+        x ^= x >> 1;
+        return x & 1;
+    }
+
+    // Scrambled generating matrices and digital shifts of one randomization
+    struct Randomization
+    {
+        std::vector<uint32_t> v;        // v[d*BITS + k]
+        std::vector<uint32_t> shift;    // shift[d]
+    };
+
+    // Random lower triangular matrix with unit diagonal applied to the digits of every column
+    Randomization Randomize(int ndim, std::mt19937& gen)
+    {
+        Randomization r;
+        r.v.resize(ndim*BITS);
+        r.shift.resize(ndim);
+        for (int d=0; d<ndim; d++)
+        {
+            uint32_t v[BITS], rows[BITS];
+            SobolMatrix(d, v);
+            // Row j gives digit j (bit BITS-1-j) from the digits 0..j
+            for (int j=0; j<BITS; j++)
+            {
+                const uint32_t digits = ~((1u << (BITS-1-j)) - 1u);
+                rows[j] = (static_cast<uint32_t>(gen()) & digits) | (1u << (BITS-1-j));
+            }
+            for (int k=0; k<BITS; k++)
+            {
+                uint32_t c = 0;
+                for (int j=0; j<BITS; j++)
+                    c |= static_cast<uint32_t>(Parity(rows[j] & v[k])) << (BITS-1-j);
+                r.v[d*BITS + k] = c;
+            }
+            r.shift[d] = static_cast<uint32_t>(gen());
+        }
+        return r;
+    }
+
+    // Point i of the randomized sequence in Gray code order. The points are moved by
+    // half of the resolution, so that no coordinate is exactly 0.
+    void Point(const Randomization& r, int ndim, uint32_t i, double x[])
+    {
+        const uint32_t gray = i ^ (i >> 1);
+        for (int d=0; d<ndim; d++)
+        {
+            uint32_t c = r.shift[d];
+            for (int k=0; gray >> k; k++)
+                if ((gray >> k) & 1)
+                    c ^= r.v[d*BITS + k];
+            x[d] = (c + 0.5)/4294967296.0;
+        }
+    }
+
+    // Sum of the integrand over the points [begin, end) of a randomization
+    void BlockSum(qmc_integrand_t integrand, void *userdata, int ndim, int ncomp, int nvec,
+        const Randomization& r, uint32_t begin, uint32_t end, double sum[])
+    {
+        int core = 0;
+#ifdef _OPENMP
+        core = omp_get_thread_num();
+#endif
+        std::vector<double> x(nvec*ndim), f(nvec*ncomp);
+        for (int c=0; c<ncomp; c++)
+            sum[c] = 0;
+        for (uint32_t i=begin; i<end; i+=nvec)
+        {
+            const int n = std::min<uint32_t>(nvec, end-i);
+            for (int j=0; j<n; j++)
+                Point(r, ndim, i+j, &x[j*ndim]);
+            integrand(&ndim, &x[0], &ncomp, &f[0], userdata, &n, &core);
+            for (int j=0; j<n; j++)
+                for (int c=0; c<ncomp; c++)
+                    sum[c] += f[j*ncomp + c];
+        }
+    }
+}
+
+void QMCIntegrate(int ndim, int ncomp, qmc_integrand_t integrand, void *userdata, int nvec,
+    double epsrel, double epsabs, int maxeval, int *neval, int *fail,
+    double integral[], double error[], double prob[])
+{
+    if (ndim < 1 || ndim > QMC_MAXDIM)
+    {
+        cerr << "QMC integration supports 1 to " << QMC_MAXDIM << " dimensions, asked " << ndim << endl;
+        exit(1);
+    }
+    const int nrand = std::max(nlodis_config::QMC_RANDOMIZATIONS, 2);
+    nvec = std::max(nvec, 1);
+    std::mt19937 gen(SEED);
+    std::vector<Randomization> rand;
+    for (int r=0; r<nrand; r++)
+        rand.push_back(Randomize(ndim, gen));
+
+    std::vector<double> sums(nrand*ncomp, 0);
+    uint32_t done = 0, target = MINPOINTS;
+    *fail = 0;
+    while (true)
+    {
+        // Blocks of the new points of every randomization
+        const int blocks = (target-done)/BLOCK;
+        std::vector<double> blocksums(nrand*blocks*ncomp);
+        #pragma omp parallel for schedule(dynamic)
+        for (int b=0; b<nrand*blocks; b++)
+        {
+            const uint32_t begin = done + (b % blocks)*BLOCK;
+            BlockSum(integrand, userdata, ndim, ncomp, nvec, rand[b/blocks], begin, begin+BLOCK, &blocksums[b*ncomp]);
+        }
+        for (int b=0; b<nrand*blocks; b++)
+            for (int c=0; c<ncomp; c++)
+                sums[(b/blocks)*ncomp + c] += blocksums[b*ncomp + c];
+        done = target;
+
+        bool converged = true;
+        for (int c=0; c<ncomp; c++)
+        {
+            double mean = 0, var = 0;
+            for (int r=0; r<nrand; r++)
+                mean += sums[r*ncomp + c]/done;
+            mean /= nrand;
+            for (int r=0; r<nrand; r++)
+                var += std::pow(sums[r*ncomp + c]/done - mean, 2);
+            integral[c] = mean;
+            error[c] = std::sqrt(var/(nrand-1)/nrand);
+            prob[c] = 0;
+            if (!(error[c] <= std::max(epsabs, epsrel*std::abs(mean))))
+                converged = false;
+        }
+        if (converged)
+            break;
+        if (2.0*nrand*done > maxeval || done >= (1u << (BITS-1)))
+        {
+            *fail = 1;
+            break;
+        }
+        target = 2*done;
+    }
+    *neval = nrand*done;
+}
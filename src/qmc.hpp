@@ -0,0 +1,34 @@
+/*
+ * LCPT NLO DIS fitter
+ * Randomized quasi-Monte Carlo integration over the unit hypercube
+ */
+
+#ifndef _QMC_HPP
+#define _QMC_HPP
+
+/*
+ * The integral is estimated with QMC_RANDOMIZATIONS independent randomizations of a
+ * Sobol sequence (random linear scrambling and digital shift, Matousek 1998). Each
+ * randomization is an unbiased estimate, and the error is the standard error of their
+ * mean. The number of points per randomization starts at 1024 and is doubled until
+ * the error of every component is below max(epsabs, epsrel |integral|), or until the
+ * next round would exceed maxeval evaluations (fail = 1).
+ *
+ * The randomizations are seeded identically at every call, so that the integrals are
+ * smooth functions of the fit parameters. The points are evaluated in parallel with
+ * OpenMP in fixed blocks, whose sums are added in order, so that the result does not
+ * depend on the number of threads. The integrand must therefore be thread safe.
+ */
+
+// Integrand evaluating *nvec points per call, x[i*ndim+k] and f[i*ncomp+j], cf. batch_integrand_t
+typedef int (*qmc_integrand_t)(const int *ndim, const double x[], const int *ncomp,
+    double f[], void *userdata, const int *nvec, const int *core);
+
+// ndim <= QMC_MAXDIM
+const int QMC_MAXDIM = 12;
+
+void QMCIntegrate(int ndim, int ncomp, qmc_integrand_t integrand, void *userdata, int nvec,
+    double epsrel, double epsabs, int maxeval, int *neval, int *fail,
+    double integral[], double error[], double prob[]);
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Fixed quadrature rules shared by the BK solver and the DIS integrators
+ */
+
+#include "quadrature.hpp"
+#include <cmath>
+#include <iostream>
+#include <cstdlib>
+
+#include "nlobk_config.hpp"
+
+using namespace std;
+
+void GaussLegendreNodes(int n, double a, double b, std::vector<double>& nodes,
+                        std::vector<double>& weights, int panels)
+{
+    if (n < 1 or panels < 1)
+    {
+        cerr << "Invalid Gauss-Legendre rule, n=" << n << ", panels=" << panels << " " << LINEINFO << endl;
+        exit(1);
+    }
+
+    // Nodes on [-1,1] are the roots of the Legendre polynomial P_n, found
+    // with Newton's method starting from the Chebyshev estimate
+    std::vector<double> x(n), w(n);
+    for (int i=0; i<(n+1)/2; i++)
+    {
+        double root = std::cos(M_PI*(i+0.75)/(n+0.5));
+        double dp=0;
+        for (int iter=0; iter<100; iter++)
+        {
+            double p0=1.0, p1=0.0;
+            for (int j=1; j<=n; j++)
+            {
+                double p2=p1;
+                p1=p0;
+                p0=((2.0*j-1.0)*root*p1 - (j-1.0)*p2)/j;
+            }
+            dp = n*(root*p0-p1)/(root*root-1.0);
+            double prev = root;
+            root = prev - p0/dp;
+            if (std::abs(root-prev) < 1e-15)
+                break;
+        }
+        x[i] = -root; x[n-1-i] = root;
+        w[i] = 2.0/((1.0-root*root)*dp*dp); w[n-1-i] = w[i];
+    }
+
+    double width = (b-a)/panels;
+    for (int p=0; p<panels; p++)
+    {
+        double center = a + (p+0.5)*width;
+        for (int i=0; i<n; i++)
+        {
+            nodes.push_back(center + 0.5*width*x[i]);
+            weights.push_back(0.5*width*w[i]);
+        }
+    }
+}
@@ -0,0 +1,17 @@
+/*
+ * Fixed quadrature rules shared by the BK solver and the DIS integrators
+ */
+
+#ifndef _QUADRATURE_HPP
+#define _QUADRATURE_HPP
+
+#include <vector>
+
+// Composite Gauss-Legendre rule on [a,b]: the interval is split into
+// equally wide panels, each integrated with an n-point Gauss-Legendre rule.
+// Nodes and weights are appended to the given vectors, s.t. the
+// integral is sum_i weights[i] * f(nodes[i]).
+void GaussLegendreNodes(int n, double a, double b, std::vector<double>& nodes,
+                        std::vector<double>& weights, int panels=1);
+
+#endif
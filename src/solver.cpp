@@ -7,8 +7,13 @@
 #include "dipole.hpp"
 
 #include "nlobk_config.hpp"
+#include "quadrature.hpp"
 
 #include <cmath>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include <ctime>
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_spline.h>
@@ -36,6 +41,8 @@ BKSolver::BKSolver(Dipole* d)
     tmp_output = "";
     icx0_nlo_impfac=1;
     icTypicalPartonVirtualityQ0sqr=1;
+    solver_step=-1;
+    richardson_child=false;
 }
 
 struct DEHelper{
@@ -47,6 +54,8 @@ BKSolver::BKSolver()
     alphas_scaling=1.0;
     icx0_nlo_impfac=1;
     icTypicalPartonVirtualityQ0sqr=1;
+    solver_step=-1;
+    richardson_child=false;
 }
 
 
@@ -69,6 +78,11 @@ int BKSolver::Solve(double maxy)
         exit(1);
     }
     
+    if (config::RICHARDSON_LEVELS > 1 and !richardson_child)
+        return SolveRichardson(maxy, config::RICHARDSON_LEVELS);
+    
+    if (config::NLO_KERNEL_CACHE != config::KERNEL_CACHE_DISABLED and !config::NO_K2)
+        BuildNLOKernelCache();
     
     size_t vecsize = dipole->RPoints();
     double *ampvec = new double [vecsize];
@@ -79,6 +93,7 @@ int BKSolver::Solve(double maxy)
     }
     
     double y=0; double step = DE_SOLVER_STEP;  // We have always solved up to y
+    if (solver_step > 0) step = solver_step;
     int yind=0;
     
     // Intialize GSL
@@ -163,6 +178,139 @@ int BKSolver::Solve(double maxy)
     gsl_odeiv_control_free (c);
     gsl_odeiv_step_free (s);
     delete[] ampvec;
+    ClearNLOKernelCache();
+    return 0;
+}
+
+/*
+ * Richardson extrapolation
+ * The BK equation is solved concurrently with rapidity steps h, h/2 (and h/4),
+ * and the solutions at the common rapidities are combined s.t. the leading
+ * error terms cancel. The Euler method has an error O(h), so
+ * R_1 = 2 N(h/2) - N(h), and with three levels R_2 = (4 R_1(h/2) - R_1(h))/3.
+ * The difference between the extrapolated result and the best result of
+ * one order lower is used as an error estimate.
+ */
+int BKSolver::SolveRichardson(double maxy, int levels)
+{
+    if (!config::EULER_METHOD)
+    {
+        cerr << "Richardson extrapolation requires the Euler method, the error of the adaptive RK solver is not set by the step size " << LINEINFO << endl;
+        exit(1);
+    }
+    if (levels < 2 or levels > 3)
+    {
+        cerr << "Richardson extrapolation supports 2 or 3 levels, not " << levels << " " << LINEINFO << endl;
+        exit(1);
+    }
+    
+    double h = DE_SOLVER_STEP;
+    if (solver_step > 0) h = solver_step;
+    
+    cout << "#### Solving BK equation up to y=" << maxy << " with steps h=" << h << ", h/2"
+        << (levels > 2 ? ", h/4" : "") << " and Richardson extrapolating" << endl;
+    
+    std::vector<Dipole*> dipoles(levels);
+    std::vector<BKSolver*> solvers(levels);
+    for (int l=0; l<levels; l++)
+    {
+        dipoles[l] = new Dipole(dipole->GetInitialCondition());
+        dipoles[l]->SetX0(dipole->GetX0());
+        solvers[l] = new BKSolver(dipoles[l]);
+        solvers[l]->SetAlphasScaling(alphas_scaling);
+        solvers[l]->SetX0(x0);
+        solvers[l]->SetICX0_nlo_impfac(icx0_nlo_impfac);
+        solvers[l]->SetICTypicalPartonVirtualityQ0sqr(icTypicalPartonVirtualityQ0sqr);
+        solvers[l]->SetStep(h/std::pow(2.0, l));
+        solvers[l]->richardson_child=true;
+    }
+    
+    // Each solve parallelizes its own loop over r in Evolve(). The threads are split between
+    // the concurrent solves in proportion to their number of steps 2^l, so that together they
+    // use no more threads than the process. With fewer threads than levels the solves run
+    // one after another, each with all threads.
+#ifdef _OPENMP
+    std::vector<int> threads(levels, 1);
+    int maxthreads = omp_get_max_threads();
+    bool concurrent = maxthreads >= levels;
+    if (concurrent)
+    {
+        int assigned = 0;
+        for (int l=0; l<levels-1; l++)
+        {
+            threads[l] = std::max(1, maxthreads*(1<<l)/((1<<levels)-1));
+            assigned += threads[l];
+        }
+        threads[levels-1] = maxthreads - assigned;
+    }
+    int max_active_levels = omp_get_max_active_levels();
+    if (concurrent)
+        omp_set_max_active_levels(std::max(max_active_levels, 2));
+#endif
+#pragma omp parallel for num_threads(levels) schedule(static,1) if(concurrent)
+    for (int l=0; l<levels; l++)
+    {
+#ifdef _OPENMP
+        if (concurrent)
+            omp_set_num_threads(threads[l]);
+#endif
+        solvers[l]->Solve(maxy);
+    }
+#ifdef _OPENMP
+    omp_set_max_active_levels(max_active_levels);
+#endif
+    
+    // Rapidity index i of the coarsest solution corresponds to index i*2^l at level l
+    unsigned int ypoints = dipoles[0]->YPoints();
+    for (int l=1; l<levels; l++)
+        ypoints = std::min(ypoints, (dipoles[l]->YPoints()-1)/(1u<<l) + 1);
+    
+    richardson_errors.clear();
+    unsigned int rpoints = dipole->RPoints();
+    double *ampvec = new double[rpoints];
+    int yind=0;
+    for (unsigned int i=1; i<ypoints; i++)
+    {
+        double maxerr=0;
+        for (unsigned int rind=0; rind<rpoints; rind++)
+        {
+            double n_h = dipoles[0]->GetData()[i][rind];
+            double n_h2 = dipoles[1]->GetData()[2*i][rind];
+            double r1 = 2.0*n_h2 - n_h;
+            double extrapolated = r1;
+            // Two levels: error estimate |N(h/2) - N(h)| of the h/2 solution, the O(h^2) error of
+            // R_1 itself is not known. Three levels: error estimate |R_2 - R_1(h/2)| of R_1(h/2),
+            // which bounds the error of R_2 from above
+            double err = std::abs(r1 - n_h2);
+            if (levels > 2)
+            {
+                double n_h4 = dipoles[2]->GetData()[4*i][rind];
+                double r1_fine = 2.0*n_h4 - n_h2;
+                extrapolated = (4.0*r1_fine - r1)/3.0;
+                err = std::abs(extrapolated - r1_fine);
+            }
+            if (extrapolated > 1.0) extrapolated = 1.0;
+            if (extrapolated < 0 and config::FORCE_POSITIVE_N) extrapolated = 0;
+            ampvec[rind] = extrapolated;
+            maxerr = std::max(maxerr, err);
+        }
+        yind = dipole->AddRapidity(dipoles[0]->YVal(i), ampvec);
+        richardson_errors.push_back(maxerr);
+        if (VERBOSE)
+            cout << "# Richardson extrapolated y=" << dipoles[0]->YVal(i) << ", max error estimate of the "
+                << (levels > 2 ? "h/2 extrapolation R_1(h/2) " : "h/2 solution ") << maxerr << endl;
+        
+        if (tmp_output != "")
+            dipole->Save(tmp_output);
+    }
+    dipole->InitializeInterpolation(yind);
+    
+    delete[] ampvec;
+    for (int l=0; l<levels; l++)
+    {
+        delete solvers[l];
+        delete dipoles[l];
+    }
     return 0;
 }
 
@@ -225,7 +373,10 @@ int Evolve(double y, const double amplitude[], double dydt[], void *params)
             interp_s.SetUnderflow(1.0);
             interp_s.SetOverflow(0.0);
             //interp_s.SetMaxX(maxr_interp);
-            nlo = par->solver->RapidityDerivative_nlo(dipole->RVal(i), &interp, &interp_s);
+            if (config::NLO_KERNEL_CACHE != config::KERNEL_CACHE_DISABLED)
+                nlo = par->solver->RapidityDerivative_nlo_cached(i, &interp_s);
+            else
+                nlo = par->solver->RapidityDerivative_nlo(dipole->RVal(i), &interp, &interp_s);
         }
         
         if (config::DNDY)
@@ -792,6 +943,12 @@ double Inthelperf_nlo(double r, double z, double theta_z, double z2, double thet
 double Inthelperf_nlo_mc(double* vec, size_t dim, void* p);
 
 double BKSolver::RapidityDerivative_nlo(double r, Interpolator* dipole_interp, Interpolator* dipole_interp_s)
+{
+    return RapidityDerivative_nlo(r, dipole_interp, dipole_interp_s, INTMETHOD_NLO);
+}
+
+double BKSolver::RapidityDerivative_nlo(double r, Interpolator* dipole_interp, Interpolator* dipole_interp_s,
+                                        INTEGRATION_METHOD method)
 {
     
     Inthelper_nlobk helper;
@@ -806,7 +963,7 @@ double BKSolver::RapidityDerivative_nlo(double r, Interpolator* dipole_interp, I
     
     int status; double  result, abserr;
     
-    if (INTMETHOD_NLO == MULTIPLE)
+    if (method == MULTIPLE)
     {
         gsl_function fun;
         fun.params = &helper;
@@ -855,7 +1012,7 @@ double BKSolver::RapidityDerivative_nlo(double r, Interpolator* dipole_interp, I
         
         const int maxiter_vegas=3;
         
-        if (INTMETHOD_NLO == VEGAS)
+        if (method == VEGAS)
         {
             gsl_monte_vegas_state *s = gsl_monte_vegas_alloc (dim);
             gsl_monte_vegas_integrate (&fun, min, max, dim, calls/5, rnd, s,
@@ -885,7 +1042,7 @@ double BKSolver::RapidityDerivative_nlo(double r, Interpolator* dipole_interp, I
             gsl_monte_vegas_free(s);
             
         }
-        else if (INTMETHOD_NLO == MISER)
+        else if (method == MISER)
         {
             
             // plain or miser
@@ -1155,6 +1312,280 @@ double Inthelperf_nlo_mc(double* vec, size_t dim, void* p)
     
 }
 
+/*
+ * Precomputed NLO kernels
+ * The kernels K2 and Kf depend only on the geometry, so with a fixed
+ * integration mesh they can be evaluated once per solve. Each step then only
+ * needs the dipole products and the coupling at the mesh nodes.
+ *
+ * The mesh is Gauss-Legendre in ln z and ln z' (panels of 8 points), midpoint
+ * rule in theta_z in [0,pi] (the integrand is symmetric under theta -> -theta
+ * for both daughter dipoles) and trapezoid rule in theta_z' in [0,2pi]. The
+ * angular nodes never coincide, so that |z-z'| > 0 at all nodes.
+ *
+ * The node counts follow from NLO_KERNEL_CACHE_ACCURACY: starting from
+ * NLO_KERNEL_CACHE_LNRPOINTS and NLO_KERNEL_CACHE_THETAPOINTS, the tabulated
+ * NLO term is compared with RapidityDerivative_nlo (nested quadratures, relative
+ * accuracy INTACCURACY) at the initial condition for NLO_KERNEL_CACHE_CHECKPOINTS
+ * parent dipoles, and the mesh is refined by one ln z panel and 4 theta_z nodes
+ * until max |cached - direct| / max |direct| is below the target. The direct
+ * integral includes the swapped terms which the table integral leaves out.
+ */
+void BKSolver::BuildNLOKernelCache()
+{
+    if (NLO_KERNEL_CACHE == KERNEL_CACHE_FLOAT)
+        BuildNLOKernelTables(kernel_cache_float);
+    else
+        BuildNLOKernelTables(kernel_cache);
+}
+
+void BKSolver::SetNLOKernelMesh(int lnrpoints, int thetapoints)
+{
+    ClearNLOKernelCache();
+    
+    double minlnr = std::log( 0.5*dipole->MinR() );
+    double maxlnr = std::log( 2.0*dipole->MaxR() );
+    int panels = std::max(1, lnrpoints/8);
+    GaussLegendreNodes(8, minlnr, maxlnr, cache_lnz, cache_lnz_weights, panels);
+    
+    for (int i=0; i<thetapoints; i++)
+        cache_theta_z.push_back( M_PI*(i+0.5)/thetapoints );
+    for (int i=0; i<2*thetapoints; i++)
+        cache_theta_z2.push_back( M_PI*i/thetapoints );
+}
+
+template<typename T>
+void BKSolver::BuildNLOKernelTables(std::vector< NLOKernelTable<T> >& cache)
+{
+    // Initial condition, clipped as in Evolve()
+    unsigned int rpoints = dipole->RPoints();
+    const std::vector<double>& ic = dipole->GetData()[0];
+    std::vector<double> rvals, nvals, svals;
+    unsigned int frozen = rpoints;  // First dipole where the evolution is frozen
+    for (unsigned int i=0; i<rpoints; i++)
+    {
+        rvals.push_back(dipole->RVal(i));
+        double n = std::min(ic[i], 1.0);
+        if (n<0 and FORCE_POSITIVE_N) n=0;
+        nvals.push_back(n);
+        double s = std::max(1.0-ic[i], 0.0);
+        if (s>1 and FORCE_POSITIVE_N) s=1.0;
+        svals.push_back(s);
+        if (ic[i] > 0.99999 and frozen == rpoints)
+            frozen = i;
+    }
+    
+    // Parent dipoles of the check, evenly spaced in index below the frozen region
+    std::vector<unsigned int> checks;
+    int ncheck = std::max(1, NLO_KERNEL_CACHE_CHECKPOINTS);
+    for (int k=0; k<ncheck; k++)
+        checks.push_back( std::min( (k+1)*std::max(frozen,1u)/(ncheck+1), rpoints-1) );
+    checks.erase( std::unique(checks.begin(), checks.end()), checks.end() );
+    
+    std::vector<double> direct(checks.size()), cached(checks.size());
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned int k=0; k<checks.size(); k++)
+    {
+        Interpolator interp(rvals,nvals,LOG_INTERPOLATOR);
+        interp.Initialize();
+        interp.SetFreeze(true);
+        interp.SetUnderflow(0);
+        interp.SetOverflow(1.0);
+        Interpolator interp_s(rvals,svals,LOG_INTERPOLATOR);
+        interp_s.Initialize();
+        interp_s.SetFreeze(true);
+        interp_s.SetUnderflow(1.0);
+        interp_s.SetOverflow(0.0);
+        direct[k] = RapidityDerivative_nlo(rvals[checks[k]], &interp, &interp_s, MULTIPLE);
+    }
+    
+    int lnrpoints = NLO_KERNEL_CACHE_LNRPOINTS;
+    int thetapoints = NLO_KERNEL_CACHE_THETAPOINTS;
+    while (true)
+    {
+        SetNLOKernelMesh(lnrpoints, thetapoints);
+        size_t nodes = SQR(cache_lnz.size())*cache_theta_z.size()*cache_theta_z2.size();
+        double megabytes = 5.0*sizeof(T)*nodes*rpoints/1.0e6;   // 5 arrays in NLOKernelTable
+        if (megabytes > NLO_KERNEL_CACHE_MAXMEMORY)
+        {
+            cerr << "NLO kernel cache would need " << megabytes << " MB > NLO_KERNEL_CACHE_MAXMEMORY="
+                 << NLO_KERNEL_CACHE_MAXMEMORY << " MB to reach accuracy " << NLO_KERNEL_CACHE_ACCURACY
+                 << " (ln r points " << cache_lnz.size() << ", theta points " << thetapoints << ") " << LINEINFO << endl;
+            exit(1);
+        }
+        cache.resize(rpoints);
+        
+#pragma omp parallel for schedule(dynamic)
+        for (unsigned int k=0; k<checks.size(); k++)
+        {
+            Interpolator interp_s(rvals,svals,LOG_INTERPOLATOR);
+            interp_s.Initialize();
+            interp_s.SetFreeze(true);
+            interp_s.SetUnderflow(1.0);
+            interp_s.SetOverflow(0.0);
+            BuildNLOKernelTable(rvals[checks[k]], cache[checks[k]]);
+            cached[k] = NLOKernelTableIntegral(rvals[checks[k]], cache[checks[k]], &interp_s);
+        }
+        
+        double maxdiff=0, maxdirect=0;
+        for (unsigned int k=0; k<checks.size(); k++)
+        {
+            maxdiff = std::max(maxdiff, std::abs(cached[k]-direct[k]));
+            maxdirect = std::max(maxdirect, std::abs(direct[k]));
+        }
+        double deviation = maxdirect > 0 ? maxdiff/maxdirect : maxdiff;
+        if (VERBOSE)
+        {
+            cout << "# NLO kernel mesh: ln r points " << cache_lnz.size() << ", theta points " << thetapoints
+                 << ", " << megabytes << " MB, deviation from direct integration " << deviation << endl;
+        }
+        if (deviation <= NLO_KERNEL_CACHE_ACCURACY)
+            break;
+        lnrpoints = cache_lnz.size() + 8;
+        thetapoints += 4;
+    }
+    
+#pragma omp parallel for schedule(dynamic)
+    for (unsigned int rind=0; rind<rpoints; rind++)
+    {
+        if (cache[rind].kernel.empty())
+            BuildNLOKernelTable(dipole->RVal(rind), cache[rind]);
+    }
+    
+    if (VERBOSE)
+    {
+        size_t nodes = SQR(cache_lnz.size())*cache_theta_z.size()*cache_theta_z2.size();
+        cout << "# Tabulated NLO kernels at " << nodes << " nodes for each of " << rpoints << " parent dipoles" << endl;
+    }
+}
+
+void BKSolver::ClearNLOKernelCache()
+{
+    cache_lnz.clear(); cache_lnz_weights.clear();
+    cache_theta_z.clear(); cache_theta_z2.clear();
+    kernel_cache.clear();
+    kernel_cache_float.clear();
+}
+
+template<typename T>
+void BKSolver::BuildNLOKernelTable(double r, NLOKernelTable<T>& table)
+{
+    size_t nodes = SQR(cache_lnz.size())*cache_theta_z.size()*cache_theta_z2.size();
+    table.kernel.reserve(nodes); table.kernel_f.reserve(nodes);
+    table.X.reserve(nodes); table.X2.reserve(nodes); table.z_m_z2.reserve(nodes);
+    
+    // Angular weights, factor 2 from the theta_z -> -theta_z symmetry
+    double theta_weight = 2.0 * M_PI/cache_theta_z.size() * 2.0*M_PI/cache_theta_z2.size();
+    
+    for (unsigned int iz=0; iz<cache_lnz.size(); iz++)
+    {
+        double z = std::exp(cache_lnz[iz]);
+        for (unsigned int it=0; it<cache_theta_z.size(); it++)
+        {
+            double theta_z = cache_theta_z[it];
+            double X = std::sqrt(r*r + z*z - 2.0*r*z*std::cos(theta_z));
+            for (unsigned int iz2=0; iz2<cache_lnz.size(); iz2++)
+            {
+                double z2 = std::exp(cache_lnz[iz2]);
+                // Jacobian z^2 z'^2 from d^2z d^2z' = z^2 z'^2 dln z dln z' dtheta_z dtheta_z'
+                double weight = theta_weight * cache_lnz_weights[iz]*cache_lnz_weights[iz2] * SQR(z*z2);
+                for (unsigned int it2=0; it2<cache_theta_z2.size(); it2++)
+                {
+                    double theta_z2 = cache_theta_z2[it2];
+                    double X2 = std::sqrt(r*r + z2*z2 - 2.0*r*z2*std::cos(theta_z2) );
+                    double z_m_z2 = std::sqrt( z*z + z2*z2 - 2.0*z*z2*std::cos(theta_z - theta_z2) );
+                    
+                    table.kernel.push_back( weight*Kernel_nlo(r, X, z, X2, z2, z_m_z2) );
+                    if (NF>0)
+                        table.kernel_f.push_back( weight*Kernel_nlo_fermion(r, X, z, X2, z2, z_m_z2) );
+                    else
+                        table.kernel_f.push_back(0);
+                    table.X.push_back(X);
+                    table.X2.push_back(X2);
+                    table.z_m_z2.push_back(z_m_z2);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Same integrand as in Inthelperf_nlo, but the swapped terms (z,theta_z) <-> (z',theta_z')
+ * are not evaluated: on the full mesh they integrate to the same value as the unswapped ones.
+ * The comparison with the direct integration in BuildNLOKernelTables() includes them
+ */
+template<typename T>
+double BKSolver::NLOKernelTableIntegral(double r, const NLOKernelTable<T>& table, Interpolator* dipole_interp_s)
+{
+    std::vector<double> s_z(cache_lnz.size());
+    std::vector<double> z(cache_lnz.size());
+    for (unsigned int i=0; i<cache_lnz.size(); i++)
+    {
+        z[i] = std::exp(cache_lnz[i]);
+        s_z[i] = dipole_interp_s->Evaluate(z[i]);
+    }
+    
+    double result=0;
+    size_t node=0;
+    for (unsigned int iz=0; iz<cache_lnz.size(); iz++)
+    {
+        double sY = s_z[iz];
+        for (unsigned int it=0; it<cache_theta_z.size(); it++)
+        {
+            for (unsigned int iz2=0; iz2<cache_lnz.size(); iz2++)
+            {
+                double sY2 = s_z[iz2];
+                for (unsigned int it2=0; it2<cache_theta_z2.size(); it2++, node++)
+                {
+                    double sX = dipole_interp_s->Evaluate(table.X[node]);
+                    
+                    // Dipole part using S, minus sign as the evolution is written for n, not s
+                    double term = -table.kernel[node] * ( sX*dipole_interp_s->Evaluate(table.z_m_z2[node])*sY2 - sX*sY );
+                    if (NF>0)
+                        term += -table.kernel_f[node] * sY * ( dipole_interp_s->Evaluate(table.X2[node]) - sX );
+                    
+                    if (RC_NLO == SMALLEST_NLO)
+                    {
+                        double min_size = std::min( std::min(r, z[iz]), z[iz2] );
+                        min_size = std::min( min_size, std::min<double>(table.X[node], table.X2[node]) );
+                        min_size = std::min<double>( min_size, table.z_m_z2[node] );
+                        term *= SQR( Alphas(min_size) * NC) / (8.0 * std::pow(M_PI, 4) );
+                    }
+                    
+                    if (std::isnan(term) or std::isinf(term))
+                        continue;
+                    result += term;
+                }
+            }
+        }
+    }
+    
+    if (RC_NLO == FIXED_NLO)
+        result *= SQR(FIXED_AS*NC) / (8.0*std::pow(M_PI,4) );
+    else if (RC_NLO == PARENT_NLO)
+        result *= SQR( Alphas(r) * NC) / (8.0 * std::pow(M_PI, 4) );
+    else if (RC_NLO != SMALLEST_NLO)
+    {
+        cerr << "Unknown NLO kernel alphas! " << LINEINFO << endl;
+        return -1;
+    }
+    
+    return result;
+}
+
+double BKSolver::RapidityDerivative_nlo_cached(unsigned int rind, Interpolator* dipole_interp_s)
+{
+    if (rind >= kernel_cache.size() and rind >= kernel_cache_float.size())
+    {
+        cerr << "NLO kernel cache is not initialized for rind=" << rind << " " << LINEINFO << endl;
+        exit(1);
+    }
+    
+    if (NLO_KERNEL_CACHE == KERNEL_CACHE_FLOAT)
+        return NLOKernelTableIntegral(dipole->RVal(rind), kernel_cache_float[rind], dipole_interp_s);
+    return NLOKernelTableIntegral(dipole->RVal(rind), kernel_cache[rind], dipole_interp_s);
+}
+
 /***************************************************
  * Non-conformal kernels
  * Note that as^2 nc^2 / (8pi^4) is taken out from the kernels
@@ -9,6 +9,22 @@
 #include "dipole.hpp"
 #include <tools/interpolation.hpp>
 #include <string>
+#include <vector>
+
+/* NLO kernels K2 and Kf tabulated for one parent dipole on the fixed mesh
+ * of BKSolver::BuildNLOKernelCache(). Node order is
+ * (ln z, theta_z, ln z', theta_z'), the last index running fastest.
+ * Kernels are multiplied by the quadrature weights and the Jacobian.
+ */
+template<typename T>
+struct NLOKernelTable
+{
+    std::vector<T> kernel;
+    std::vector<T> kernel_f;
+    std::vector<T> X;
+    std::vector<T> X2;
+    std::vector<T> z_m_z2;
+};
 
 /* General solver class for the BK equation
  */
@@ -19,6 +35,13 @@ class BKSolver
         BKSolver(Dipole* d);    // Constructor takes the dipole amplitude class
         BKSolver();             // Empty constructor, s.t. one can e.g. evaluate alphas
         int Solve(double maxy);	// Solve up to maxy
+        // Solve with rapidity steps h, h/2 (, h/4) concurrently and Richardson extrapolate
+        // the results, levels=2 or 3. Called by Solve() if config::RICHARDSON_LEVELS > 1
+        int SolveRichardson(double maxy, int levels);
+        // Error estimate, max over r at each rapidity yvals[i], i>0: levels=2 |N(h/2)-N(h)| of the h/2
+        // solution, levels=3 |R_2-R_1(h/2)| of the h/2 extrapolation. Both bound the error of the
+        // extrapolated solution from above, to the extent that the step is in the asymptotic regime
+        std::vector<double> GetRichardsonErrors() { return richardson_errors; }
 
         double Kernel_lo(double r, double v, double theta);
 
@@ -28,6 +51,13 @@ class BKSolver
 
         double RapidityDerivative_lo(double r, Interpolator* dipole_interp, double rapidity=-1);
         double RapidityDerivative_nlo(double r, Interpolator* dipole_interp, Interpolator* dipole_interp_s);
+        double RapidityDerivative_nlo(double r, Interpolator* dipole_interp, Interpolator* dipole_interp_s,
+                                      config::INTEGRATION_METHOD method);
+        // Same as above, but uses the tabulated kernels, rind is the index of the parent dipole
+        double RapidityDerivative_nlo_cached(unsigned int rind, Interpolator* dipole_interp_s);
+
+        void BuildNLOKernelCache();     // Tabulate K2 and Kf, called by Solve() if config::NLO_KERNEL_CACHE is set
+        void ClearNLOKernelCache();
 
         Dipole* GetDipole();
         
@@ -37,6 +67,8 @@ class BKSolver
 
         void SetTmpOutput(std::string fname);
     
+        void SetStep(double h) { solver_step = h; }    // Override config::DE_SOLVER_STEP for this solver
+    
         double GetX0() { return x0; }
         void SetX0(double x_) { x0 = x_; }
     
@@ -53,6 +85,20 @@ class BKSolver
     double x0;  // Initial condition refers to xbj, usually=0.01
     double icx0_nlo_impfac; // x0 in the energy conservation requirement, usually =1
     double icTypicalPartonVirtualityQ0sqr;
+    double solver_step;     // Rapidity step, <0: use config::DE_SOLVER_STEP
+    bool richardson_child;  // Solver is one of the coarse solves of SolveRichardson()
+    std::vector<double> richardson_errors;
+
+    void SetNLOKernelMesh(int lnrpoints, int thetapoints);
+    template<typename T> void BuildNLOKernelTables(std::vector< NLOKernelTable<T> >& cache);
+    template<typename T> void BuildNLOKernelTable(double r, NLOKernelTable<T>& table);
+    template<typename T> double NLOKernelTableIntegral(double r, const NLOKernelTable<T>& table, Interpolator* dipole_interp_s);
+
+    // Mesh of the kernel cache, shared by all parent dipoles
+    std::vector<double> cache_lnz, cache_lnz_weights;
+    std::vector<double> cache_theta_z, cache_theta_z2;
+    std::vector< NLOKernelTable<double> > kernel_cache;
+    std::vector< NLOKernelTable<float> > kernel_cache_float;
 };
 
 
@@ -98,7 +98,7 @@ int main( int argc, char* argv[] )
 
     bool useSUB, useResumBK, useKCBK, useImprovedZ2Bound, useBoundLoop;
     bool useSigma3 = false;
-    string helpstring = "Argument order: BK RC useImprovedZ2Bound useBoundLoop Q C^2 X0 gamma Q0sq Y0 eta0\nresumbk/trbk/lobk parentrc/guillaumerc/fixedrc z2improved/z2simple z2boundloop/unboundloop";
+    string helpstring = "Argument order: BK RC useImprovedZ2Bound useBoundLoop [correlated] Q C^2 X0 gamma Q0sq Y0 eta0\nresumbk/trbk/lobk parentrc/guillaumerc/fixedrc z2improved/z2simple z2boundloop/unboundloop [correlated]";
     string string_sub, string_bk, string_rc;
     if (argc<2){ cout << helpstring << endl; return 0;}
     // Argv[0] is the name of the program
@@ -173,6 +173,9 @@ int main( int argc, char* argv[] )
         useBoundLoop = false;
     } else {cout << helpstring << endl; return -1;}
 
+    // qg_unsub and qg_sub on the same samples, so that their difference has a correlated error
+    bool correlated = (argc > 5 and string(argv [5]) == "correlated");
+
 
     cout << std::boolalpha;
     cout    << "# === Perturbative settings ===" << endl
@@ -191,6 +194,7 @@ int main( int argc, char* argv[] )
             << "# Use Sigma3: " << useSigma3 << endl
             << "# Use improved Z2 bound: " << useImprovedZ2Bound << endl
             << "# Use Z2 loop term: " << useBoundLoop << endl
+            << "# Correlated sub and unsub qg terms: " << correlated << endl
             << "# Cuba MC: " << cubaMethod
                 << ", Cuba eps = " << nlodis_config::CUBA_EPSREL
                 << ", Cuba maxeval = " << (float)nlodis_config::CUBA_MAXEVAL
@@ -256,17 +260,14 @@ int main( int argc, char* argv[] )
     // exit(0);
     // */
 
-    // Give solution to the AmplitudeLib object
-    AmplitudeLib DipoleAmplitude(solver.GetDipole()->GetData(), solver.GetDipole()->GetYvals(), solver.GetDipole()->GetRvals());
+    // Evaluate the solution directly from the solver's Dipole
+    DipoleAmplitudeView DipoleAmplitude(*solver.GetDipole());
     // AmplitudeLib DipoleAmplitude("./data/paper1dipole/pap1_fcBK_MV.dat"); // pap1_fcBK_MV.dat, pap1_rcBK_MV_parent.dat
     // AmplitudeLib DipoleAmplitude("./out/dipoles/dipole_lobk_fc_step0.2_rpoints400-2.dat"); // pap1_fcBK_MV.dat, pap1_rcBK_MV_parent.dat
     // AmplitudeLib DipoleAmplitude("./out/dipoles/dipole_lobk_fc_step0.2_rpoints400_rmin1e-6rmax50_INTACC2e-3.dat"); // pap1_fcBK_MV.dat, pap1_rcBK_MV_parent.dat
-    DipoleAmplitude.SetInterpolationMethod(LINEAR_LINEAR);
     DipoleAmplitude.SetX0(icx0_bk);
-    DipoleAmplitude.SetOutOfRangeErrors(false);
-    AmplitudeLib *DipolePointer = &DipoleAmplitude;
 
-    ComputeSigmaR SigmaComputer(DipolePointer);
+    ComputeSigmaR SigmaComputer(&DipoleAmplitude);
     SigmaComputer.SetX0(icx0_nlo_impfac);
     SigmaComputer.SetX0_BK(icx0_bk);
     SigmaComputer.SetY0(initialconditionY0);
@@ -301,6 +302,8 @@ int main( int argc, char* argv[] )
                     << setw(15) << "error_unsub_T"     << " "
                     << setw(15) << "squared diff L"     << " "
                     << setw(15) << "squared diff T"     << " "
+                    << setw(15) << "error_diff_L"      << " "
+                    << setw(15) << "error_diff_T"      << " "
                     << endl;
                     }
 
@@ -357,7 +360,44 @@ int main( int argc, char* argv[] )
 
         double error_sub_L=0, error_unsub_L=0;
         double error_sub_T=0, error_unsub_T=0;
+        double error_diff_L=0, error_diff_T=0;
 
+        if (correlated)
+        {
+        // Both schemes in one integration per polarization, the errors of the LO and IC terms are negligible.
+        // The sub and unsub errors are those of qg_unsub, the error of the difference is error_diff.
+        std::vector<QGSchemeVariant> variants(2);
+        variants[0].sub = false;
+        variants[0].rc = nlodis_config::RC_DIS;
+        variants[1].sub = true;
+        variants[1].rc = nlodis_config::RC_DIS;
+        std::vector<double> F, Ferr;
+
+        auto start_l = std::chrono::high_resolution_clock::now();
+        FL_IC_unsub = SigmaComputer.Structf_LLO(Q,icx0_bk);
+        FL_LO_sub = SigmaComputer.Structf_LLO(Q,xbj);
+        SigmaComputer.Structf_qg_variants(Q, xbj, 0, variants, F, Ferr);
+        FL_qg_unsub = F[0];
+        FL_qg_sub = F[0] + F[1];
+        error_sub_L = error_unsub_L = Ferr[0];
+        error_diff_L = Ferr[1];
+        auto stop_l = std::chrono::high_resolution_clock::now();
+
+        auto start_t = std::chrono::high_resolution_clock::now();
+        FT_IC_unsub = SigmaComputer.Structf_TLO(Q,icx0_bk);
+        FT_LO_sub = SigmaComputer.Structf_TLO(Q,xbj);
+        SigmaComputer.Structf_qg_variants(Q, xbj, 1, variants, F, Ferr);
+        FT_qg_unsub = F[0];
+        FT_qg_sub = F[0] + F[1];
+        error_sub_T = error_unsub_T = Ferr[0];
+        error_diff_T = Ferr[1];
+        auto stop_t = std::chrono::high_resolution_clock::now();
+
+        duration_L_unsub += std::chrono::duration_cast<std::chrono::milliseconds>(stop_l - start_l).count();
+        duration_T_unsub += std::chrono::duration_cast<std::chrono::milliseconds>(stop_t - start_t).count();
+        }
+        else
+        {
         // UNSUB SCHEME Full NLO impact factors for reduced cross section
         {
         auto start_l_unsub = std::chrono::high_resolution_clock::now();
@@ -400,9 +440,13 @@ int main( int argc, char* argv[] )
         error_sub_T = nlodis_config::CUBA_EPSREL*sqrt( Sq(FT_LO_sub)+Sq(FT_qg_sub) );
         }
 
+        error_diff_L = sqrt( Sq(error_sub_L) + Sq(error_unsub_L) );
+        error_diff_T = sqrt( Sq(error_sub_T) + Sq(error_unsub_T) );
+        }
+
         // chisq = sum (theory - data)^2 / error^2
-        chisqr_L += ( Sq(FL_LO_sub + FL_qg_sub - (FL_IC_unsub + FL_qg_unsub)) ) / ( Sq(error_sub_L) + Sq(error_unsub_L) );
-        chisqr_T += ( Sq(FT_LO_sub + FT_qg_sub - (FT_IC_unsub + FT_qg_unsub)) ) / ( Sq(error_sub_T) + Sq(error_unsub_T) );
+        chisqr_L += ( Sq(FL_LO_sub + FL_qg_sub - (FL_IC_unsub + FL_qg_unsub)) ) / Sq(error_diff_L);
+        chisqr_T += ( Sq(FT_LO_sub + FT_qg_sub - (FT_IC_unsub + FT_qg_unsub)) ) / Sq(error_diff_T);
 
 
         //prints
@@ -424,6 +468,8 @@ int main( int argc, char* argv[] )
                     << setw(15) << error_unsub_T     << " "
                     << setw(15) << Sq(FL_LO_sub + FL_qg_sub - (FL_IC_unsub + FL_qg_unsub))     << " "
                     << setw(15) << Sq(FT_LO_sub + FT_qg_sub - (FT_IC_unsub + FT_qg_unsub))     << " "
+                    << setw(15) << error_diff_L      << " "
+                    << setw(15) << error_diff_T      << " "
                     << endl;
         }
     }
@@ -0,0 +1,110 @@
+/*
+ * Accuracy and speed of the in-tree Bessel functions (bessel.hpp)
+ * compared with GSL over the argument ranges of the photon wavefunctions
+ *
+ * Usage: tool_bessel_bench [points per range]
+ *
+ * The reference is K_nu(x) = \int_0^\infty dt exp(-x cosh t) cosh(nu t),
+ * computed with the trapezoidal rule in long double
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <gsl/gsl_errno.h>
+#include <gsl/gsl_sf_bessel.h>
+
+#include "bessel.hpp"
+
+using namespace std;
+
+long double ReferenceK(int nu, long double x)
+{
+    // e^x K_nu(x), the integrand is peaked at t=0 with width ~ 1/sqrt(x)
+    long double h = std::min(1.0L/64.0L, 0.25L/std::sqrt(x));
+    long double sum = 0.5L;
+    for (int i=1; ; i++)
+    {
+        long double t = i*h;
+        long double a = 2.0L*x*std::sinh(0.5L*t)*std::sinh(0.5L*t);
+        if (a > 60) break;
+        sum += std::exp(-a)*std::cosh(nu*t);
+    }
+    return sum*h*std::exp(-x);
+}
+
+struct Range
+{
+    double min, max;
+    string desc;
+};
+
+int main( int argc, char* argv[] )
+{
+    gsl_set_error_handler_off();
+    int points = 2000;
+    if (argc > 1)
+        points = std::stoi(argv[1]);
+
+    // K arguments in the integrands are Q r sqrt(z(1-z)) and sqrt(Q^2 z(1-z) + m^2) r,
+    // with r between nlodis_config::MINR and MAXR
+    std::vector<Range> ranges = {
+        {1e-8, 1e-2, "small x"},
+        {1e-2, 2, "series region"},
+        {2, 20, "moderate x"},
+        {20, 700, "large x"}
+    };
+
+    cout << "# nu  range  max rel.err. fast  max rel.err. GSL  ns/call fast  ns/call GSL" << endl;
+    for (int nu=0; nu<=2; nu++)
+    {
+        for (unsigned int ri=0; ri<ranges.size(); ri++)
+        {
+            std::vector<double> x(points);
+            for (int i=0; i<points; i++)
+                x[i] = ranges[ri].min*std::pow(ranges[ri].max/ranges[ri].min, (i+0.5)/points);
+
+            double maxerr_fast=0, maxerr_gsl=0;
+            for (int i=0; i<points; i++)
+            {
+                long double ref = ReferenceK(nu, x[i]);
+                double fast = FastBesselKn(nu, x[i]);
+                double gsl = gsl_sf_bessel_Kn(nu, x[i]);
+                maxerr_fast = std::max(maxerr_fast, (double)std::abs((fast-ref)/ref));
+                maxerr_gsl = std::max(maxerr_gsl, (double)std::abs((gsl-ref)/ref));
+            }
+
+            const int repeat = 200;
+            std::vector<double> out(points);
+            double sum=0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int rep=0; rep<repeat; rep++)
+            {
+                if (nu == 0) FastBesselK0(x.data(), out.data(), points);
+                else if (nu == 1) FastBesselK1(x.data(), out.data(), points);
+                else FastBesselKn(nu, x.data(), out.data(), points);
+                sum += out[rep % points];
+            }
+            auto mid = std::chrono::high_resolution_clock::now();
+            for (int rep=0; rep<repeat; rep++)
+            {
+                for (int i=0; i<points; i++)
+                    out[i] = gsl_sf_bessel_Kn(nu, x[i]);
+                sum += out[rep % points];
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double calls = (double)repeat*points;
+            double t_fast = std::chrono::duration<double, std::nano>(mid-start).count()/calls;
+            double t_gsl = std::chrono::duration<double, std::nano>(end-mid).count()/calls;
+
+            cout << nu << " " << ranges[ri].min << "-" << ranges[ri].max << " (" << ranges[ri].desc << ") "
+                << maxerr_fast << " " << maxerr_gsl << " " << t_fast << " " << t_gsl << endl;
+            if (!std::isfinite(sum))
+                cerr << "Non-finite Bessel function values for nu=" << nu << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*
+ * Build and use a reduced order emulator of BK solutions
+ *
+ * Usage:
+ *   tool_emulator train [parameterfile] [trainingset] [maxy] [x0]
+ *       Solve BK at each parameter point and save the solutions to trainingset
+ *   tool_emulator eval [trainingset] [parameterfile] [maxy] [x0] [tolerance]
+ *       Emulate (or solve, if the error indicator exceeds the tolerance) the dipole
+ *       at each parameter point and save it to emulated_dipole_[n].dat
+ *
+ * Each line of the parameter file is: qs0sqr gamma e_c C^2
+ */
+
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <gsl/gsl_errno.h>
+
+#include "nlobk_config.hpp"
+#include "mv.hpp"
+#include "dipole.hpp"
+#include "emulator.hpp"
+
+using namespace std;
+
+std::vector< std::vector<double> > ReadParameters(std::string filename)
+{
+    std::vector< std::vector<double> > pars;
+    std::ifstream in(filename.c_str());
+    if (!in.is_open())
+    {
+        cerr << "Could not open file " << filename << " " << LINEINFO << endl;
+        exit(1);
+    }
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() or line[0] == '#')
+            continue;
+        std::stringstream ss(line);
+        std::vector<double> par(4);
+        ss >> par[0] >> par[1] >> par[2] >> par[3];
+        pars.push_back(par);
+    }
+    return pars;
+}
+
+int main( int argc, char* argv[] )
+{
+    gsl_set_error_handler_off();
+
+    if (argc < 6)
+    {
+        cerr << "Usage: " << argv[0] << " train [parameterfile] [trainingset] [maxy] [x0]" << endl
+            << "       " << argv[0] << " eval [trainingset] [parameterfile] [maxy] [x0] [tolerance]" << endl;
+        return 1;
+    }
+
+    // BK configs, resummed BK as in massive_swarmscan
+    config::NO_K2 = true;
+    config::KINEMATICAL_CONSTRAINT = config::KC_NONE;
+    config::INTACCURACY = 5e-3;
+    config::MINR = 1e-6;
+    config::MAXR = 30;
+    config::RPOINTS = 100;
+    config::DE_SOLVER_STEP = 0.4; // Rungekutta step
+    config::NF=3;
+    config::LAMBDAQCD = 0.241;
+    config::EULER_METHOD = false;
+    config::RESUM_DLOG = true;
+    config::RESUM_SINGLE_LOG = true;
+    config::KSUB = 0.65;
+    config::RC_LO = config::BALITSKY_LO;
+    config::RESUM_RC = config::RESUM_RC_SMALLEST;
+
+    std::string mode = argv[1];
+    double maxy = std::stod(argv[4]);
+    double x0 = std::stod(argv[5]);
+    BKEmulator emulator(maxy, x0);
+
+    cout << NLOBK_CONFIG_STRING() << endl;
+
+    if (mode == "train")
+    {
+        std::vector< std::vector<double> > pars = ReadParameters(argv[2]);
+        for (unsigned int i=0; i<pars.size(); i++)
+        {
+            cout << "# Training point " << i+1 << "/" << pars.size() << endl;
+            emulator.AddTrainingPoint(pars[i]);
+        }
+        emulator.SaveTrainingSet(argv[3]);
+    }
+    else if (mode == "eval")
+    {
+        if (emulator.LoadTrainingSet(argv[2]) < 0)
+            return 1;
+        if (argc > 6)
+            emulator.SetTolerance(std::stod(argv[6]));
+        emulator.Build();
+
+        std::vector< std::vector<double> > pars = ReadParameters(argv[3]);
+        for (unsigned int i=0; i<pars.size(); i++)
+        {
+            MV ic;
+            ic.SetQsqr(pars[i][0]);
+            ic.SetAnomalousDimension(pars[i][1]);
+            ic.SetE(pars[i][2]);
+            Dipole dipole(&ic);
+            dipole.SetX0(x0);
+            bool emulated;
+            double error = emulator.FillDipole(pars[i], dipole, emulated);
+            cout << "# Point " << i << ": " << (emulated ? "emulated" : "solved") << ", error indicator " << error << endl;
+            dipole.Save("emulated_dipole_" + std::to_string(i) + ".dat");
+        }
+    }
+    else
+    {
+        cerr << "Unknown mode " << mode << endl;
+        return 1;
+    }
+
+    return 0;
+}
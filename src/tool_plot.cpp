@@ -444,7 +444,7 @@ int main( int argc, char* argv[] )
 
 
 
-    AmplitudeLib* DipoleAmplitude_ptr; // Forward declaration of the dipole object to be initialized from a file or solved data.
+    AmplitudeLib* DipoleAmplitude_ptr = NULL; // Dipole object initialized from a file, solved data is used directly from the solver.
     string dipole_basename = "./out/dipoles/dipole";
     string dipole_filename = dipole_basename
                              + "_" + string_bk
@@ -481,7 +481,6 @@ int main( int argc, char* argv[] )
         solver.Solve(maxy);     // Solve up to maxy since specified dipole datafile was not found.
         solver.GetDipole()->Save(dipole_filename);
         cout << "# Saved dipole to file: "<< dipole_filename << endl;
-        DipoleAmplitude_ptr = new AmplitudeLib(solver.GetDipole()->GetData(), solver.GetDipole()->GetYvals(), solver.GetDipole()->GetRvals());
     }   
     // solver.GetDipole()->Save("./out/dipoles/dipole_lobk_fc_RK_step0.2_rpoints100_rmin1e-6rmax50_INTACC10e-3.dat");
     // cout << "Saved dipole to file, exiting." << endl;
@@ -496,14 +495,16 @@ int main( int argc, char* argv[] )
     // Give solution to the AmplitudeLib object
     // AmplitudeLib DipoleAmplitude(solver.GetDipole()->GetData(), solver.GetDipole()->GetYvals(), solver.GetDipole()->GetRvals());
     // AmplitudeLib DipoleAmplitude("./data/paper1dipole/pap1_fcBK_MV.dat"); // pap1_fcBK_MV.dat, pap1_rcBK_MV_parent.dat
-    AmplitudeLib DipoleAmplitude(*DipoleAmplitude_ptr);
-    // delete DipoleAmplitude_ptr;
-    DipoleAmplitude.SetInterpolationMethod(LINEAR_LINEAR);
-    DipoleAmplitude.SetX0(icx0_bk);
-    DipoleAmplitude.SetOutOfRangeErrors(false);
-    AmplitudeLib *DipolePointer = &DipoleAmplitude;
-
-    ComputeSigmaR SigmaComputer(DipolePointer);
+    if (DipoleAmplitude_ptr != NULL)
+    {
+        DipoleAmplitude_ptr->SetInterpolationMethod(LINEAR_LINEAR);
+        DipoleAmplitude_ptr->SetX0(icx0_bk);
+        DipoleAmplitude_ptr->SetOutOfRangeErrors(false);
+    }
+    DipoleAmplitudeView DipoleView(*solver.GetDipole());
+    DipoleView.SetX0(icx0_bk);
+
+    ComputeSigmaR SigmaComputer = (DipoleAmplitude_ptr != NULL) ? ComputeSigmaR(DipoleAmplitude_ptr) : ComputeSigmaR(&DipoleView);
     SigmaComputer.SetX0(icx0_nlo_impfac);
     SigmaComputer.SetX0_BK(icx0_bk);
     SigmaComputer.SetY0(initialconditionY0);
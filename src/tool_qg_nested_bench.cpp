@@ -0,0 +1,164 @@
+/*
+ * Time to accuracy of the massless qg terms with the nested quadrature of
+ * nlodis_config::QG_NESTED_PHI_POINTS and QG_NESTED_Z1_POINTS, and with the
+ * control variate of QG_CONTROL_VARIATE, compared with the 5D Monte Carlo integration
+ *
+ * Usage: tool_qg_nested_bench [cuba method] [reference epsrel]
+ *
+ * FL and FT of the unsub qg term are computed at a few kinematic points for each
+ * nested rule and tolerance, and compared with a 5D reference computed with the
+ * reference tolerance. With the control variate, VERBOSE prints its pilot variance
+ * ratios at each point. The Vegas grids are not shared between the integrations,
+ * so that every integration starts from the same state. The dipole is LO BK with
+ * fixed coupling from the MV initial condition.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <gsl/gsl_errno.h>
+
+#include <amplitudelib/amplitudelib.hpp>
+#include "solver.hpp"
+#include "mv.hpp"
+#include "dipole.hpp"
+#include "nlodis_config.hpp"
+#include "nlodissigmar.hpp"
+
+using namespace std;
+
+struct NestedRule
+{
+    int phipoints, z1points;    // 0: sampled
+    bool controlvariate;
+};
+
+struct Kinematics
+{
+    double Qsq, xbj;
+};
+
+// FL and FT of the unsub qg term with their integration errors, returns the time in ms
+double Compute(ComputeSigmaR& sigma, const Kinematics& kin, double F[2], double Ferr[2])
+{
+    const double Q = std::sqrt(kin.Qsq);
+    ComputeSigmaR::ResetIntegrationErrors();
+    auto start = std::chrono::high_resolution_clock::now();
+    F[0] = sigma.Structf_LNLOqg_unsub(Q, kin.xbj);
+    F[1] = sigma.Structf_TNLOqg_unsub(Q, kin.xbj);
+    auto stop = std::chrono::high_resolution_clock::now();
+    ComputeSigmaR::IntegrationErrors(Ferr);
+    return std::chrono::duration_cast<std::chrono::microseconds>(stop - start).count()/1000.0;
+}
+
+int main( int argc, char* argv[] )
+{
+    gsl_set_error_handler_off();
+    string cubaMethod = "vegas";
+    double reference_epsrel = 5e-4;
+    if (argc > 1)
+        cubaMethod = string(argv[1]);
+    if (argc > 2)
+        reference_epsrel = std::stod(argv[2]);
+
+    nlodis_config::CUBA_MAXEVAL = 1e8;
+    nlodis_config::MINR = 1e-6;
+    nlodis_config::MAXR = 30;
+    nlodis_config::SUB_SCHEME = nlodis_config::UNSUBTRACTED;
+    nlodis_config::RC_DIS = nlodis_config::DIS_RC_FIXED;
+    nlodis_config::VEGAS_WARM_GRIDS = false;
+    nlodis_config::PERSISTENT_INTEGRATION_STATE = false;
+    nlodis_config::INTEGRATION_ERROR_FRACTION = 0;
+
+    config::NO_K2 = true;
+    config::KINEMATICAL_CONSTRAINT = config::KC_NONE;
+    config::EULER_METHOD = false;
+    config::RESUM_DLOG = false;
+    config::RESUM_SINGLE_LOG = false;
+    config::RC_LO = config::FIXED_LO;
+    config::RESUM_RC = config::RESUM_RC_FIXED;
+    config::MINR = 1e-6;
+    config::MAXR = 30;
+    config::RPOINTS = 100;
+    config::NF = 3;
+    config::LAMBDAQCD = 0.241;
+
+    const double icx0 = 0.01;
+    MV ic;
+    ic.SetQsqr(0.2);
+    ic.SetAnomalousDimension(1.0);
+    ic.SetE(1.0);
+    Dipole dipole(&ic);
+    BKSolver solver(&dipole);
+    solver.Solve(10);
+    DipoleAmplitudeView amplitude(*solver.GetDipole());
+    amplitude.SetX0(icx0);
+
+    ComputeSigmaR sigma(&amplitude);
+    sigma.SetX0(icx0);
+    sigma.SetX0_BK(icx0);
+    sigma.SetY0(0);
+    sigma.SetQ0Sqr(1.0);
+    sigma.SetAlphasScalingC2(1.0);
+    sigma.MetaPrescriptionSetter();
+    sigma.SetCubaMethod(cubaMethod);
+
+    std::vector<Kinematics> points = { {1, 1e-3}, {10, 1e-4}, {50, 1e-5} };
+    std::vector<NestedRule> rules = { {0, 0, false}, {4, 0, false}, {8, 0, false}, {16, 0, false}, {8, 4, false}, {8, 8, false},
+        {0, 0, true} };
+    std::vector<double> epsrels = { 2e-2, 1e-2, 5e-3, 2e-3 };
+
+    cout << "# Cuba method " << cubaMethod << ", reference: 5D with epsrel " << reference_epsrel << endl;
+    std::vector< std::vector<double> > reference(points.size(), std::vector<double>(2));
+    nlodis_config::CUBA_EPSREL = reference_epsrel;
+    for (unsigned int p=0; p<points.size(); p++)
+    {
+        double Ferr[2];
+        double ms = Compute(sigma, points[p], &reference[p][0], Ferr);
+        cout << "# Q^2=" << points[p].Qsq << " x=" << points[p].xbj
+             << ": FL " << reference[p][0] << " +- " << Ferr[0]
+             << ", FT " << reference[p][1] << " +- " << Ferr[1]
+             << " (" << ms << " ms)" << endl;
+    }
+
+    // Time to accuracy: the time of each rule and tolerance with the largest deviation from the
+    // reference and the largest reported error, relative to the structure functions
+    cout << "# phi points  z1 points  control variate  Cuba dim  epsrel  time (ms)  max |F/F_ref-1|  max err/F  max |F/F_ref-1|/(err/F)" << endl;
+    for (unsigned int r=0; r<rules.size(); r++)
+    {
+        nlodis_config::QG_NESTED_PHI_POINTS = rules[r].phipoints;
+        nlodis_config::QG_NESTED_Z1_POINTS = rules[r].z1points;
+        nlodis_config::QG_CONTROL_VARIATE = rules[r].controlvariate;
+        nlodis_config::VERBOSE = rules[r].controlvariate;
+        const int ndim = 5 - (rules[r].phipoints > 0) - (rules[r].z1points > 0);
+        for (unsigned int e=0; e<epsrels.size(); e++)
+        {
+            nlodis_config::CUBA_EPSREL = epsrels[e];
+            double time = 0, maxdev = 0, maxerr = 0, maxpull = 0;
+            for (unsigned int p=0; p<points.size(); p++)
+            {
+                double F[2], Ferr[2];
+                time += Compute(sigma, points[p], F, Ferr);
+                for (int pol=0; pol<2; pol++)
+                {
+                    double dev = std::abs(F[pol]/reference[p][pol] - 1.0);
+                    double err = std::abs(Ferr[pol]/F[pol]);
+                    maxdev = std::max(maxdev, dev);
+                    maxerr = std::max(maxerr, err);
+                    if (err > 0)
+                        maxpull = std::max(maxpull, dev/err);
+                }
+            }
+            cout << setw(12) << rules[r].phipoints << " " << setw(10) << rules[r].z1points << " "
+                 << setw(16) << rules[r].controlvariate << " "
+                 << setw(9) << ndim << " " << setw(7) << epsrels[e] << " "
+                 << setw(10) << time << " " << setw(16) << maxdev << " "
+                 << setw(10) << maxerr << " " << setw(10) << maxpull << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,272 @@
+/*
+ * LCPT NLO DIS fitter
+ * Separable importance grids shared between neighbouring kinematic points
+ */
+
+#include <cmath>
+#include <map>
+#include <list>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include "vegasgrid.hpp"
+#include "nlodis_config.hpp"
+
+namespace
+{
+    const int NBINS = 64;
+    // Damping of the refinement, cf. alpha in Vegas
+    const double ALPHA = 1.5;
+
+    struct StoredGrid
+    {
+        CubaGridKey key;    // Kinematics at which the grid was trained
+        VegasGrid grid;
+        int generation;     // Generation in which the grid was stored
+    };
+
+    // ((term, scheme), (mf, ndim), (ln Q^2 bin, ln x bin))
+    typedef std::pair< std::pair< std::pair<integrand_t, long>, std::pair<double, int> >, std::pair<int, int> > GridIndex;
+    // Grids of the earlier generations, which seed the integrations, and of the current one
+    std::map<GridIndex, StoredGrid> grids, pending;
+    int generation = 0;
+    // ((term, scheme), (Q^2, x, mf, z2min, ndim))
+    typedef std::pair< std::pair<integrand_t, long>, std::vector<double> > StateIndex;
+    // The persistent grids with their position in the use order, most recently used first
+    struct State
+    {
+        VegasGrid grid;
+        std::list<StateIndex>::iterator use;
+    };
+    std::map<StateIndex, State> states;
+    std::list<StateIndex> state_use;
+
+    int QsqBin(double Qsq)
+    {
+        return static_cast<int>(std::floor(std::log(Qsq)/nlodis_config::VEGAS_GRID_QSQ_BIN));
+    }
+
+    int XBin(double x)
+    {
+        return static_cast<int>(std::floor(std::log(x)/nlodis_config::VEGAS_GRID_X_BIN));
+    }
+
+    GridIndex Index(const CubaGridKey& key)
+    {
+        return GridIndex(std::make_pair(std::make_pair(key.term, key.scheme), std::make_pair(key.mf, key.ndim)),
+            std::make_pair(QsqBin(key.Qsq), XBin(key.xbj)));
+    }
+
+    // Fixed order of the kinematics of the grids stored in the same bin
+    bool Precedes(const CubaGridKey& a, const CubaGridKey& b)
+    {
+        if (a.Qsq != b.Qsq) return a.Qsq < b.Qsq;
+        if (a.xbj != b.xbj) return a.xbj < b.xbj;
+        return a.z2min < b.z2min;
+    }
+
+    StateIndex StateKey(const CubaGridKey& key)
+    {
+        std::vector<double> kinematics;
+        kinematics.push_back(key.Qsq);
+        kinematics.push_back(key.xbj);
+        kinematics.push_back(key.mf);
+        kinematics.push_back(key.z2min);
+        kinematics.push_back(key.ndim);
+        return StateIndex(std::make_pair(key.term, key.scheme), kinematics);
+    }
+}
+
+VegasGrid::VegasGrid(int ndim_)
+{
+    ndim = ndim_;
+    edges.resize(ndim*(NBINS+1));
+    weights.assign(ndim*NBINS, 0);
+    for (int d=0; d<ndim; d++)
+        for (int i=0; i<=NBINS; i++)
+            edges[d*(NBINS+1) + i] = static_cast<double>(i)/NBINS;
+}
+
+double VegasGrid::Map(const double u[], double x[], int bin[]) const
+{
+    double jac = 1;
+    for (int d=0; d<ndim; d++)
+    {
+        const double y = u[d]*NBINS;
+        const int i = std::min(static_cast<int>(y), NBINS-1);
+        const double* e = &edges[d*(NBINS+1)];
+        const double width = e[i+1] - e[i];
+        x[d] = e[i] + (y-i)*width;
+        jac *= NBINS*width;
+        bin[d] = i;
+    }
+    return jac;
+}
+
+void VegasGrid::Accumulate(const int bin[], double weight)
+{
+    for (int d=0; d<ndim; d++)
+        weights[d*NBINS + bin[d]] += weight;
+}
+
+void VegasGrid::Refine()
+{
+    for (int d=0; d<ndim; d++)
+    {
+        double* w = &weights[d*NBINS];
+        double* e = &edges[d*(NBINS+1)];
+        // Smoothed weights, compressed as in Vegas
+        double smooth[NBINS], sum = 0;
+        for (int i=0; i<NBINS; i++)
+        {
+            double s = w[i], n = 1;
+            if (i > 0) { s += w[i-1]; n++; }
+            if (i < NBINS-1) { s += w[i+1]; n++; }
+            smooth[i] = s/n;
+            sum += smooth[i];
+        }
+        if (!(sum > 0) || !std::isfinite(sum))
+            continue;
+        double total = 0;
+        for (int i=0; i<NBINS; i++)
+        {
+            const double r = smooth[i]/sum;
+            smooth[i] = (r > 0 && r < 1) ? std::pow((r-1.0)/std::log(r), ALPHA) : (r >= 1 ? 1 : 0);
+            total += smooth[i];
+        }
+        if (!(total > 0))
+            continue;
+
+        // New edges with an equal share of the compressed weights in every bin
+        std::vector<double> newedges(NBINS+1);
+        newedges[0] = 0;
+        newedges[NBINS] = 1;
+        const double share = total/NBINS;
+        double acc = 0;
+        int i = 0;
+        for (int k=1; k<NBINS; k++)
+        {
+            while (acc + smooth[i] < k*share && i < NBINS-1)
+                acc += smooth[i++];
+            const double frac = smooth[i] > 0 ? (k*share - acc)/smooth[i] : 0;
+            newedges[k] = e[i] + std::min(std::max(frac, 0.0), 1.0)*(e[i+1] - e[i]);
+        }
+        for (int k=0; k<=NBINS; k++)
+            e[k] = newedges[k];
+        for (int k=0; k<NBINS; k++)
+            w[k] = 0;
+    }
+}
+
+bool NearestVegasGrid(const CubaGridKey& key, int ndim, VegasGrid& grid, CubaGridKey& from)
+{
+    const GridIndex index = Index(key);
+    bool found = false;
+    #pragma omp critical(vegas_grids)
+    {
+        double best = 0;
+        for (std::map<GridIndex, StoredGrid>::const_iterator it = grids.begin(); it != grids.end(); ++it)
+        {
+            if (it->first.first != index.first || it->second.grid.Dim() != ndim)
+                continue;
+            const double dist = std::hypot(it->first.second.first - index.second.first,
+                it->first.second.second - index.second.second);
+            if (!found || dist < best)
+            {
+                found = true;
+                best = dist;
+                grid = it->second.grid;
+                from = it->second.key;
+            }
+        }
+    }
+    return found;
+}
+
+bool PersistentVegasGrid(const CubaGridKey& key, int ndim, VegasGrid& grid)
+{
+    const StateIndex index = StateKey(key);
+    bool found = false;
+    #pragma omp critical(vegas_grids)
+    {
+        std::map<StateIndex, State>::iterator it = states.find(index);
+        if (it != states.end() && it->second.grid.Dim() == ndim)
+        {
+            found = true;
+            grid = it->second.grid;
+            state_use.splice(state_use.begin(), state_use, it->second.use);
+        }
+    }
+    return found;
+}
+
+void StoreVegasGrid(const CubaGridKey& key, const VegasGrid& grid)
+{
+    StoredGrid stored;
+    stored.key = key;
+    stored.grid = grid;
+    stored.generation = generation;
+    const GridIndex index = Index(key);
+    const StateIndex state = StateKey(key);
+    #pragma omp critical(vegas_grids)
+    {
+        // Of the grids of a bin stored in parallel, keep the one first in the fixed order
+        std::map<GridIndex, StoredGrid>::iterator p = pending.find(index);
+        if (p == pending.end() || Precedes(key, p->second.key))
+            pending[index] = stored;
+        std::map<StateIndex, State>::iterator it = states.find(state);
+        if (it != states.end())
+        {
+            it->second.grid = grid;
+            state_use.splice(state_use.begin(), state_use, it->second.use);
+        }
+        else
+        {
+            state_use.push_front(state);
+            State s;
+            s.grid = grid;
+            s.use = state_use.begin();
+            states[state] = s;
+            while ((int)states.size() > std::max(nlodis_config::PERSISTENT_INTEGRATION_STATES, 1))
+            {
+                states.erase(state_use.back());
+                state_use.pop_back();
+            }
+        }
+    }
+}
+
+void NextVegasGridGeneration()
+{
+    #pragma omp critical(vegas_grids)
+    {
+        for (std::map<GridIndex, StoredGrid>::const_iterator it = pending.begin(); it != pending.end(); ++it)
+            grids[it->first] = it->second;
+        pending.clear();
+        generation++;
+        // Drop the oldest generations beyond the limit, in the fixed order of the bins
+        const size_t limit = std::max(nlodis_config::VEGAS_WARM_GRID_BINS, 1);
+        while (grids.size() > limit)
+        {
+            int oldest = generation;
+            for (std::map<GridIndex, StoredGrid>::const_iterator it = grids.begin(); it != grids.end(); ++it)
+                oldest = std::min(oldest, it->second.generation);
+            for (std::map<GridIndex, StoredGrid>::iterator it = grids.begin(); it != grids.end() && grids.size() > limit; )
+            {
+                if (it->second.generation == oldest)
+                    grids.erase(it++);
+                else
+                    ++it;
+            }
+        }
+    }
+}
+
+void ResetPersistentVegasGrids()
+{
+    #pragma omp critical(vegas_grids)
+    {
+        states.clear();
+        state_use.clear();
+    }
+}
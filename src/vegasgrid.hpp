@@ -0,0 +1,79 @@
+/*
+ * LCPT NLO DIS fitter
+ * Separable importance grids shared between neighbouring kinematic points
+ */
+
+#ifndef _VEGAS_GRID_HPP
+#define _VEGAS_GRID_HPP
+
+#include <vector>
+#include "cuba-4.2.h"
+
+/*
+ * A VegasGrid maps the unit hypercube to itself dimension by dimension, with
+ * piecewise linear maps whose bins are adapted as in Vegas (Lepage 1978): each bin
+ * gets an equal share of the accumulated (f jac)^2. Vegas and Suave integrations are done
+ * in the variables of such a grid (see Cuba()), so that Cuba's own grid
+ * starts from an almost flat integrand.
+ *
+ * The grids are trained in-process before the integration and kept per (term, scheme,
+ * quark mass, ln Q^2 bin, ln x bin). An integration starts from the grid of the nearest
+ * bin of the same term, so that the training needed at a new kinematic point is one
+ * refinement instead of training from a flat grid. Cuba's gridno slots are not used:
+ * there are only ten of them, and they are shared by all threads.
+ *
+ * So that the starting grid does not depend on the order in which the threads finish
+ * their points, the grids stored in a generation seed integrations only from the next
+ * generation on, and of the grids stored in the same bin the one first in (Q^2, x, z2min)
+ * is kept. The fit starts a generation at every chi^2 evaluation, so that an evaluation
+ * starts from the grids of the earlier ones. At most nlodis_config::VEGAS_WARM_GRID_BINS
+ * bins are kept, the oldest generations are dropped first.
+ *
+ * The grid of every (term, scheme, kinematics) is also kept as the persistent state of
+ * that integration. Later integrations with exactly the same key use it without training.
+ * A change of the scheme or of the kinematics (including z2min) changes the key. The fit
+ * resets the states at every chi^2 evaluation, so that a given parameter point and kinematic
+ * point always give the same result, whichever points were evaluated before. At most
+ * nlodis_config::PERSISTENT_INTEGRATION_STATES of them are kept, the least recently used
+ * are dropped, so that scans over many kinematics or masses do not grow without limit.
+ */
+
+class VegasGrid
+{
+    public:
+        VegasGrid(int ndim=0);
+        int Dim() const { return ndim; }
+
+        // x from u in [0,1]^ndim and the bins of x, returns the jacobian dx/du
+        double Map(const double u[], double x[], int bin[]) const;
+        // Adds (f jac)^2 of a point in the given bins
+        void Accumulate(const int bin[], double weight);
+        // New bins from the accumulated weights, which are cleared
+        void Refine();
+
+    private:
+        int ndim;
+        std::vector<double> edges;      // edges[d*(NBINS+1) + i]
+        std::vector<double> weights;    // weights[d*NBINS + i]
+};
+
+// Integration of a term at a kinematic point. term=NULL: no grid is used.
+struct CubaGridKey
+{
+    integrand_t term;
+    long scheme;            // Fingerprint of the scheme settings
+    double Qsq, xbj, mf, z2min;
+    int ndim;               // Set by Cuba()
+};
+
+// Grid of the same term, scheme and quark mass in the nearest (ln Q^2, ln x) bin, false if none
+bool NearestVegasGrid(const CubaGridKey& key, int ndim, VegasGrid& grid, CubaGridKey& from);
+// Grid stored with exactly this key, false if none
+bool PersistentVegasGrid(const CubaGridKey& key, int ndim, VegasGrid& grid);
+void StoreVegasGrid(const CubaGridKey& key, const VegasGrid& grid);
+// The grids stored since the last call seed the integrations from now on
+void NextVegasGridGeneration();
+// Drops the persistent grids
+void ResetPersistentVegasGrids();
+
+#endif